@@ -342,4 +342,10 @@ namespace DirectX
     void D3DXEncodeBC6HS(_Out_writes_(16) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ uint32_t flags) noexcept;
     void D3DXEncodeBC7(_Out_writes_(16) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ uint32_t flags) noexcept;
 
+    bool D3DXRemapBC6H(_Out_writes_(16) uint8_t *pBC, _In_reads_(16) const uint8_t *pSrc, _In_reads_(NUM_PIXELS_PER_BLOCK) const uint8_t *pRemap) noexcept;
+    bool D3DXRemapBC7(_Out_writes_(16) uint8_t *pBC, _In_reads_(16) const uint8_t *pSrc, _In_reads_(NUM_PIXELS_PER_BLOCK) const uint8_t *pRemap) noexcept;
+        // Texel i of the new block is texel pRemap[i] of the source, without re-encoding.
+        // Multi-subset modes need a partition shape that matches the rearranged subsets (renumbering them is fine).
+        // Returns false when there is none, or when a BC6H delta no longer fits once the base endpoint changes.
+
 } // namespace
@@ -668,6 +668,7 @@ namespace
     public:
         void Decode(_In_ bool bSigned, _Out_writes_(NUM_PIXELS_PER_BLOCK) HDRColorA* pOut) const noexcept;
         void Encode(_In_ bool bSigned, _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA* const pIn) noexcept;
+        bool Remap(_In_reads_(NUM_PIXELS_PER_BLOCK) const uint8_t* pRemap) noexcept;
 
     private:
     #pragma warning(push)
@@ -775,6 +776,7 @@ namespace
     public:
         void Decode(_Out_writes_(NUM_PIXELS_PER_BLOCK) HDRColorA* pOut) const noexcept;
         void Encode(uint32_t flags, _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA* const pIn) noexcept;
+        bool Remap(_In_reads_(NUM_PIXELS_PER_BLOCK) const uint8_t* pRemap) noexcept;
 
     private:
         struct ModeInfo
@@ -1143,6 +1145,59 @@ namespace
         return false;
     }
 
+    // Finds the shape that splits the block into the same subsets once texel i is taken from
+    // texel pRemap[i]; the subsets may be numbered differently, so aSubset receives the new
+    // number of each source subset
+    bool FindRemappedShape(
+        _In_range_(1, 2) size_t uPartitions,
+        _In_range_(1, 64) size_t uNumShapes,
+        _In_range_(0, 63) size_t uShape,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const uint8_t* pRemap,
+        _Out_ size_t& uNewShape,
+        _Out_writes_(3) uint8_t* aSubset) noexcept
+    {
+        assert(uPartitions > 0 && uPartitions < 3 && uNumShapes <= 64 && uShape < uNumShapes);
+        _Analysis_assume_(uPartitions > 0 && uPartitions < 3 && uNumShapes <= 64 && uShape < uNumShapes);
+
+        const uint8_t* aSrcTable = g_aPartitionTable[uPartitions][uShape];
+        for (size_t s = 0; s < uNumShapes; ++s)
+        {
+            const uint8_t* aTable = g_aPartitionTable[uPartitions][s];
+
+            uint8_t aMap[3] = { UINT8_MAX, UINT8_MAX, UINT8_MAX };
+            uint32_t uUsed = 0;
+            size_t i = 0;
+            for (; i < NUM_PIXELS_PER_BLOCK; ++i)
+            {
+                const uint8_t uFrom = aSrcTable[pRemap[i]];
+                const uint8_t uTo = aTable[i];
+                if (aMap[uFrom] == UINT8_MAX)
+                {
+                    if (uUsed & (1u << uTo))
+                        break;
+
+                    aMap[uFrom] = uTo;
+                    uUsed |= 1u << uTo;
+                }
+                else if (aMap[uFrom] != uTo)
+                {
+                    break;
+                }
+            }
+
+            if (i == NUM_PIXELS_PER_BLOCK && uUsed == (1u << (uPartitions + 1)) - 1u)
+            {
+                uNewShape = s;
+                aSubset[0] = aMap[0];
+                aSubset[1] = aMap[1];
+                aSubset[2] = aMap[2];
+                return true;
+            }
+        }
+
+        return false;
+    }
+
     inline void TransformForward(_Inout_updates_all_(BC6H_MAX_REGIONS) INTEndPntPair aEndPts[]) noexcept
     {
         aEndPts[0].B -= aEndPts[0].A;
@@ -1813,6 +1868,184 @@ void D3DX_BC6H::Decode(bool bSigned, HDRColorA* pOut) const noexcept
 }
 
 
+_Use_decl_annotations_
+bool D3DX_BC6H::Remap(const uint8_t* pRemap) noexcept
+{
+    assert(pRemap);
+
+    size_t uStartBit = 0;
+    uint8_t uMode = GetBits(uStartBit, 2u);
+    if (uMode != 0x00 && uMode != 0x01)
+    {
+        uMode = static_cast<uint8_t>((unsigned(GetBits(uStartBit, 3)) << 2) | uMode);
+    }
+
+    assert(uMode < c_NumModeInfo);
+    _Analysis_assume_(uMode < c_NumModeInfo);
+
+    if (ms_aModeToInfo[uMode] < 0)
+        return false;
+
+    const ModeDescriptor* desc = ms_aDesc[ms_aModeToInfo[uMode]];
+    const ModeInfo& info = ms_aInfo[ms_aModeToInfo[uMode]];
+    const uint8_t uPartitions = info.uPartitions;
+    assert(uPartitions < BC6H_MAX_REGIONS);
+    _Analysis_assume_(uPartitions < BC6H_MAX_REGIONS);
+
+    INTEndPntPair aEndPts[BC6H_MAX_REGIONS] = {};
+    uint32_t uShape = 0;
+
+    const size_t uHeaderBits = uPartitions > 0 ? 82u : 65u;
+    while (uStartBit < uHeaderBits)
+    {
+        const size_t uCurBit = uStartBit;
+        if (GetBit(uStartBit))
+        {
+            switch (desc[uCurBit].m_eField)
+            {
+            case D:  uShape |= 1 << uint32_t(desc[uCurBit].m_uBit); break;
+            case RW: aEndPts[0].A.r |= 1 << uint32_t(desc[uCurBit].m_uBit); break;
+            case RX: aEndPts[0].B.r |= 1 << uint32_t(desc[uCurBit].m_uBit); break;
+            case RY: aEndPts[1].A.r |= 1 << uint32_t(desc[uCurBit].m_uBit); break;
+            case RZ: aEndPts[1].B.r |= 1 << uint32_t(desc[uCurBit].m_uBit); break;
+            case GW: aEndPts[0].A.g |= 1 << uint32_t(desc[uCurBit].m_uBit); break;
+            case GX: aEndPts[0].B.g |= 1 << uint32_t(desc[uCurBit].m_uBit); break;
+            case GY: aEndPts[1].A.g |= 1 << uint32_t(desc[uCurBit].m_uBit); break;
+            case GZ: aEndPts[1].B.g |= 1 << uint32_t(desc[uCurBit].m_uBit); break;
+            case BW: aEndPts[0].A.b |= 1 << uint32_t(desc[uCurBit].m_uBit); break;
+            case BX: aEndPts[0].B.b |= 1 << uint32_t(desc[uCurBit].m_uBit); break;
+            case BY: aEndPts[1].A.b |= 1 << uint32_t(desc[uCurBit].m_uBit); break;
+            case BZ: aEndPts[1].B.b |= 1 << uint32_t(desc[uCurBit].m_uBit); break;
+            default: return false;
+            }
+        }
+    }
+
+    if (uShape >= BC6H_MAX_SHAPES)
+        return false;
+
+    uint8_t aSrcIndices[NUM_PIXELS_PER_BLOCK];
+    for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+    {
+        aSrcIndices[i] = GetBits(uStartBit, IsFixUpOffset(uPartitions, uShape, i) ? info.uIndexPrec - 1u : info.uIndexPrec);
+    }
+
+    // Multi-region modes need a shape that splits the rearranged texels the same way
+    size_t uNewShape = uShape;
+    uint8_t aSubset[3] = { 0, 1, 2 };
+    if (uPartitions > 0 && !FindRemappedShape(uPartitions, BC6H_MAX_SHAPES, uShape, pRemap, uNewShape, aSubset))
+        return false;
+
+    // Deltas are relative to the first endpoint of region 0, which may now belong to another
+    // region or be swapped, so work with the absolute (wrapped) endpoints
+    const LDRColorA& Prec = info.RGBAPrec[0][0];
+    const INTColor WrapMask((1 << Prec.r) - 1, (1 << Prec.g) - 1, (1 << Prec.b) - 1);
+    if (info.bTransformed)
+    {
+        for (size_t p = 0; p <= uPartitions; ++p)
+        {
+            if (p != 0)
+            {
+                aEndPts[p].A.SignExtend(info.RGBAPrec[p][0]);
+                aEndPts[p].A += aEndPts[0].A;
+                aEndPts[p].A &= WrapMask;
+            }
+            aEndPts[p].B.SignExtend(info.RGBAPrec[p][1]);
+            aEndPts[p].B += aEndPts[0].A;
+            aEndPts[p].B &= WrapMask;
+        }
+    }
+
+    INTEndPntPair aNewEndPts[BC6H_MAX_REGIONS] = {};
+    for (size_t p = 0; p <= uPartitions; ++p)
+    {
+        aNewEndPts[aSubset[p]] = aEndPts[p];
+    }
+
+    uint8_t aIndices[NUM_PIXELS_PER_BLOCK];
+    for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+    {
+        aIndices[i] = aSrcIndices[pRemap[i]];
+    }
+
+    // The anchor texel of each region stores no MSB, so if the new anchor needs one, swap that
+    // region's endpoints and mirror its indices; the weights are symmetric, so texels decode the same
+    const uint8_t uMaxIndex = uint8_t((1u << info.uIndexPrec) - 1u);
+    for (size_t p = 0; p <= uPartitions; ++p)
+    {
+        if (aIndices[g_aFixUp[uPartitions][uNewShape][p]] <= (uMaxIndex >> 1))
+            continue;
+
+        std::swap(aNewEndPts[p].A, aNewEndPts[p].B);
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            if (g_aPartitionTable[uPartitions][uNewShape][i] == p)
+            {
+                aIndices[i] = uint8_t(uMaxIndex - aIndices[i]);
+            }
+        }
+    }
+
+    if (info.bTransformed)
+    {
+        // Re-derive the deltas from the new base endpoint; a delta that no longer fits its bits
+        // (e.g. the most negative one, which has no positive counterpart) can't be stored
+        for (size_t p = 0; p <= uPartitions; ++p)
+        {
+            for (size_t e = (p == 0) ? 1 : 0; e < 2; ++e)
+            {
+                INTColor& c = e ? aNewEndPts[p].B : aNewEndPts[p].A;
+                const LDRColorA& DeltaPrec = info.RGBAPrec[p][e];
+                for (uint8_t ch = 0; ch < BC6H_NUM_CHANNELS; ++ch)
+                {
+                    int delta = (c[ch] - aNewEndPts[0].A[ch]) & ((1 << Prec[ch]) - 1);
+                    if (delta & (1 << (Prec[ch] - 1)))
+                    {
+                        delta -= 1 << Prec[ch];
+                    }
+
+                    if (delta < -(1 << (DeltaPrec[ch] - 1)) || delta >= (1 << (DeltaPrec[ch] - 1)))
+                        return false;
+
+                    c[ch] = delta & ((1 << DeltaPrec[ch]) - 1);
+                }
+            }
+        }
+    }
+
+    uStartBit = 0;
+    while (uStartBit < uHeaderBits)
+    {
+        const size_t uBit = desc[uStartBit].m_uBit;
+        switch (desc[uStartBit].m_eField)
+        {
+        case D:  SetBit(uStartBit, uint8_t(uNewShape >> uBit) & 0x01u); break;
+        case RW: SetBit(uStartBit, uint8_t(aNewEndPts[0].A.r >> uBit) & 0x01u); break;
+        case RX: SetBit(uStartBit, uint8_t(aNewEndPts[0].B.r >> uBit) & 0x01u); break;
+        case RY: SetBit(uStartBit, uint8_t(aNewEndPts[1].A.r >> uBit) & 0x01u); break;
+        case RZ: SetBit(uStartBit, uint8_t(aNewEndPts[1].B.r >> uBit) & 0x01u); break;
+        case GW: SetBit(uStartBit, uint8_t(aNewEndPts[0].A.g >> uBit) & 0x01u); break;
+        case GX: SetBit(uStartBit, uint8_t(aNewEndPts[0].B.g >> uBit) & 0x01u); break;
+        case GY: SetBit(uStartBit, uint8_t(aNewEndPts[1].A.g >> uBit) & 0x01u); break;
+        case GZ: SetBit(uStartBit, uint8_t(aNewEndPts[1].B.g >> uBit) & 0x01u); break;
+        case BW: SetBit(uStartBit, uint8_t(aNewEndPts[0].A.b >> uBit) & 0x01u); break;
+        case BX: SetBit(uStartBit, uint8_t(aNewEndPts[0].B.b >> uBit) & 0x01u); break;
+        case BY: SetBit(uStartBit, uint8_t(aNewEndPts[1].A.b >> uBit) & 0x01u); break;
+        case BZ: SetBit(uStartBit, uint8_t(aNewEndPts[1].B.b >> uBit) & 0x01u); break;
+        default: ++uStartBit; break;
+        }
+    }
+
+    for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+    {
+        SetBits(uStartBit, IsFixUpOffset(uPartitions, uNewShape, i) ? info.uIndexPrec - 1u : info.uIndexPrec, aIndices[i]);
+    }
+    assert(uStartBit == 128);
+
+    return true;
+}
+
+
 _Use_decl_annotations_
 void D3DX_BC6H::Encode(bool bSigned, const HDRColorA* const pIn) noexcept
 {
@@ -2779,6 +3012,176 @@ void D3DX_BC7::Decode(HDRColorA* pOut) const noexcept
     }
 }
 
+_Use_decl_annotations_
+bool D3DX_BC7::Remap(const uint8_t* pRemap) noexcept
+{
+    assert(pRemap);
+
+    size_t uFirst = 0;
+    while (uFirst < 128 && !GetBit(uFirst)) {}
+    const uint8_t uMode = uint8_t(uFirst - 1);
+
+    if (uMode >= 8)
+        return false;
+
+    const ModeInfo& info = ms_aInfo[uMode];
+    const uint8_t uPartitions = info.uPartitions;
+    assert(uPartitions < BC7_MAX_REGIONS);
+    _Analysis_assume_(uPartitions < BC7_MAX_REGIONS);
+
+    const size_t uNumEndPts = (size_t(uPartitions) + 1u) << 1;
+    const uint8_t uIndexPrec = info.uIndexPrec;
+    const uint8_t uIndexPrec2 = info.uIndexPrec2;
+
+    size_t uStartBit = size_t(uMode) + 1;
+    const size_t uShapeStart = uStartBit;
+    const uint8_t uShape = GetBits(uStartBit, info.uPartitionBits);
+    uStartBit += info.uRotationBits;
+    const uint8_t uIndexMode = GetBits(uStartBit, info.uIndexModeBits);
+
+    // Endpoints are stored channel by channel, then the P-bits, each either unique to an
+    // endpoint or shared by both endpoints of a subset
+    const size_t uEndPtStart = uStartBit;
+    LDRColorA c[BC7_MAX_REGIONS << 1];
+    for (uint8_t ch = 0; ch < BC7_NUM_CHANNELS; ++ch)
+    {
+        for (size_t i = 0; i < uNumEndPts; ++i)
+        {
+            c[i][ch] = GetBits(uStartBit, info.RGBAPrec[ch]);
+        }
+    }
+
+    uint8_t P[BC7_MAX_REGIONS << 1] = {};
+    for (size_t i = 0; i < info.uPBits; ++i)
+    {
+        P[i] = GetBit(uStartBit);
+    }
+
+    uint8_t aEndPtP[BC7_MAX_REGIONS << 1] = {};
+    if (info.uPBits)
+    {
+        for (size_t i = 0; i < uNumEndPts; ++i)
+        {
+            aEndPtP[i] = P[i * info.uPBits / uNumEndPts];
+        }
+    }
+
+    const size_t uIndexStart = uStartBit;
+    uint8_t w1[NUM_PIXELS_PER_BLOCK], w2[NUM_PIXELS_PER_BLOCK] = {};
+    for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+    {
+        w1[i] = GetBits(uStartBit, IsFixUpOffset(uPartitions, uShape, i) ? uIndexPrec - 1u : uIndexPrec);
+    }
+    if (uIndexPrec2)
+    {
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            w2[i] = GetBits(uStartBit, i ? uIndexPrec2 : uIndexPrec2 - 1u);
+        }
+    }
+
+    // Multi-subset modes need a shape that splits the rearranged texels the same way
+    size_t uNewShape = uShape;
+    uint8_t aSubset[3] = { 0, 1, 2 };
+    if (uPartitions > 0
+        && !FindRemappedShape(uPartitions, size_t(1) << info.uPartitionBits, uShape, pRemap, uNewShape, aSubset))
+        return false;
+
+    uint8_t n1[NUM_PIXELS_PER_BLOCK], n2[NUM_PIXELS_PER_BLOCK];
+    for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+    {
+        n1[i] = w1[pRemap[i]];
+        n2[i] = w2[pRemap[i]];
+    }
+
+    // The anchor texel of each subset stores no MSB, so if the new anchor needs one, swap the
+    // endpoints that index set interpolates and mirror its indices; the weights are symmetric
+    const auto FixAnchor = [](uint8_t* aIndices, uint8_t uPrec, size_t uAnchor, const uint8_t* aTable, size_t uSubset) noexcept -> bool
+    {
+        const uint8_t uMaxIndex = uint8_t((1u << uPrec) - 1u);
+        if (aIndices[uAnchor] <= (uMaxIndex >> 1))
+            return false;
+
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            if (aTable[i] == uSubset)
+            {
+                aIndices[i] = uint8_t(uMaxIndex - aIndices[i]);
+            }
+        }
+        return true;
+    };
+
+    const uint8_t* aNewTable = g_aPartitionTable[uPartitions][uNewShape];
+    bool bSwapColor[BC7_MAX_REGIONS] = {};
+    bool bSwapAlpha[BC7_MAX_REGIONS] = {};
+    for (size_t p = 0; p <= uPartitions; ++p)
+    {
+        const bool bSwap1 = FixAnchor(n1, uIndexPrec, g_aFixUp[uPartitions][uNewShape][p], aNewTable, p);
+        bSwapColor[p] = bSwapAlpha[p] = bSwap1;
+    }
+
+    if (uIndexPrec2)
+    {
+        // Only single-subset modes have a second index set, so the one anchor is texel 0
+        const bool bSwap2 = FixAnchor(n2, uIndexPrec2, 0, aNewTable, 0);
+        bSwapColor[0] = uIndexMode ? bSwap2 : bSwapColor[0];
+        bSwapAlpha[0] = uIndexMode ? bSwapAlpha[0] : bSwap2;
+    }
+
+    uStartBit = uShapeStart;
+    SetBits(uStartBit, info.uPartitionBits, uint8_t(uNewShape));
+
+    // Subset p of the new block is source subset aSource[p]
+    size_t aSource[BC7_MAX_REGIONS] = {};
+    for (size_t p = 0; p <= uPartitions; ++p)
+    {
+        aSource[aSubset[p]] = p;
+    }
+
+    uStartBit = uEndPtStart;
+    for (uint8_t ch = 0; ch < BC7_NUM_CHANNELS; ++ch)
+    {
+        for (size_t p = 0; p <= uPartitions; ++p)
+        {
+            const size_t uSrc = aSource[p] << 1;
+            const bool bSwap = (ch < 3) ? bSwapColor[p] : bSwapAlpha[p];
+            SetBits(uStartBit, info.RGBAPrec[ch], c[uSrc + (bSwap ? 1 : 0)][ch]);
+            SetBits(uStartBit, info.RGBAPrec[ch], c[uSrc + (bSwap ? 0 : 1)][ch]);
+        }
+    }
+
+    // P-bits only occur in modes with one index set, which covers every channel
+    for (size_t p = 0; p <= uPartitions; ++p)
+    {
+        const size_t uSrc = aSource[p] << 1;
+        const size_t uDest = p << 1;
+        P[uDest * info.uPBits / uNumEndPts] = aEndPtP[uSrc + (bSwapColor[p] ? 1 : 0)];
+        P[(uDest + 1) * info.uPBits / uNumEndPts] = aEndPtP[uSrc + (bSwapColor[p] ? 0 : 1)];
+    }
+    for (size_t i = 0; i < info.uPBits; ++i)
+    {
+        SetBit(uStartBit, P[i]);
+    }
+    assert(uStartBit == uIndexStart);
+
+    for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+    {
+        SetBits(uStartBit, IsFixUpOffset(uPartitions, uNewShape, i) ? uIndexPrec - 1u : uIndexPrec, n1[i]);
+    }
+    if (uIndexPrec2)
+    {
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            SetBits(uStartBit, i ? uIndexPrec2 : uIndexPrec2 - 1u, n2[i]);
+        }
+    }
+    assert(uStartBit == 128);
+
+    return true;
+}
+
+
 _Use_decl_annotations_
 void D3DX_BC7::Encode(uint32_t flags, const HDRColorA* const pIn) noexcept
 {
@@ -3650,6 +4053,30 @@ void DirectX::D3DXDecodeBC7(XMVECTOR *pColor, const uint8_t *pBC) noexcept
     reinterpret_cast<const D3DX_BC7*>(pBC)->Decode(reinterpret_cast<HDRColorA*>(pColor));
 }
 
+_Use_decl_annotations_
+bool DirectX::D3DXRemapBC6H(uint8_t *pBC, const uint8_t *pSrc, const uint8_t *pRemap) noexcept
+{
+    assert(pBC && pSrc && pRemap);
+    D3DX_BC6H block;
+    memcpy(&block, pSrc, sizeof(block));
+    if (!block.Remap(pRemap))
+        return false;
+    memcpy(pBC, &block, sizeof(block));
+    return true;
+}
+
+_Use_decl_annotations_
+bool DirectX::D3DXRemapBC7(uint8_t *pBC, const uint8_t *pSrc, const uint8_t *pRemap) noexcept
+{
+    assert(pBC && pSrc && pRemap);
+    D3DX_BC7 block;
+    memcpy(&block, pSrc, sizeof(block));
+    if (!block.Remap(pRemap))
+        return false;
+    memcpy(pBC, &block, sizeof(block));
+    return true;
+}
+
 _Use_decl_annotations_
 void DirectX::D3DXEncodeBC7(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
 {
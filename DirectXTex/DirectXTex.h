@@ -14,6 +14,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <new>
 #include <utility>
 #include <vector>
 
@@ -720,6 +721,17 @@ namespace DirectX
     //---------------------------------------------------------------------------------
     // Texture conversion, resizing, mipmap generation, and block compression
 
+    struct DIRECTX_TEX_API Rect
+    {
+        size_t x;
+        size_t y;
+        size_t w;
+        size_t h;
+
+        Rect() = default;
+        Rect(size_t _x, size_t _y, size_t _w, size_t _h) noexcept : x(_x), y(_y), w(_w), h(_h) {}
+    };
+
     enum TEX_FR_FLAGS : uint32_t
     {
         TEX_FR_ROTATE0 = 0,
@@ -728,15 +740,23 @@ namespace DirectX
         TEX_FR_ROTATE270 = 0x3,
         TEX_FR_FLIP_HORIZONTAL = 0x08,
         TEX_FR_FLIP_VERTICAL = 0x10,
+
+        TEX_FR_ALLOW_REENCODE = 0x100,
+        // Block-compressed blocks (or images) that cannot be remapped exactly are decoded, flipped/rotated, and re-encoded (lossy)
+
+        TEX_FR_PARALLEL = 0x200,
+        // Flips/rotates the images of a complex texture using multiple threads when WIC is not used (requires OpenMP)
     };
 
-#ifdef _WIN32
     DIRECTX_TEX_API HRESULT __cdecl FlipRotate(_In_ const Image& srcImage, _In_ TEX_FR_FLAGS flags, _Out_ ScratchImage& image) noexcept;
     DIRECTX_TEX_API HRESULT __cdecl FlipRotate(
         _In_reads_(nimages) const Image* srcImages, _In_ size_t nimages, _In_ const TexMetadata& metadata,
         _In_ TEX_FR_FLAGS flags, _Out_ ScratchImage& result) noexcept;
         // Flip and/or rotate image
-#endif
+        // Block-compressed images are remapped by block without decompressing when each dimension is a multiple of 4 (or <= 4);
+        // with TEX_FR_ALLOW_REENCODE, BC6H/BC7 blocks whose partition has no flipped/rotated counterpart (or whose BC6H deltas
+        // no longer fit) are re-encoded one at a time, and other images are re-encoded whole. Without it those cases fail with
+        // HRESULT_E_NOT_SUPPORTED; typeless formats are always rejected when re-encoding would be needed
 
     enum TEX_FILTER_FLAGS : uint32_t
     {
@@ -790,6 +810,9 @@ namespace DirectX
 
         TEX_FILTER_FORCE_WIC = 0x20000000,
         // Forces use of the WIC path even when logic would have picked a non-WIC path when both are an option
+
+        TEX_FILTER_PARALLEL = 0x40000000,
+        // Resize or generate mipmaps using multiple threads when the non-WIC path is used (requires OpenMP)
     };
 
     constexpr uint32_t TEX_FILTER_DITHER_MASK = 0xF0000;
@@ -832,6 +855,56 @@ namespace DirectX
         _In_ std::function<bool __cdecl(size_t, size_t)> statusCallBack = nullptr);
         // Convert the image to a new format
 
+    class DIRECTX_TEX_API ConvertPlan
+    {
+    public:
+        ConvertPlan() noexcept
+            : m_srcFormat(DXGI_FORMAT_UNKNOWN), m_destFormat(DXGI_FORMAT_UNKNOWN), m_options{},
+            m_usewic(false), m_pfGUID{}, m_targetGUID{}, m_scanline(nullptr), m_scanlineCount(0)
+        {}
+        ConvertPlan(ConvertPlan&& moveFrom) noexcept
+            : m_srcFormat(DXGI_FORMAT_UNKNOWN), m_destFormat(DXGI_FORMAT_UNKNOWN), m_options{},
+            m_usewic(false), m_pfGUID{}, m_targetGUID{}, m_scanline(nullptr), m_scanlineCount(0)
+        {
+            *this = std::move(moveFrom);
+        }
+        ~ConvertPlan() { Release(); }
+
+        ConvertPlan& __cdecl operator= (ConvertPlan&& moveFrom) noexcept;
+
+        ConvertPlan(const ConvertPlan&) = delete;
+        ConvertPlan& operator=(const ConvertPlan&) = delete;
+
+        HRESULT __cdecl Initialize(_In_ DXGI_FORMAT srcFormat, _In_ DXGI_FORMAT destFormat, _In_ const ConvertOptions& options) noexcept;
+
+        void __cdecl Release() noexcept;
+
+        HRESULT __cdecl Execute(_In_ const Image& srcImage, _In_ const Image& destImage) noexcept;
+        HRESULT __cdecl Execute(_In_ const Image& srcImage, _Out_ ScratchImage& image) noexcept;
+            // Converts one image, reusing the plan's scanline buffer (not thread-safe)
+
+        HRESULT __cdecl ExecuteBatch(
+            _In_reads_(nimages) const Image* srcImages, _In_reads_(nimages) const Image* destImages, _In_ size_t nimages) const noexcept;
+            // Converts many independent images into caller-allocated destinations
+            // TEX_FILTER_PARALLEL in the plan's options converts them on multiple threads (requires OpenMP);
+            // conversions that go through WIC always run on the calling thread
+
+        DXGI_FORMAT __cdecl GetSourceFormat() const noexcept { return m_srcFormat; }
+        DXGI_FORMAT __cdecl GetDestinationFormat() const noexcept { return m_destFormat; }
+
+    private:
+        DXGI_FORMAT     m_srcFormat;
+        DXGI_FORMAT     m_destFormat;
+        ConvertOptions  m_options;
+        bool            m_usewic;
+        GUID            m_pfGUID;
+        GUID            m_targetGUID;
+        void*           m_scanline;
+        size_t          m_scanlineCount;
+    };
+        // Conversion plan for a fixed (source format, destination format, options) triple
+        // Validation and WIC vs. non-WIC path selection happen once in Initialize
+
     DIRECTX_TEX_API HRESULT __cdecl ConvertToSinglePlane(_In_ const Image& srcImage, _Out_ ScratchImage& image) noexcept;
     DIRECTX_TEX_API HRESULT __cdecl ConvertToSinglePlane(
         _In_reads_(nimages) const Image* srcImages, _In_ size_t nimages, _In_ const TexMetadata& metadata,
@@ -847,6 +920,19 @@ namespace DirectX
         // levels of '0' indicates a full mipchain, otherwise is generates that number of total levels (including the source base image)
         // Defaults to Fant filtering which is equivalent to a box filter
 
+    DIRECTX_TEX_API HRESULT __cdecl UpdateMipMaps(
+        _Inout_ ScratchImage& mipChain, _In_ size_t item, _In_ const Rect& dirtyRect, _In_ TEX_FILTER_FLAGS filter,
+        _Out_writes_opt_(nLevels) Rect* dirtyRects = nullptr, _In_ size_t nLevels = 0,
+        _In_ DXGI_FORMAT compressFormat = DXGI_FORMAT_UNKNOWN) noexcept;
+        // Recomputes the parts of a 1D/2D mip chain (array item 'item') that depend on 'dirtyRect' of level 0,
+        // matching GenerateMipMaps with the same filter on the custom (non-WIC) code path
+        // Returns E_INVALIDARG for filters GenerateMipMaps would run through WIC; use TEX_FILTER_FORCE_NON_WIC
+        // with both functions (or a filter WIC doesn't handle, such as TEX_FILTER_SRGB or TEX_FILTER_TRIANGLE)
+        // Reports the changed area of each level in dirtyRects; if compressFormat is a BC format, these are
+        // expanded to its 4x4 block grid for incremental recompression
+        // mipChain is updated in place: only the pixels of its existing levels are written, it is never
+        // reinitialized or reallocated, so Image pointers previously obtained from it remain valid
+
     DIRECTX_TEX_API HRESULT __cdecl GenerateMipMaps3D(
         _In_reads_(depth) const Image* baseImages, _In_ size_t depth, _In_ TEX_FILTER_FLAGS filter, _In_ size_t levels,
         _Out_ ScratchImage& mipChain) noexcept;
@@ -856,9 +942,20 @@ namespace DirectX
         // levels of '0' indicates a full mipchain, otherwise is generates that number of total levels (including the source base image)
         // Defaults to Fant filtering which is equivalent to a box filter
 
+    DIRECTX_TEX_API HRESULT __cdecl GenerateMipMaps3DStreamed(
+        _In_ const TexMetadata& metadata, _In_ TEX_FILTER_FLAGS filter, _In_ size_t levels,
+        _In_ std::function<HRESULT __cdecl(size_t slice, const Image& image)> loadSlice,
+        _In_ std::function<HRESULT __cdecl(size_t level, size_t slice, const Image& image)> storeSlice);
+        // Generates the mips of a volume described by metadata without holding it or its chain in memory
+        // loadSlice fills 'image' with base slice 'slice'; storeSlice receives each slice of levels 1 and up,
+        // in order within a level (e.g. to Compress it). Both are called on the calling thread, a slab at a time
+        // Supports point, box, linear, and cubic filtering (not cubic with TEX_FILTER_WRAP_V or _W)
+        // Defaults to box filtering for power-of-two sizes, otherwise linear
+
     DIRECTX_TEX_API HRESULT __cdecl ScaleMipMapsAlphaForCoverage(
         _In_reads_(nimages) const Image* srcImages, _In_ size_t nimages, _In_ const TexMetadata& metadata, _In_ size_t item,
-        _In_ float alphaReference, _Inout_ ScratchImage& mipChain) noexcept;
+        _In_ float alphaReference, _Inout_ ScratchImage& mipChain, _In_ TEX_FILTER_FLAGS filter = TEX_FILTER_DEFAULT) noexcept;
+        // Only TEX_FILTER_PARALLEL is used from filter, to process the levels on multiple threads (requires OpenMP)
 
 
     enum TEX_PMALPHA_FLAGS : uint32_t
@@ -871,6 +968,9 @@ namespace DirectX
         TEX_PMALPHA_REVERSE = 0x2,
         // converts from premultiplied alpha back to straight alpha
 
+        TEX_PMALPHA_PARALLEL = 0x10000000,
+        // converts bands of scanlines using multiple threads (requires OpenMP); by default it does not use multithreading
+
         TEX_PMALPHA_SRGB_IN = 0x1000000,
         TEX_PMALPHA_SRGB_OUT = 0x2000000,
         TEX_PMALPHA_SRGB = (TEX_PMALPHA_SRGB_IN | TEX_PMALPHA_SRGB_OUT),
@@ -992,6 +1092,9 @@ namespace DirectX
 
         CNMAP_COMPUTE_OCCLUSION = 0x8000,
         // Computes a crude occlusion term stored in the alpha channel
+
+        CNMAP_PARALLEL = 0x10000000,
+        // Computes bands of scanlines using multiple threads (requires OpenMP); by default it does not use multithreading
     };
 
     DIRECTX_TEX_API HRESULT __cdecl ComputeNormalMap(
@@ -1000,24 +1103,18 @@ namespace DirectX
     DIRECTX_TEX_API HRESULT __cdecl ComputeNormalMap(
         _In_reads_(nimages) const Image* srcImages, _In_ size_t nimages, _In_ const TexMetadata& metadata,
         _In_ CNMAP_FLAGS flags, _In_ float amplitude, _In_ DXGI_FORMAT format, _Out_ ScratchImage& normalMaps) noexcept;
+        // Generates a normal map from a height-map
+        // R8G8_UNORM/SNORM and R16G16_UNORM/SNORM targets receive only the normal's XY (e.g. for BC5)
 
     //---------------------------------------------------------------------------------
     // Misc image operations
 
-    struct DIRECTX_TEX_API Rect
-    {
-        size_t x;
-        size_t y;
-        size_t w;
-        size_t h;
-
-        Rect() = default;
-        Rect(size_t _x, size_t _y, size_t _w, size_t _h) noexcept : x(_x), y(_y), w(_w), h(_h) {}
-    };
-
     DIRECTX_TEX_API HRESULT __cdecl CopyRectangle(
         _In_ const Image& srcImage, _In_ const Rect& srcRect, _In_ const Image& dstImage,
         _In_ TEX_FILTER_FLAGS filter, _In_ size_t xOffset, _In_ size_t yOffset) noexcept;
+        // Block-compressed images must share a format; the rectangle and offset must then be 4x4 block aligned,
+        // except for partial blocks at the right or bottom edge of both images
+        // TEX_FILTER_PARALLEL converts large rectangles between formats using multiple threads (requires OpenMP)
 
     enum CMSE_FLAGS : uint32_t
     {
@@ -1040,23 +1137,101 @@ namespace DirectX
 
     DIRECTX_TEX_API HRESULT __cdecl ComputeMSE(_In_ const Image& image1, _In_ const Image& image2, _Out_ float& mse, _Out_writes_opt_(4) float* mseV, _In_ CMSE_FLAGS flags = CMSE_DEFAULT) noexcept;
 
+    enum CMETRICS_FLAGS : uint32_t
+    {
+        CMETRICS_MSE = 0x1,
+        // Mean-squared error and PSNR
+
+        CMETRICS_SSIM = 0x2,
+        // Structural similarity over 8x8 blocks
+
+        CMETRICS_MAX_ERROR = 0x4,
+        // Largest absolute per-channel error and its location
+
+        CMETRICS_ALL = 0x7,
+
+        CMETRICS_PARALLEL = 0x10000000,
+        // Measures bands of scanlines using multiple threads (requires OpenMP); by default it does not use multithreading
+    };
+
+    struct ImageMetrics
+    {
+        float   mse;            // Weighted sum of mseV
+        float   mseV[4];
+        float   psnr;           // Based on the weighted MSE; +INF if the images match
+        float   psnrV[4];
+        float   ssim;           // Weighted mean of ssimV
+        float   ssimV[4];
+        float   maxError;       // Largest weighted channel error
+        float   maxErrorV[4];
+        size_t  maxErrorX;
+        size_t  maxErrorY;
+    };
+
+    DIRECTX_TEX_API HRESULT __cdecl ComputeImageMetrics(
+        _In_ const Image& image1, _In_ const Image& image2, _In_ CMETRICS_FLAGS metrics, _Out_ ImageMetrics& result,
+        _In_ CMSE_FLAGS flags = CMSE_DEFAULT, _In_reads_opt_(4) const float* weights = nullptr) noexcept;
+        // Computes the requested metrics in a single pass; weights default to 1 for each channel
+        // Ignored channels (CMSE_IGNORE_*) report zero error and an SSIM of 1, and are given a weight of 0
+
+    enum TEX_PIXELFUNC_FLAGS : uint32_t
+    {
+        TEX_PIXELFUNC_DEFAULT = 0,
+
+        TEX_PIXELFUNC_PARALLEL = 0x1,
+        // pixelFunc is reentrant: bands of scanlines may be processed concurrently and in any order
+    };
+
     DIRECTX_TEX_API HRESULT __cdecl EvaluateImage(
         _In_ const Image& image,
-        _In_ std::function<void __cdecl(_In_reads_(width) const XMVECTOR* pixels, size_t width, size_t y)> pixelFunc);
+        _In_ std::function<void __cdecl(_In_reads_(width) const XMVECTOR* pixels, size_t width, size_t y)> pixelFunc,
+        _In_ TEX_PIXELFUNC_FLAGS flags = TEX_PIXELFUNC_DEFAULT);
     DIRECTX_TEX_API HRESULT __cdecl EvaluateImage(
         _In_reads_(nimages) const Image* images, _In_ size_t nimages, _In_ const TexMetadata& metadata,
-        _In_ std::function<void __cdecl(_In_reads_(width) const XMVECTOR* pixels, size_t width, size_t y)> pixelFunc);
+        _In_ std::function<void __cdecl(_In_reads_(width) const XMVECTOR* pixels, size_t width, size_t y)> pixelFunc,
+        _In_ TEX_PIXELFUNC_FLAGS flags = TEX_PIXELFUNC_DEFAULT);
+
+    DIRECTX_TEX_API HRESULT __cdecl EvaluateImage(
+        _In_ const Image& image,
+        _In_ std::function<void __cdecl(size_t slots)> initFunc,
+        _In_ std::function<void __cdecl(_In_reads_(width) const XMVECTOR* pixels, size_t width, size_t y, size_t slot)> pixelFunc);
+    DIRECTX_TEX_API HRESULT __cdecl EvaluateImage(
+        _In_reads_(nimages) const Image* images, _In_ size_t nimages, _In_ const TexMetadata& metadata,
+        _In_ std::function<void __cdecl(size_t slots)> initFunc,
+        _In_ std::function<void __cdecl(_In_reads_(width) const XMVECTOR* pixels, size_t width, size_t y, size_t slot)> pixelFunc);
+        // Evaluates bands of scanlines concurrently. initFunc is called once on the calling thread before any pixelFunc;
+        // each band of scanlines is its own slot (less than 'slots'), numbered in image then row order
+
+    template<typename T, typename TPixelFunc, typename TMergeFunc>
+    HRESULT __cdecl ReduceImage(_In_ const Image& image, _Inout_ T& result, _In_ TPixelFunc pixelFunc, _In_ TMergeFunc mergeFunc);
+    template<typename T, typename TPixelFunc, typename TMergeFunc>
+    HRESULT __cdecl ReduceImage(
+        _In_reads_(nimages) const Image* images, _In_ size_t nimages, _In_ const TexMetadata& metadata,
+        _Inout_ T& result, _In_ TPixelFunc pixelFunc, _In_ TMergeFunc mergeFunc);
+        // Parallel EvaluateImage with an accumulator per band, each starting as a copy of 'result'
+        // pixelFunc(pixels, width, y, T& accum) fills them in, then mergeFunc(result, accum) combines them in band order,
+        // so the result does not depend on thread scheduling
 
     DIRECTX_TEX_API HRESULT __cdecl TransformImage(
         _In_ const Image& image,
         _In_ std::function<void __cdecl(_Out_writes_(width) XMVECTOR* outPixels,
             _In_reads_(width) const XMVECTOR* inPixels, size_t width, size_t y)> pixelFunc,
-        ScratchImage& result);
+        ScratchImage& result, _In_ TEX_PIXELFUNC_FLAGS flags = TEX_PIXELFUNC_DEFAULT);
     DIRECTX_TEX_API HRESULT __cdecl TransformImage(
         _In_reads_(nimages) const Image* srcImages, _In_ size_t nimages, _In_ const TexMetadata& metadata,
         _In_ std::function<void __cdecl(_Out_writes_(width) XMVECTOR* outPixels,
             _In_reads_(width) const XMVECTOR* inPixels, size_t width, size_t y)> pixelFunc,
-        ScratchImage& result);
+        ScratchImage& result, _In_ TEX_PIXELFUNC_FLAGS flags = TEX_PIXELFUNC_DEFAULT);
+
+    //---------------------------------------------------------------------------------
+    // Scratch memory for temporary scanlines
+    DIRECTX_TEX_API HRESULT __cdecl SetThreadScratchMemory(_Inout_updates_bytes_opt_(size) void* pMemory, _In_ size_t size) noexcept;
+        // Provides 16-byte aligned memory for the temporary scanlines of operations run on the calling thread
+        // Pass nullptr to revert to library-allocated memory. The memory must stay valid until then.
+
+    DIRECTX_TEX_API void __cdecl ReleaseThreadScratchMemory() noexcept;
+        // Frees the library-allocated scratch memory and filter tables cached for the calling thread
+        // Work done inside OpenMP parallel regions retains at most 1 MB of each per thread
 
     //---------------------------------------------------------------------------------
     // WIC utility code
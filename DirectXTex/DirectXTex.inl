@@ -30,6 +30,8 @@ DEFINE_ENUM_FLAG_OPERATORS(TEX_PMALPHA_FLAGS);
 DEFINE_ENUM_FLAG_OPERATORS(TEX_COMPRESS_FLAGS);
 DEFINE_ENUM_FLAG_OPERATORS(CNMAP_FLAGS);
 DEFINE_ENUM_FLAG_OPERATORS(CMSE_FLAGS);
+DEFINE_ENUM_FLAG_OPERATORS(CMETRICS_FLAGS);
+DEFINE_ENUM_FLAG_OPERATORS(TEX_PIXELFUNC_FLAGS);
 DEFINE_ENUM_FLAG_OPERATORS(CREATETEX_FLAGS);
 
 #ifdef __clang__
@@ -202,6 +204,116 @@ inline HRESULT __cdecl SaveToTGAFile(const Image& image, const wchar_t* szFile,
 }
 
 
+//=====================================================================================
+// Image reduction
+//=====================================================================================
+
+namespace ReduceDetail
+{
+    // Per-band accumulators for ReduceImage; each starts on its own cache line so
+    // worker threads never write to a line shared with another band
+    template<typename T>
+    class BandAccumulators
+    {
+    public:
+        BandAccumulators() noexcept : m_base(nullptr), m_count(0) {}
+        ~BandAccumulators() { Clear(); }
+
+        BandAccumulators(const BandAccumulators&) = delete;
+        BandAccumulators& operator=(const BandAccumulators&) = delete;
+
+        void Assign(size_t count, const T& value)
+        {
+            static_assert(alignof(T) <= c_LineSize, "Accumulator alignment exceeds cache line size");
+
+            Clear();
+            m_storage.resize(count * Stride() + c_LineSize - 1);
+
+            auto addr = reinterpret_cast<uintptr_t>(m_storage.data());
+            m_base = reinterpret_cast<uint8_t*>((addr + c_LineSize - 1) & ~static_cast<uintptr_t>(c_LineSize - 1));
+
+            for (; m_count < count; ++m_count)
+            {
+                new (m_base + m_count * Stride()) T(value);
+            }
+        }
+
+        size_t size() const noexcept { return m_count; }
+        T& operator[](size_t index) noexcept { return *reinterpret_cast<T*>(m_base + index * Stride()); }
+
+    private:
+        static constexpr size_t c_LineSize = 64;
+
+        static constexpr size_t Stride() noexcept { return (sizeof(T) + c_LineSize - 1) & ~(c_LineSize - 1); }
+
+        void Clear() noexcept
+        {
+            while (m_count > 0)
+            {
+                --m_count;
+                (*this)[m_count].~T();
+            }
+        }
+
+        std::vector<uint8_t> m_storage;
+        uint8_t* m_base;
+        size_t m_count;
+    };
+}
+
+template<typename T, typename TPixelFunc, typename TMergeFunc>
+_Use_decl_annotations_
+inline HRESULT __cdecl ReduceImage(const Image& image, T& result, TPixelFunc pixelFunc, TMergeFunc mergeFunc)
+{
+    ReduceDetail::BandAccumulators<T> partials;
+    HRESULT hr = EvaluateImage(image,
+        [&](size_t slots)
+        {
+            partials.Assign(slots, result);
+        },
+        [&](const XMVECTOR* pixels, size_t width, size_t y, size_t slot)
+        {
+            pixelFunc(pixels, width, y, partials[slot]);
+        });
+    if (FAILED(hr))
+        return hr;
+
+    for (size_t band = 0; band < partials.size(); ++band)
+    {
+        mergeFunc(result, partials[band]);
+    }
+
+    return S_OK;
+}
+
+template<typename T, typename TPixelFunc, typename TMergeFunc>
+_Use_decl_annotations_
+inline HRESULT __cdecl ReduceImage(
+    const Image* images, size_t nimages, const TexMetadata& metadata,
+    T& result, TPixelFunc pixelFunc, TMergeFunc mergeFunc)
+{
+    ReduceDetail::BandAccumulators<T> partials;
+    HRESULT hr = EvaluateImage(images, nimages, metadata,
+        [&](size_t slots)
+        {
+            partials.Assign(slots, result);
+        },
+        [&](const XMVECTOR* pixels, size_t width, size_t y, size_t slot)
+        {
+            pixelFunc(pixels, width, y, partials[slot]);
+        });
+    if (FAILED(hr))
+        return hr;
+
+    for (size_t band = 0; band < partials.size(); ++band)
+    {
+        mergeFunc(result, partials[band]);
+    }
+
+    return S_OK;
+}
+
+
 //=====================================================================================
 // C++17 helpers
 //=====================================================================================
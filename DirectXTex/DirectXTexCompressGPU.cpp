@@ -60,7 +60,7 @@ namespace
             return E_POINTER;
         }
 
-        auto scanline = make_AlignedArrayXMVECTOR(srcImage.width);
+        auto scanline = make_ScratchArrayXMVECTOR(srcImage.width);
         if (!scanline)
         {
             image.Release();
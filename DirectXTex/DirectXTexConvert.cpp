@@ -11,6 +11,11 @@
 
 #include "DirectXTexP.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#pragma warning(disable : 4616 6993)
+#endif
+
 using namespace DirectX;
 using namespace DirectX::Internal;
 using namespace DirectX::PackedVector;
@@ -152,6 +157,266 @@ namespace
         return reinterpret_cast<const float*>(&Result)[0];
     }
 
+#if defined(_XM_SSE_INTRINSICS_) && !defined(_XM_NO_INTRINSICS_)
+    //---------------------------------------------------------------------------------
+    // SSE2 packed-float encoders and decoders
+    //
+    // These produce bit-identical results to FloatTo7e3/FloatTo6e4, FloatFrom7e3/FloatFrom6e4,
+    // and the DirectXMath XMStoreFloat3SE/XMLoadFloat3SE & XMStoreFloat3PK/XMLoadFloat3PK
+    // functions, but operate on all three color channels at once.
+    //---------------------------------------------------------------------------------
+    inline __m128i SelectInt(__m128i mask, __m128i a, __m128i b) noexcept
+    {
+        // mask ? a : b
+        return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+    }
+
+    // Vector form of FloatTo7e3 (maxValue = 0x41FF73FF, minNormal = 0x3E800000, 2^25, 0xC2000000, 16)
+    // and FloatTo6e4 (maxValue = 0x43FEFFFF, minNormal = 0x3C800000, 2^29, 0xC4000000, 17).
+    template<uint32_t maxValue, uint32_t minNormal, uint32_t rebias, int shift>
+    inline __m128i XM_CALLCONV FloatToFloat10(__m128 V, __m128 denormScale) noexcept
+    {
+        const __m128i ivalue = _mm_castps_si128(V);
+
+        // Positive only
+        const __m128i negative = _mm_srai_epi32(ivalue, 31);
+
+        // Too large (or NaN) saturates
+        const __m128i large = _mm_cmpgt_epi32(ivalue, _mm_set1_epi32(static_cast<int>(maxValue)));
+
+        // For denormalized results, (0x800000 | mantissa) >> (bias - exponent) is exactly trunc(value * 2^k)
+        const __m128i denorm = _mm_cmplt_epi32(ivalue, _mm_set1_epi32(static_cast<int>(minNormal)));
+        const __m128i dvalue = _mm_cvttps_epi32(_mm_mul_ps(V, denormScale));
+        const __m128i nvalue = _mm_add_epi32(ivalue, _mm_set1_epi32(static_cast<int>(rebias)));
+        __m128i t = SelectInt(denorm, dvalue, nvalue);
+
+        // Round to nearest even
+        const __m128i odd = _mm_and_si128(_mm_srli_epi32(t, shift), _mm_set1_epi32(1));
+        t = _mm_add_epi32(t, _mm_add_epi32(odd, _mm_set1_epi32((1 << (shift - 1)) - 1)));
+        t = _mm_and_si128(_mm_srli_epi32(t, shift), _mm_set1_epi32(0x3FF));
+
+        t = SelectInt(large, _mm_set1_epi32(0x3FF), t);
+        return _mm_andnot_si128(negative, t);
+    }
+
+    // Vector form of FloatFrom7e3 (2^-25, 124, 16) and FloatFrom6e4 (2^-29, 120, 17)
+    template<uint32_t bias, int shift>
+    inline __m128 XM_CALLCONV Float10ToFloat(__m128i v, __m128 denormScale) noexcept
+    {
+        const __m128i t = _mm_slli_epi32(v, shift);
+        const __m128i denorm = _mm_cmpeq_epi32(_mm_and_si128(t, _mm_set1_epi32(0x7F800000)), _mm_setzero_si128());
+        const __m128 nvalue = _mm_castsi128_ps(_mm_add_epi32(t, _mm_set1_epi32(static_cast<int>(bias << 23))));
+        const __m128 dvalue = _mm_mul_ps(_mm_cvtepi32_ps(t), denormScale);
+        return XMVectorSelect(nvalue, dvalue, _mm_castsi128_ps(denorm));
+    }
+
+    inline uint32_t XM_CALLCONV EncodeFloat7e3A2(FXMVECTOR V) noexcept
+    {
+        // Expects V scaled and clamped to [0, 31.875] for RGB and [0, 3] for alpha
+        static const XMVECTORF32 s_denormScale = { { { 33554432.f /* 2^25 */, 33554432.f, 33554432.f, 33554432.f } } };
+        const __m128i rgb = FloatToFloat10<0x41FF73FFU, 0x3E800000U, 0xC2000000U, 16>(V, s_denormScale);
+
+        XM_ALIGNED_DATA(16) uint32_t tmp[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(tmp), rgb);
+        const auto a = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_cvttps_epi32(XMVectorSplatW(V))));
+        return tmp[0] | (tmp[1] << 10) | (tmp[2] << 20) | ((a & 0x3) << 30);
+    }
+
+    inline uint32_t XM_CALLCONV EncodeFloat6e4A2(FXMVECTOR V) noexcept
+    {
+        // Expects V scaled and clamped to [0, 508] for RGB and [0, 3] for alpha
+        static const XMVECTORF32 s_denormScale = { { { 536870912.f /* 2^29 */, 536870912.f, 536870912.f, 536870912.f } } };
+        const __m128i rgb = FloatToFloat10<0x43FEFFFFU, 0x3C800000U, 0xC4000000U, 17>(V, s_denormScale);
+
+        XM_ALIGNED_DATA(16) uint32_t tmp[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(tmp), rgb);
+        const auto a = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_cvttps_epi32(XMVectorSplatW(V))));
+        return tmp[0] | (tmp[1] << 10) | (tmp[2] << 20) | ((a & 0x3) << 30);
+    }
+
+    inline XMVECTOR XM_CALLCONV DecodeFloat7e3A2(uint32_t v) noexcept
+    {
+        static const XMVECTORF32 s_denormScale = { { { 1.f / 33554432.f, 1.f / 33554432.f, 1.f / 33554432.f, 1.f / 33554432.f } } };
+        const __m128i rgb = _mm_setr_epi32(static_cast<int>(v & 0x3FF), static_cast<int>((v >> 10) & 0x3FF), static_cast<int>((v >> 20) & 0x3FF), 0);
+        const XMVECTOR result = Float10ToFloat<124, 16>(rgb, s_denormScale);
+        return XMVectorSetW(result, static_cast<float>(v >> 30) / 3.0f);
+    }
+
+    inline XMVECTOR XM_CALLCONV DecodeFloat6e4A2(uint32_t v) noexcept
+    {
+        static const XMVECTORF32 s_denormScale = { { { 1.f / 536870912.f, 1.f / 536870912.f, 1.f / 536870912.f, 1.f / 536870912.f } } };
+        const __m128i rgb = _mm_setr_epi32(static_cast<int>(v & 0x3FF), static_cast<int>((v >> 10) & 0x3FF), static_cast<int>((v >> 20) & 0x3FF), 0);
+        const XMVECTOR result = Float10ToFloat<120, 17>(rgb, s_denormScale);
+        return XMVectorSetW(result, static_cast<float>(v >> 30) / 3.0f);
+    }
+
+    inline void XM_CALLCONV StoreFloat3SE(_Out_ XMFLOAT3SE* pDestination, FXMVECTOR V) noexcept
+    {
+        assert(pDestination);
+
+        static const XMVECTORF32 s_maxf9 = { { { float(0x1FF << 7), float(0x1FF << 7), float(0x1FF << 7), float(0x1FF << 7) } } };
+        constexpr float minf9 = float(1.f / (1 << 16));
+
+        // _mm_max_ps returns the second operand for NaN, matching the scalar '>= 0' test
+        const __m128 c = _mm_min_ps(_mm_max_ps(V, _mm_setzero_ps()), s_maxf9);
+
+        __m128 m = _mm_max_ps(c, XMVectorSplatY(c));
+        m = _mm_max_ps(m, XMVectorSplatZ(c));
+
+        const float max_xyz = _mm_cvtss_f32(m);
+        const float maxColor = (max_xyz > minf9) ? max_xyz : minf9;
+
+        union { float f; int32_t i; } fi;
+        fi.f = maxColor;
+        fi.i += 0x00004000; // round up leaving 9 bits in fraction (including assumed 1)
+
+        const auto exp = static_cast<uint32_t>(fi.i) >> 23;
+        pDestination->e = exp - 0x6f;
+
+        fi.i = static_cast<int32_t>(0x83000000 - (exp << 23));
+
+        // lroundf for non-negative values: truncate, then round half away from zero
+        const __m128 scaled = _mm_mul_ps(c, _mm_set1_ps(fi.f));
+        __m128i im = _mm_cvttps_epi32(scaled);
+        const __m128 frac = _mm_sub_ps(scaled, _mm_cvtepi32_ps(im));
+        im = _mm_sub_epi32(im, _mm_castps_si128(_mm_cmpge_ps(frac, g_XMOneHalf)));
+
+        XM_ALIGNED_DATA(16) uint32_t tmp[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(tmp), im);
+        pDestination->xm = tmp[0];
+        pDestination->ym = tmp[1];
+        pDestination->zm = tmp[2];
+    }
+
+    inline XMVECTOR XM_CALLCONV LoadFloat3SE(_In_ const XMFLOAT3SE* pSource) noexcept
+    {
+        assert(pSource);
+
+        union { float f; int32_t i; } fi;
+        fi.i = 0x33800000 + static_cast<int32_t>(pSource->e << 23);
+
+        const __m128i im = _mm_setr_epi32(static_cast<int>(pSource->xm), static_cast<int>(pSource->ym), static_cast<int>(pSource->zm), 0);
+        const XMVECTOR result = _mm_mul_ps(_mm_cvtepi32_ps(im), _mm_set1_ps(fi.f));
+        return XMVectorSelect(g_XMIdentityR3, result, g_XMSelect1110);
+    }
+
+    inline void XM_CALLCONV StoreFloat3PK(_Out_ XMFLOAT3PK* pDestination, FXMVECTOR V) noexcept
+    {
+        assert(pDestination);
+
+        const __m128i ivalue = _mm_castps_si128(V);
+
+        // Vector path covers +0 and finite values in the normalized float11/float10 range,
+        // everything else (negative, denormalized, INF, NaN) is handled by DirectXMath.
+        const __m128i zero = _mm_cmpeq_epi32(ivalue, _mm_setzero_si128());
+        const __m128i normal = _mm_and_si128(
+            _mm_cmpgt_epi32(ivalue, _mm_set1_epi32(0x387FFFFF)),
+            _mm_cmplt_epi32(ivalue, _mm_set1_epi32(0x7F800000)));
+        if ((_mm_movemask_ps(_mm_castsi128_ps(_mm_or_si128(zero, normal))) & 0x7) != 0x7)
+        {
+            XMStoreFloat3PK(pDestination, V);
+            return;
+        }
+
+        // Rebias the exponent to represent the value as a normalized float11/float10
+        const __m128i t = _mm_add_epi32(ivalue, _mm_set1_epi32(static_cast<int>(0xC8000000)));
+
+        // X & Y channels (5-bit exponent, 6-bit mantissa)
+        __m128i r11 = _mm_and_si128(_mm_srli_epi32(t, 17), _mm_set1_epi32(1));
+        r11 = _mm_add_epi32(t, _mm_add_epi32(r11, _mm_set1_epi32(0xFFFF)));
+        r11 = _mm_and_si128(_mm_srli_epi32(r11, 17), _mm_set1_epi32(0x7FF));
+        r11 = SelectInt(_mm_cmpgt_epi32(ivalue, _mm_set1_epi32(0x477E0000)), _mm_set1_epi32(0x7BF), r11);
+
+        // Z channel (5-bit exponent, 5-bit mantissa)
+        __m128i r10 = _mm_and_si128(_mm_srli_epi32(t, 18), _mm_set1_epi32(1));
+        r10 = _mm_add_epi32(t, _mm_add_epi32(r10, _mm_set1_epi32(0x1FFFF)));
+        r10 = _mm_and_si128(_mm_srli_epi32(r10, 18), _mm_set1_epi32(0x3FF));
+        r10 = SelectInt(_mm_cmpgt_epi32(ivalue, _mm_set1_epi32(0x477C0000)), _mm_set1_epi32(0x3DF), r10);
+
+        XM_ALIGNED_DATA(16) uint32_t xy[4];
+        XM_ALIGNED_DATA(16) uint32_t z[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(xy), _mm_andnot_si128(zero, r11));
+        _mm_store_si128(reinterpret_cast<__m128i*>(z), _mm_andnot_si128(zero, r10));
+
+        pDestination->v = xy[0] | (xy[1] << 11) | (z[2] << 22);
+    }
+
+    inline XMVECTOR XM_CALLCONV LoadFloat3PK(_In_ const XMFLOAT3PK* pSource) noexcept
+    {
+        assert(pSource);
+
+        const uint32_t v = pSource->v;
+
+        // Align each exponent to the float32 exponent position
+        const __m128i t = _mm_setr_epi32(
+            static_cast<int>((v & 0x7FF) << 17),
+            static_cast<int>(((v >> 11) & 0x7FF) << 17),
+            static_cast<int>((v >> 22) << 18),
+            0);
+
+        const __m128i exponent = _mm_and_si128(t, _mm_set1_epi32(0x0F800000));
+        if (_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(exponent, _mm_set1_epi32(0x0F800000)))) != 0)
+        {
+            // INF or NAN
+            return XMLoadFloat3PK(pSource);
+        }
+
+        static const XMVECTORF32 s_denormScale = { { { 1.f / 137438953472.f /* 2^-37 */, 1.f / 137438953472.f, 1.f / 137438953472.f, 1.f / 137438953472.f } } };
+        const __m128i denorm = _mm_cmpeq_epi32(exponent, _mm_setzero_si128());
+        const __m128 nvalue = _mm_castsi128_ps(_mm_add_epi32(t, _mm_set1_epi32(0x38000000)));
+        const __m128 dvalue = _mm_mul_ps(_mm_cvtepi32_ps(t), s_denormScale);
+        const XMVECTOR result = XMVectorSelect(nvalue, dvalue, _mm_castsi128_ps(denorm));
+        return XMVectorSelect(g_XMIdentityR3, result, g_XMSelect1110);
+    }
+#else // !_XM_SSE_INTRINSICS_
+    inline uint32_t XM_CALLCONV EncodeFloat7e3A2(FXMVECTOR V) noexcept
+    {
+        XMFLOAT4A tmp;
+        XMStoreFloat4A(&tmp, V);
+
+        return FloatTo7e3(tmp.x)
+            | (FloatTo7e3(tmp.y) << 10)
+            | (FloatTo7e3(tmp.z) << 20)
+            | ((static_cast<uint32_t>(tmp.w) & 0x3) << 30);
+    }
+
+    inline uint32_t XM_CALLCONV EncodeFloat6e4A2(FXMVECTOR V) noexcept
+    {
+        XMFLOAT4A tmp;
+        XMStoreFloat4A(&tmp, V);
+
+        return FloatTo6e4(tmp.x)
+            | (FloatTo6e4(tmp.y) << 10)
+            | (FloatTo6e4(tmp.z) << 20)
+            | ((static_cast<uint32_t>(tmp.w) & 0x3) << 30);
+    }
+
+    inline XMVECTOR XM_CALLCONV DecodeFloat7e3A2(uint32_t v) noexcept
+    {
+        const XMVECTORF32 vResult = { { {
+            FloatFrom7e3(v & 0x3FF),
+            FloatFrom7e3((v >> 10) & 0x3FF),
+            FloatFrom7e3((v >> 20) & 0x3FF),
+            static_cast<float>(v >> 30) / 3.0f
+        } } };
+        return vResult.v;
+    }
+
+    inline XMVECTOR XM_CALLCONV DecodeFloat6e4A2(uint32_t v) noexcept
+    {
+        const XMVECTORF32 vResult = { { {
+            FloatFrom6e4(v & 0x3FF),
+            FloatFrom6e4((v >> 10) & 0x3FF),
+            FloatFrom6e4((v >> 20) & 0x3FF),
+            static_cast<float>(v >> 30) / 3.0f
+        } } };
+        return vResult.v;
+    }
+
+#define LoadFloat3SE XMLoadFloat3SE
+#define StoreFloat3PK XMStoreFloat3PK
+#define LoadFloat3PK XMLoadFloat3PK
+
 #if DIRECTX_MATH_VERSION >= 310
 #define StoreFloat3SE XMStoreFloat3SE
 #else
@@ -190,6 +455,7 @@ namespace
         pDestination->zm = static_cast<uint32_t>(lroundf(z * ScaleR));
     }
 #endif
+#endif // _XM_SSE_INTRINSICS_
 
     const XMVECTORF32 g_Grayscale = { { { 0.2125f, 0.7154f, 0.0721f, 0.0f } } };
     const XMVECTORF32 g_HalfMin = { { { -65504.f, -65504.f, -65504.f, -65504.f } } };
@@ -197,6 +463,531 @@ namespace
 
     constexpr float g_8BitBias = 0.5f / 255.f;
     const XMVECTORF32 g_8BitBiasV = { { { g_8BitBias, g_8BitBias, g_8BitBias, g_8BitBias } } };
+
+    //---------------------------------------------------------------------------------
+    // Half-precision scanline helpers
+    //
+    // These convert an entire row with one XMConvert*Stream call, which DirectXMath
+    // implements with F16C on x86/x64 (_XM_F16C_INTRINSICS_) and the FP16 conversion
+    // instructions on ARM64. Results are bit-identical to XMLoadHalf*/XMStoreHalf*.
+    //---------------------------------------------------------------------------------
+    void LoadHalfScanline(
+        _Out_writes_(count) XMVECTOR* pDestination,
+        _In_reads_(count * channels) const HALF* pSource,
+        size_t count,
+        size_t channels) noexcept
+    {
+        assert(channels == 1 || channels == 2 || channels == 4);
+
+        auto fPtr = reinterpret_cast<float*>(pDestination);
+
+        if (channels == 4)
+        {
+            XMConvertHalfToFloatStream(fPtr, sizeof(float), pSource, sizeof(HALF), count * 4);
+            return;
+        }
+
+        // Convert into the tail of the destination row, then expand to float4 moving forward.
+        // Expanding pixel i only overwrites converted values for pixels <= i, so this is safe in-place.
+        float* tPtr = fPtr + (4 - channels) * count;
+        XMConvertHalfToFloatStream(tPtr, sizeof(float), pSource, sizeof(HALF), count * channels);
+
+        XMVECTOR* dPtr = pDestination;
+        if (channels == 2)
+        {
+            for (size_t icount = 0; icount < count; ++icount, tPtr += 2)
+            {
+                const XMVECTOR v = XMLoadFloat2(reinterpret_cast<const XMFLOAT2*>(tPtr));
+                *(dPtr++) = XMVectorSelect(g_XMIdentityR3, v, g_XMSelect1100);
+            }
+        }
+        else
+        {
+            for (size_t icount = 0; icount < count; ++icount, ++tPtr)
+            {
+                const XMVECTOR v = XMLoadFloat(tPtr);
+                *(dPtr++) = XMVectorSelect(g_XMIdentityR3, v, g_XMSelect1000);
+            }
+        }
+    }
+
+    void StoreHalfScanline(
+        _Out_writes_(count * channels) HALF* pDestination,
+        _In_reads_(count) const XMVECTOR* pSource,
+        size_t count,
+        size_t channels) noexcept
+    {
+        assert(channels == 1 || channels == 2 || channels == 4);
+
+        // Values are clamped to the half range before conversion (F16C would otherwise produce INF),
+        // so the row is processed in blocks through a small stack buffer.
+        constexpr size_t c_BlockSize = 64;
+        XM_ALIGNED_DATA(16) float temp[c_BlockSize * 4];
+
+        HALF* dPtr = pDestination;
+        const XMVECTOR* sPtr = pSource;
+        for (size_t remaining = count; remaining > 0; )
+        {
+            const size_t block = std::min<size_t>(remaining, c_BlockSize);
+
+            float* tPtr = temp;
+            switch (channels)
+            {
+            case 4:
+                for (size_t icount = 0; icount < block; ++icount, tPtr += 4)
+                {
+                    XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(tPtr), XMVectorClamp(*sPtr++, g_HalfMin, g_HalfMax));
+                }
+                break;
+
+            case 2:
+                for (size_t icount = 0; icount < block; ++icount, tPtr += 2)
+                {
+                    XMStoreFloat2(reinterpret_cast<XMFLOAT2*>(tPtr), XMVectorClamp(*sPtr++, g_HalfMin, g_HalfMax));
+                }
+                break;
+
+            default:
+                for (size_t icount = 0; icount < block; ++icount, ++tPtr)
+                {
+                    XMStoreFloat(tPtr, XMVectorClamp(*sPtr++, g_HalfMin, g_HalfMax));
+                }
+                break;
+            }
+
+            XMConvertFloatToHalfStream(dPtr, sizeof(HALF), temp, sizeof(float), block * channels);
+
+            dPtr += block * channels;
+            remaining -= block;
+        }
+    }
+
+    //---------------------------------------------------------------------------------
+    // Y'CbCr scanline helpers
+    //
+    // Fixed-point studio-range conversions used by the AYUV/YUY2 (8-bit) and
+    // Y410/Y210 (10-bit) formats. Inputs to the YUV->RGB functions have the luma and
+    // chroma offsets already removed; the RGB->YUV functions return unclamped values
+    // with the offsets applied.
+    //---------------------------------------------------------------------------------
+    inline XMVECTOR XM_CALLCONV YUVToRGB8(int y, int u, int v, int a) noexcept
+    {
+        // http://msdn.microsoft.com/en-us/library/windows/desktop/dd206750.aspx
+
+        // Y'  = Y - 16
+        // Cb' = Cb - 128
+        // Cr' = Cr - 128
+
+        // R = 1.1644Y' + 1.5960Cr'
+        // G = 1.1644Y' - 0.3917Cb' - 0.8128Cr'
+        // B = 1.1644Y' + 2.0172Cb'
+
+        const int r = (298 * y + 409 * v + 128) >> 8;
+        const int g = (298 * y - 100 * u - 208 * v + 128) >> 8;
+        const int b = (298 * y + 516 * u + 128) >> 8;
+
+        return XMVectorSet(float(std::min<int>(std::max<int>(r, 0), 255)) / 255.f,
+            float(std::min<int>(std::max<int>(g, 0), 255)) / 255.f,
+            float(std::min<int>(std::max<int>(b, 0), 255)) / 255.f,
+            float(a) / 255.f);
+    }
+
+    inline XMVECTOR XM_CALLCONV YUVToRGB10(int y, int u, int v, float a) noexcept
+    {
+        // http://msdn.microsoft.com/en-us/library/windows/desktop/bb970578.aspx
+
+        // Y'  = Y - 64
+        // Cb' = Cb - 512
+        // Cr' = Cr - 512
+
+        // R = 1.1678Y' + 1.6007Cr'
+        // G = 1.1678Y' - 0.3929Cb' - 0.8152Cr'
+        // B = 1.1678Y' + 2.0232Cb'
+
+        const int64_t y64 = y;
+        const int64_t u64 = u;
+        const int64_t v64 = v;
+
+        const auto r = static_cast<int>((76533 * y64 + 104905 * v64 + 32768) >> 16);
+        const auto g = static_cast<int>((76533 * y64 - 25747 * u64 - 53425 * v64 + 32768) >> 16);
+        const auto b = static_cast<int>((76533 * y64 + 132590 * u64 + 32768) >> 16);
+
+        return XMVectorSet(float(std::min<int>(std::max<int>(r, 0), 1023)) / 1023.f,
+            float(std::min<int>(std::max<int>(g, 0), 1023)) / 1023.f,
+            float(std::min<int>(std::max<int>(b, 0), 1023)) / 1023.f,
+            a);
+    }
+
+    inline void RGBToYUV8(int r, int g, int b, int& y, int& u, int& v) noexcept
+    {
+        // http://msdn.microsoft.com/en-us/library/windows/desktop/dd206750.aspx
+
+        // Y  =  0.2568R + 0.5041G + 0.1001B + 16
+        // Cb = -0.1482R - 0.2910G + 0.4392B + 128
+        // Cr =  0.4392R - 0.3678G - 0.0714B + 128
+
+        y = ((66 * r + 129 * g + 25 * b + 128) >> 8) + 16;
+        u = ((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128;
+        v = ((112 * r - 94 * g - 18 * b + 128) >> 8) + 128;
+    }
+
+    inline void RGBToYUV10(int r, int g, int b, int& y, int& u, int& v) noexcept
+    {
+        // http://msdn.microsoft.com/en-us/library/windows/desktop/bb970578.aspx
+
+        // Y  =  0.2560R + 0.5027G + 0.0998B + 64
+        // Cb = -0.1478R - 0.2902G + 0.4379B + 512
+        // Cr =  0.4379R - 0.3667G - 0.0712B + 512
+
+        const int64_t r64 = r;
+        const int64_t g64 = g;
+        const int64_t b64 = b;
+
+        y = static_cast<int>((16780 * r64 + 32942 * g64 + 6544 * b64 + 32768) >> 16) + 64;
+        u = static_cast<int>((-9683 * r64 - 19017 * g64 + 28700 * b64 + 32768) >> 16) + 512;
+        v = static_cast<int>((28700 * r64 - 24033 * g64 - 4667 * b64 + 32768) >> 16) + 512;
+    }
+
+#if defined(_XM_SSE_INTRINSICS_) && !defined(_XM_NO_INTRINSICS_)
+    //---------------------------------------------------------------------------------
+    // SSE2 Y'CbCr row kernels
+    //
+    // The row functions convert four pixels per iteration, one pixel in each 32-bit
+    // lane, and are bit-identical to the scalar helpers above. Every channel is a sum
+    // of _mm_madd_epi16 products over (sample, sample) and (sample, 1) pairs, with the
+    // rounding constant carried by the '1'. The 10-bit coefficients are split as
+    // c = 256 * hi + lo so the products fit in signed 16-bit. Rows are left to the
+    // scalar loops for the last few pixels.
+    //---------------------------------------------------------------------------------
+
+    // Packs the low 16 bits of each lane of a and b into (a, b) pairs
+    inline __m128i PairSamples(__m128i a, __m128i b) noexcept
+    {
+        return _mm_or_si128(_mm_and_si128(a, _mm_set1_epi32(0xFFFF)), _mm_slli_epi32(b, 16));
+    }
+
+    // (a.x * a0 + a.y * a1) + (b.x * b0 + b.y * b1) for each lane
+    inline __m128i DotPairs(__m128i a, int16_t a0, int16_t a1, __m128i b, int16_t b0, int16_t b1) noexcept
+    {
+        return _mm_add_epi32(
+            _mm_madd_epi16(a, _mm_setr_epi16(a0, a1, a0, a1, a0, a1, a0, a1)),
+            _mm_madd_epi16(b, _mm_setr_epi16(b0, b1, b0, b1, b0, b1, b0, b1)));
+    }
+
+    // (hi + (lo >> 8)) >> 8, which is (c * x + 32768) >> 16 when the rounding is carried in hi
+    inline __m128i CombineSplit(__m128i hi, __m128i lo) noexcept
+    {
+        return _mm_srai_epi32(_mm_add_epi32(hi, _mm_srai_epi32(lo, 8)), 8);
+    }
+
+    inline __m128i ClampInt(__m128i v, int maxValue) noexcept
+    {
+        const __m128i vmax = _mm_set1_epi32(maxValue);
+        v = _mm_and_si128(v, _mm_cmpgt_epi32(v, _mm_setzero_si128()));
+        return SelectInt(_mm_cmpgt_epi32(v, vmax), vmax, v);
+    }
+
+    // Writes four pixels from integer R, G, B lanes in [0, maxValue] (after clamping) and float alpha
+    inline void XM_CALLCONV StoreRGBx4(XMVECTOR* pDestination, __m128i r, __m128i g, __m128i b, FXMVECTOR a, FXMVECTOR maxValue) noexcept
+    {
+        XMVECTOR vr = _mm_div_ps(XMVectorClamp(_mm_cvtepi32_ps(r), g_XMZero, maxValue), maxValue);
+        XMVECTOR vg = _mm_div_ps(XMVectorClamp(_mm_cvtepi32_ps(g), g_XMZero, maxValue), maxValue);
+        XMVECTOR vb = _mm_div_ps(XMVectorClamp(_mm_cvtepi32_ps(b), g_XMZero, maxValue), maxValue);
+        XMVECTOR va = a;
+
+        _MM_TRANSPOSE4_PS(vr, vg, vb, va);
+
+        pDestination[0] = vr;
+        pDestination[1] = vg;
+        pDestination[2] = vb;
+        pDestination[3] = va;
+    }
+
+    // Vector form of YUVToRGB8, without the clamp
+    inline void YUVToRGB8x4(__m128i y, __m128i u, __m128i v, __m128i& r, __m128i& g, __m128i& b) noexcept
+    {
+        const __m128i yv = PairSamples(y, v);
+        const __m128i u1 = PairSamples(u, _mm_set1_epi32(1));
+
+        r = _mm_srai_epi32(DotPairs(yv, 298, 409, u1, 0, 128), 8);
+        g = _mm_srai_epi32(DotPairs(yv, 298, -208, u1, -100, 128), 8);
+        b = _mm_srai_epi32(DotPairs(yv, 298, 0, u1, 516, 128), 8);
+    }
+
+    // Vector form of YUVToRGB10, without the clamp
+    // 76533 = 298:245, 104905 = 409:201, -25747 = -101:109, -53425 = -209:79, 132590 = 517:238
+    inline void YUVToRGB10x4(__m128i y, __m128i u, __m128i v, __m128i& r, __m128i& g, __m128i& b) noexcept
+    {
+        const __m128i yv = PairSamples(y, v);
+        const __m128i u1 = PairSamples(u, _mm_set1_epi32(1));
+
+        r = CombineSplit(DotPairs(yv, 298, 409, u1, 0, 128), DotPairs(yv, 245, 201, u1, 0, 0));
+        g = CombineSplit(DotPairs(yv, 298, -209, u1, -101, 128), DotPairs(yv, 245, 79, u1, 109, 0));
+        b = CombineSplit(DotPairs(yv, 298, 0, u1, 517, 128), DotPairs(yv, 245, 0, u1, 238, 0));
+    }
+
+    // Vector form of RGBToYUV8
+    inline void RGBToYUV8x4(__m128i r, __m128i g, __m128i b, __m128i& y, __m128i& u, __m128i& v) noexcept
+    {
+        const __m128i rg = PairSamples(r, g);
+        const __m128i b1 = PairSamples(b, _mm_set1_epi32(1));
+
+        y = _mm_add_epi32(_mm_srai_epi32(DotPairs(rg, 66, 129, b1, 25, 128), 8), _mm_set1_epi32(16));
+        u = _mm_add_epi32(_mm_srai_epi32(DotPairs(rg, -38, -74, b1, 112, 128), 8), _mm_set1_epi32(128));
+        v = _mm_add_epi32(_mm_srai_epi32(DotPairs(rg, 112, -94, b1, -18, 128), 8), _mm_set1_epi32(128));
+    }
+
+    // Vector form of RGBToYUV10
+    // 16780 = 65:140, 32942 = 128:174, 6544 = 25:144, -9683 = -38:45, -19017 = -75:183,
+    // 28700 = 112:28, -24033 = -94:31, -4667 = -19:197
+    inline void RGBToYUV10x4(__m128i r, __m128i g, __m128i b, __m128i& y, __m128i& u, __m128i& v) noexcept
+    {
+        const __m128i rg = PairSamples(r, g);
+        const __m128i b1 = PairSamples(b, _mm_set1_epi32(1));
+
+        y = _mm_add_epi32(CombineSplit(DotPairs(rg, 65, 128, b1, 25, 128), DotPairs(rg, 140, 174, b1, 144, 0)), _mm_set1_epi32(64));
+        u = _mm_add_epi32(CombineSplit(DotPairs(rg, -38, -75, b1, 112, 128), DotPairs(rg, 45, 183, b1, 28, 0)), _mm_set1_epi32(512));
+        v = _mm_add_epi32(CombineSplit(DotPairs(rg, 112, -94, b1, -19, 128), DotPairs(rg, 28, 31, b1, 197, 0)), _mm_set1_epi32(512));
+    }
+
+    // Splits two (Y0, Cb, Y1, Cr) macropixels widened to 16-bit into four pixels with shared chroma
+    inline void Split422(__m128i p, __m128i& y, __m128i& u, __m128i& v) noexcept
+    {
+        y = _mm_and_si128(p, _mm_set1_epi32(0xFFFF));
+
+        const __m128i c = _mm_srli_epi32(p, 16);
+        u = _mm_shuffle_epi32(c, _MM_SHUFFLE(2, 2, 0, 0));
+        v = _mm_shuffle_epi32(c, _MM_SHUFFLE(3, 3, 1, 1));
+    }
+
+    // Averages the chroma of pixel pairs into lanes 0 and 2, as the scalar YUY2/Y210 path does
+    inline __m128i AverageChroma(__m128i c) noexcept
+    {
+        return _mm_srai_epi32(_mm_add_epi32(c, _mm_shuffle_epi32(c, _MM_SHUFFLE(2, 3, 0, 1))), 1);
+    }
+
+    //--- Row functions: return how many pixels were converted (count rounded down to a multiple of 4) ---
+    constexpr size_t c_YUVBlockSize = 64;
+
+    size_t LoadAYUVRow(_Out_writes_(count) XMVECTOR* pDestination, _In_reads_(count) const XMUBYTEN4* pSource, size_t count) noexcept
+    {
+        static const XMVECTORF32 s_max = { { { 255.f, 255.f, 255.f, 255.f } } };
+        const __m128i mask = _mm_set1_epi32(0xFF);
+
+        count &= ~size_t(3);
+        for (size_t i = 0; i < count; i += 4)
+        {
+            const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSource + i));
+
+            const __m128i v = _mm_sub_epi32(_mm_and_si128(p, mask), _mm_set1_epi32(128));
+            const __m128i u = _mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(p, 8), mask), _mm_set1_epi32(128));
+            const __m128i y = _mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(p, 16), mask), _mm_set1_epi32(16));
+            const XMVECTOR a = _mm_div_ps(_mm_cvtepi32_ps(_mm_srli_epi32(p, 24)), s_max);
+
+            __m128i r, g, b;
+            YUVToRGB8x4(y, u, v, r, g, b);
+            StoreRGBx4(pDestination + i, r, g, b, a, s_max);
+        }
+        return count;
+    }
+
+    size_t LoadY410Row(_Out_writes_(count) XMVECTOR* pDestination, _In_reads_(count) const XMUDECN4* pSource, size_t count) noexcept
+    {
+        static const XMVECTORF32 s_max = { { { 1023.f, 1023.f, 1023.f, 1023.f } } };
+        static const XMVECTORF32 s_alphaMax = { { { 3.f, 3.f, 3.f, 3.f } } };
+        const __m128i mask = _mm_set1_epi32(0x3FF);
+
+        count &= ~size_t(3);
+        for (size_t i = 0; i < count; i += 4)
+        {
+            const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSource + i));
+
+            const __m128i u = _mm_sub_epi32(_mm_and_si128(p, mask), _mm_set1_epi32(512));
+            const __m128i y = _mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(p, 10), mask), _mm_set1_epi32(64));
+            const __m128i v = _mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(p, 20), mask), _mm_set1_epi32(512));
+            const XMVECTOR a = _mm_div_ps(_mm_cvtepi32_ps(_mm_srli_epi32(p, 30)), s_alphaMax);
+
+            __m128i r, g, b;
+            YUVToRGB10x4(y, u, v, r, g, b);
+            StoreRGBx4(pDestination + i, r, g, b, a, s_max);
+        }
+        return count;
+    }
+
+    // pSource holds count / 2 macropixels
+    size_t LoadYUY2Row(_Out_writes_(count) XMVECTOR* pDestination, _In_reads_(count / 2) const XMUBYTEN4* pSource, size_t count) noexcept
+    {
+        static const XMVECTORF32 s_max = { { { 255.f, 255.f, 255.f, 255.f } } };
+
+        count &= ~size_t(3);
+        for (size_t i = 0; i < count; i += 4)
+        {
+            const __m128i p = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pSource + i / 2)), _mm_setzero_si128());
+
+            __m128i y, u, v;
+            Split422(p, y, u, v);
+            y = _mm_sub_epi32(y, _mm_set1_epi32(16));
+            u = _mm_sub_epi32(u, _mm_set1_epi32(128));
+            v = _mm_sub_epi32(v, _mm_set1_epi32(128));
+
+            __m128i r, g, b;
+            YUVToRGB8x4(y, u, v, r, g, b);
+            StoreRGBx4(pDestination + i, r, g, b, g_XMOne, s_max);
+        }
+        return count;
+    }
+
+    // pSource holds count / 2 macropixels
+    size_t LoadY210Row(_Out_writes_(count) XMVECTOR* pDestination, _In_reads_(count / 2) const XMUSHORTN4* pSource, size_t count) noexcept
+    {
+        static const XMVECTORF32 s_max = { { { 1023.f, 1023.f, 1023.f, 1023.f } } };
+
+        count &= ~size_t(3);
+        for (size_t i = 0; i < count; i += 4)
+        {
+            const __m128i p = _mm_srli_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pSource + i / 2)), 6);
+
+            __m128i y, u, v;
+            Split422(p, y, u, v);
+            y = _mm_sub_epi32(y, _mm_set1_epi32(64));
+            u = _mm_sub_epi32(u, _mm_set1_epi32(512));
+            v = _mm_sub_epi32(v, _mm_set1_epi32(512));
+
+            __m128i r, g, b;
+            YUVToRGB10x4(y, u, v, r, g, b);
+            StoreRGBx4(pDestination + i, r, g, b, g_XMOne, s_max);
+        }
+        return count;
+    }
+
+    // The store rows quantize with the same DirectXMath functions as the scalar path, a block at a
+    // time into a local buffer, so the wide loads that follow never wait on the narrow stores
+    size_t StoreAYUVRow(_Out_writes_(count) XMUBYTEN4* pDestination, _In_reads_(count) const XMVECTOR* pSource, size_t count) noexcept
+    {
+        XM_ALIGNED_DATA(16) XMUBYTEN4 rgba[c_YUVBlockSize];
+        const __m128i mask = _mm_set1_epi32(0xFF);
+
+        count &= ~size_t(3);
+        for (size_t i = 0; i < count; i += c_YUVBlockSize)
+        {
+            const size_t block = std::min(count - i, c_YUVBlockSize);
+            for (size_t j = 0; j < block; ++j)
+            {
+                XMStoreUByteN4(&rgba[j], pSource[i + j]);
+            }
+
+            for (size_t j = 0; j < block; j += 4)
+            {
+                const __m128i p = _mm_load_si128(reinterpret_cast<const __m128i*>(&rgba[j]));
+
+                __m128i y, u, v;
+                RGBToYUV8x4(_mm_and_si128(p, mask), _mm_and_si128(_mm_srli_epi32(p, 8), mask), _mm_and_si128(_mm_srli_epi32(p, 16), mask), y, u, v);
+
+                __m128i result = _mm_or_si128(ClampInt(v, 255), _mm_slli_epi32(ClampInt(u, 255), 8));
+                result = _mm_or_si128(result, _mm_slli_epi32(ClampInt(y, 255), 16));
+                result = _mm_or_si128(result, _mm_andnot_si128(_mm_set1_epi32(0xFFFFFF), p));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pDestination + i + j), result);
+            }
+        }
+        return count;
+    }
+
+    size_t StoreY410Row(_Out_writes_(count) XMUDECN4* pDestination, _In_reads_(count) const XMVECTOR* pSource, size_t count) noexcept
+    {
+        XM_ALIGNED_DATA(16) XMUDECN4 rgba[c_YUVBlockSize];
+        const __m128i mask = _mm_set1_epi32(0x3FF);
+
+        count &= ~size_t(3);
+        for (size_t i = 0; i < count; i += c_YUVBlockSize)
+        {
+            const size_t block = std::min(count - i, c_YUVBlockSize);
+            for (size_t j = 0; j < block; ++j)
+            {
+                XMStoreUDecN4(&rgba[j], pSource[i + j]);
+            }
+
+            for (size_t j = 0; j < block; j += 4)
+            {
+                const __m128i p = _mm_load_si128(reinterpret_cast<const __m128i*>(&rgba[j]));
+
+                __m128i y, u, v;
+                RGBToYUV10x4(_mm_and_si128(p, mask), _mm_and_si128(_mm_srli_epi32(p, 10), mask), _mm_and_si128(_mm_srli_epi32(p, 20), mask), y, u, v);
+
+                __m128i result = _mm_or_si128(ClampInt(u, 1023), _mm_slli_epi32(ClampInt(y, 1023), 10));
+                result = _mm_or_si128(result, _mm_slli_epi32(ClampInt(v, 1023), 20));
+                result = _mm_or_si128(result, _mm_andnot_si128(_mm_set1_epi32(0x3FFFFFFF), p));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pDestination + i + j), result);
+            }
+        }
+        return count;
+    }
+
+    // pDestination receives count / 2 macropixels
+    size_t StoreYUY2Row(_Out_writes_(count / 2) XMUBYTEN4* pDestination, _In_reads_(count) const XMVECTOR* pSource, size_t count) noexcept
+    {
+        XM_ALIGNED_DATA(16) XMUBYTEN4 rgba[c_YUVBlockSize];
+        const __m128i mask = _mm_set1_epi32(0xFF);
+
+        count &= ~size_t(3);
+        for (size_t i = 0; i < count; i += c_YUVBlockSize)
+        {
+            const size_t block = std::min(count - i, c_YUVBlockSize);
+            for (size_t j = 0; j < block; ++j)
+            {
+                XMStoreUByteN4(&rgba[j], pSource[i + j]);
+            }
+
+            for (size_t j = 0; j < block; j += 4)
+            {
+                const __m128i p = _mm_load_si128(reinterpret_cast<const __m128i*>(&rgba[j]));
+
+                __m128i y, u, v;
+                RGBToYUV8x4(_mm_and_si128(p, mask), _mm_and_si128(_mm_srli_epi32(p, 8), mask), _mm_and_si128(_mm_srli_epi32(p, 16), mask), y, u, v);
+
+                // Lanes 0 and 2 become (Y0, Cb, Y1, Cr)
+                y = ClampInt(y, 255);
+                const __m128i lo = _mm_or_si128(y, _mm_slli_epi32(ClampInt(AverageChroma(u), 255), 8));
+                const __m128i hi = _mm_or_si128(_mm_srli_si128(y, 4), _mm_slli_epi32(ClampInt(AverageChroma(v), 255), 8));
+                const __m128i result = _mm_or_si128(lo, _mm_slli_epi32(hi, 16));
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(pDestination + (i + j) / 2), _mm_shuffle_epi32(result, _MM_SHUFFLE(3, 1, 2, 0)));
+            }
+        }
+        return count;
+    }
+
+    // pDestination receives count / 2 macropixels
+    size_t StoreY210Row(_Out_writes_(count / 2) XMUSHORTN4* pDestination, _In_reads_(count) const XMVECTOR* pSource, size_t count) noexcept
+    {
+        XM_ALIGNED_DATA(16) XMUDECN4 rgba[c_YUVBlockSize];
+        const __m128i mask = _mm_set1_epi32(0x3FF);
+
+        count &= ~size_t(3);
+        for (size_t i = 0; i < count; i += c_YUVBlockSize)
+        {
+            const size_t block = std::min(count - i, c_YUVBlockSize);
+            for (size_t j = 0; j < block; ++j)
+            {
+                XMStoreUDecN4(&rgba[j], pSource[i + j]);
+            }
+
+            for (size_t j = 0; j < block; j += 4)
+            {
+                const __m128i p = _mm_load_si128(reinterpret_cast<const __m128i*>(&rgba[j]));
+
+                __m128i y, u, v;
+                RGBToYUV10x4(_mm_and_si128(p, mask), _mm_and_si128(_mm_srli_epi32(p, 10), mask), _mm_and_si128(_mm_srli_epi32(p, 20), mask), y, u, v);
+
+                // Lanes 0 and 2 of lo/hi become (Y0, Cb) and (Y1, Cr), with the 10-bit values in the high bits
+                y = _mm_slli_epi32(ClampInt(y, 1023), 6);
+                const __m128i lo = _mm_or_si128(y, _mm_slli_epi32(ClampInt(AverageChroma(u), 1023), 22));
+                const __m128i hi = _mm_or_si128(_mm_srli_si128(y, 4), _mm_slli_epi32(ClampInt(AverageChroma(v), 1023), 22));
+                const __m128i result = _mm_unpacklo_epi64(_mm_unpacklo_epi32(lo, hi), _mm_unpackhi_epi32(lo, hi));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pDestination + (i + j) / 2), result);
+            }
+        }
+        return count;
+    }
+#endif // _XM_SSE_INTRINSICS_
 }
 
 //-------------------------------------------------------------------------------------
@@ -818,7 +1609,13 @@ _Use_decl_annotations_ bool DirectX::Internal::LoadScanline(
         LOAD_SCANLINE3(XMINT3, XMLoadSInt3, g_XMIdentityR3)
 
     case DXGI_FORMAT_R16G16B16A16_FLOAT:
-        LOAD_SCANLINE(XMHALF4, XMLoadHalf4)
+        if (size >= sizeof(XMHALF4))
+        {
+            const size_t pixels = std::min<size_t>(count, size / sizeof(XMHALF4));
+            LoadHalfScanline(dPtr, static_cast<const HALF*>(pSource), pixels, 4);
+            return true;
+        }
+        return false;
 
     case DXGI_FORMAT_R16G16B16A16_UNORM:
         LOAD_SCANLINE(XMUSHORTN4, XMLoadUShortN4)
@@ -904,7 +1701,7 @@ _Use_decl_annotations_ bool DirectX::Internal::LoadScanline(
         LOAD_SCANLINE(XMUDEC4, XMLoadUDec4)
 
     case DXGI_FORMAT_R11G11B10_FLOAT:
-        LOAD_SCANLINE3(XMFLOAT3PK, XMLoadFloat3PK, g_XMIdentityR3)
+        LOAD_SCANLINE3(XMFLOAT3PK, LoadFloat3PK, g_XMIdentityR3)
 
     case DXGI_FORMAT_R8G8B8A8_UNORM:
     case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
@@ -920,7 +1717,13 @@ _Use_decl_annotations_ bool DirectX::Internal::LoadScanline(
         LOAD_SCANLINE(XMBYTE4, XMLoadByte4)
 
     case DXGI_FORMAT_R16G16_FLOAT:
-        LOAD_SCANLINE2(XMHALF2, XMLoadHalf2, g_XMIdentityR3)
+        if (size >= sizeof(XMHALF2))
+        {
+            const size_t pixels = std::min<size_t>(count, size / sizeof(XMHALF2));
+            LoadHalfScanline(dPtr, static_cast<const HALF*>(pSource), pixels, 2);
+            return true;
+        }
+        return false;
 
     case DXGI_FORMAT_R16G16_UNORM:
         LOAD_SCANLINE2(XMUSHORTN2, XMLoadUShortN2, g_XMIdentityR3)
@@ -1040,12 +1843,8 @@ _Use_decl_annotations_ bool DirectX::Internal::LoadScanline(
     case DXGI_FORMAT_R16_FLOAT:
         if (size >= sizeof(HALF))
         {
-            const HALF * __restrict sPtr = static_cast<const HALF*>(pSource);
-            for (size_t icount = 0; icount < (size - sizeof(HALF) + 1); icount += sizeof(HALF))
-            {
-                if (dPtr >= ePtr) break;
-                *(dPtr++) = XMVectorSet(XMConvertHalfToFloat(*sPtr++), 0.f, 0.f, 1.f);
-            }
+            const size_t pixels = std::min<size_t>(count, size / sizeof(HALF));
+            LoadHalfScanline(dPtr, static_cast<const HALF*>(pSource), pixels, 1);
             return true;
         }
         return false;
@@ -1187,7 +1986,7 @@ _Use_decl_annotations_ bool DirectX::Internal::LoadScanline(
         return false;
 
     case DXGI_FORMAT_R9G9B9E5_SHAREDEXP:
-        LOAD_SCANLINE3(XMFLOAT3SE, XMLoadFloat3SE, g_XMIdentityR3)
+        LOAD_SCANLINE3(XMFLOAT3SE, LoadFloat3SE, g_XMIdentityR3)
 
     case DXGI_FORMAT_R8G8_B8G8_UNORM:
         if (size >= sizeof(XMUBYTEN4))
@@ -1292,33 +2091,25 @@ _Use_decl_annotations_ bool DirectX::Internal::LoadScanline(
         if (size >= sizeof(XMUBYTEN4))
         {
             const XMUBYTEN4 * __restrict sPtr = static_cast<const XMUBYTEN4*>(pSource);
-            for (size_t icount = 0; icount < (size - sizeof(XMUBYTEN4) + 1); icount += sizeof(XMUBYTEN4))
+            size_t icount = 0;
+        #if defined(_XM_SSE_INTRINSICS_) && !defined(_XM_NO_INTRINSICS_)
+            {
+                const size_t pixels = LoadAYUVRow(dPtr, sPtr, std::min<size_t>(size / sizeof(XMUBYTEN4), count));
+                sPtr += pixels;
+                dPtr += pixels;
+                icount = pixels * sizeof(XMUBYTEN4);
+            }
+        #endif
+            for (; icount < (size - sizeof(XMUBYTEN4) + 1); icount += sizeof(XMUBYTEN4))
             {
                 const int v = int(sPtr->x) - 128;
                 const int u = int(sPtr->y) - 128;
                 const int y = int(sPtr->z) - 16;
-                const unsigned int a = sPtr->w;
+                const int a = sPtr->w;
                 ++sPtr;
 
-                // http://msdn.microsoft.com/en-us/library/windows/desktop/dd206750.aspx
-
-                // Y'  = Y - 16
-                // Cb' = Cb - 128
-                // Cr' = Cr - 128
-
-                // R = 1.1644Y' + 1.5960Cr'
-                // G = 1.1644Y' - 0.3917Cb' - 0.8128Cr'
-                // B = 1.1644Y' + 2.0172Cb'
-
-                const int r = (298 * y + 409 * v + 128) >> 8;
-                const int g = (298 * y - 100 * u - 208 * v + 128) >> 8;
-                const int b = (298 * y + 516 * u + 128) >> 8;
-
                 if (dPtr >= ePtr) break;
-                *(dPtr++) = XMVectorSet(float(std::min<int>(std::max<int>(r, 0), 255)) / 255.f,
-                    float(std::min<int>(std::max<int>(g, 0), 255)) / 255.f,
-                    float(std::min<int>(std::max<int>(b, 0), 255)) / 255.f,
-                    float(a) / 255.f);
+                *(dPtr++) = YUVToRGB8(y, u, v, a);
             }
             return true;
         }
@@ -1328,33 +2119,25 @@ _Use_decl_annotations_ bool DirectX::Internal::LoadScanline(
         if (size >= sizeof(XMUDECN4))
         {
             const XMUDECN4 * __restrict sPtr = static_cast<const XMUDECN4*>(pSource);
-            for (size_t icount = 0; icount < (size - sizeof(XMUDECN4) + 1); icount += sizeof(XMUDECN4))
+            size_t icount = 0;
+        #if defined(_XM_SSE_INTRINSICS_) && !defined(_XM_NO_INTRINSICS_)
+            {
+                const size_t pixels = LoadY410Row(dPtr, sPtr, std::min<size_t>(size / sizeof(XMUDECN4), count));
+                sPtr += pixels;
+                dPtr += pixels;
+                icount = pixels * sizeof(XMUDECN4);
+            }
+        #endif
+            for (; icount < (size - sizeof(XMUDECN4) + 1); icount += sizeof(XMUDECN4))
             {
-                const int64_t u = int(sPtr->x) - 512;
-                const int64_t y = int(sPtr->y) - 64;
-                const int64_t v = int(sPtr->z) - 512;
+                const int u = int(sPtr->x) - 512;
+                const int y = int(sPtr->y) - 64;
+                const int v = int(sPtr->z) - 512;
                 const unsigned int a = sPtr->w;
                 ++sPtr;
 
-                // http://msdn.microsoft.com/en-us/library/windows/desktop/bb970578.aspx
-
-                // Y'  = Y - 64
-                // Cb' = Cb - 512
-                // Cr' = Cr - 512
-
-                // R = 1.1678Y' + 1.6007Cr'
-                // G = 1.1678Y' - 0.3929Cb' - 0.8152Cr'
-                // B = 1.1678Y' + 2.0232Cb'
-
-                const auto r = static_cast<int>((76533 * y + 104905 * v + 32768) >> 16);
-                const auto g = static_cast<int>((76533 * y - 25747 * u - 53425 * v + 32768) >> 16);
-                const auto b = static_cast<int>((76533 * y + 132590 * u + 32768) >> 16);
-
                 if (dPtr >= ePtr) break;
-                *(dPtr++) = XMVectorSet(float(std::min<int>(std::max<int>(r, 0), 1023)) / 1023.f,
-                    float(std::min<int>(std::max<int>(g, 0), 1023)) / 1023.f,
-                    float(std::min<int>(std::max<int>(b, 0), 1023)) / 1023.f,
-                    float(a) / 3.f);
+                *(dPtr++) = YUVToRGB10(y, u, v, float(a) / 3.f);
             }
             return true;
         }
@@ -1400,7 +2183,16 @@ _Use_decl_annotations_ bool DirectX::Internal::LoadScanline(
         if (size >= sizeof(XMUBYTEN4))
         {
             const XMUBYTEN4 * __restrict sPtr = static_cast<const XMUBYTEN4*>(pSource);
-            for (size_t icount = 0; icount < (size - sizeof(XMUBYTEN4) + 1); icount += sizeof(XMUBYTEN4))
+            size_t icount = 0;
+        #if defined(_XM_SSE_INTRINSICS_) && !defined(_XM_NO_INTRINSICS_)
+            {
+                const size_t pixels = LoadYUY2Row(dPtr, sPtr, std::min<size_t>((size / sizeof(XMUBYTEN4)) * 2, count));
+                sPtr += pixels / 2;
+                dPtr += pixels;
+                icount = (pixels / 2) * sizeof(XMUBYTEN4);
+            }
+        #endif
+            for (; icount < (size - sizeof(XMUBYTEN4) + 1); icount += sizeof(XMUBYTEN4))
             {
                 const int y0 = int(sPtr->x) - 16;
                 const int u = int(sPtr->y) - 128;
@@ -1409,25 +2201,11 @@ _Use_decl_annotations_ bool DirectX::Internal::LoadScanline(
                 ++sPtr;
 
                 // See AYUV
-                int r = (298 * y0 + 409 * v + 128) >> 8;
-                int g = (298 * y0 - 100 * u - 208 * v + 128) >> 8;
-                int b = (298 * y0 + 516 * u + 128) >> 8;
-
                 if (dPtr >= ePtr) break;
-                *(dPtr++) = XMVectorSet(float(std::min<int>(std::max<int>(r, 0), 255)) / 255.f,
-                    float(std::min<int>(std::max<int>(g, 0), 255)) / 255.f,
-                    float(std::min<int>(std::max<int>(b, 0), 255)) / 255.f,
-                    1.f);
-
-                r = (298 * y1 + 409 * v + 128) >> 8;
-                g = (298 * y1 - 100 * u - 208 * v + 128) >> 8;
-                b = (298 * y1 + 516 * u + 128) >> 8;
+                *(dPtr++) = YUVToRGB8(y0, u, v, 255);
 
                 if (dPtr >= ePtr) break;
-                *(dPtr++) = XMVectorSet(float(std::min<int>(std::max<int>(r, 0), 255)) / 255.f,
-                    float(std::min<int>(std::max<int>(g, 0), 255)) / 255.f,
-                    float(std::min<int>(std::max<int>(b, 0), 255)) / 255.f,
-                    1.f);
+                *(dPtr++) = YUVToRGB8(y1, u, v, 255);
             }
             return true;
         }
@@ -1438,34 +2216,29 @@ _Use_decl_annotations_ bool DirectX::Internal::LoadScanline(
         if (size >= sizeof(XMUSHORTN4))
         {
             const XMUSHORTN4 * __restrict sPtr = static_cast<const XMUSHORTN4*>(pSource);
-            for (size_t icount = 0; icount < (size - sizeof(XMUSHORTN4) + 1); icount += sizeof(XMUSHORTN4))
+            size_t icount = 0;
+        #if defined(_XM_SSE_INTRINSICS_) && !defined(_XM_NO_INTRINSICS_)
+            {
+                const size_t pixels = LoadY210Row(dPtr, sPtr, std::min<size_t>((size / sizeof(XMUSHORTN4)) * 2, count));
+                sPtr += pixels / 2;
+                dPtr += pixels;
+                icount = (pixels / 2) * sizeof(XMUSHORTN4);
+            }
+        #endif
+            for (; icount < (size - sizeof(XMUSHORTN4) + 1); icount += sizeof(XMUSHORTN4))
             {
-                const int64_t y0 = int64_t(sPtr->x >> 6) - 64;
-                const int64_t u = int64_t(sPtr->y >> 6) - 512;
-                const int64_t y1 = int64_t(sPtr->z >> 6) - 64;
-                const int64_t v = int64_t(sPtr->w >> 6) - 512;
+                const int y0 = int(sPtr->x >> 6) - 64;
+                const int u = int(sPtr->y >> 6) - 512;
+                const int y1 = int(sPtr->z >> 6) - 64;
+                const int v = int(sPtr->w >> 6) - 512;
                 ++sPtr;
 
                 // See Y410
-                auto r = static_cast<int>((76533 * y0 + 104905 * v + 32768) >> 16);
-                auto g = static_cast<int>((76533 * y0 - 25747 * u - 53425 * v + 32768) >> 16);
-                auto b = static_cast<int>((76533 * y0 + 132590 * u + 32768) >> 16);
-
                 if (dPtr >= ePtr) break;
-                *(dPtr++) = XMVectorSet(float(std::min<int>(std::max<int>(r, 0), 1023)) / 1023.f,
-                    float(std::min<int>(std::max<int>(g, 0), 1023)) / 1023.f,
-                    float(std::min<int>(std::max<int>(b, 0), 1023)) / 1023.f,
-                    1.f);
-
-                r = static_cast<int>((76533 * y1 + 104905 * v + 32768) >> 16);
-                g = static_cast<int>((76533 * y1 - 25747 * u - 53425 * v + 32768) >> 16);
-                b = static_cast<int>((76533 * y1 + 132590 * u + 32768) >> 16);
+                *(dPtr++) = YUVToRGB10(y0, u, v, 1.f);
 
                 if (dPtr >= ePtr) break;
-                *(dPtr++) = XMVectorSet(float(std::min<int>(std::max<int>(r, 0), 1023)) / 1023.f,
-                    float(std::min<int>(std::max<int>(g, 0), 1023)) / 1023.f,
-                    float(std::min<int>(std::max<int>(b, 0), 1023)) / 1023.f,
-                    1.f);
+                *(dPtr++) = YUVToRGB10(y1, u, v, 1.f);
             }
             return true;
         }
@@ -1548,17 +2321,8 @@ _Use_decl_annotations_ bool DirectX::Internal::LoadScanline(
             for (size_t icount = 0; icount < (size - sizeof(XMUDECN4) + 1); icount += sizeof(XMUDECN4))
             {
                 if (dPtr >= ePtr) break;
-
-                XMVECTORF32 vResult = { { {
-                    FloatFrom7e3(sPtr->x),
-                    FloatFrom7e3(sPtr->y),
-                    FloatFrom7e3(sPtr->z),
-                    static_cast<float>(sPtr->v >> 30) / 3.0f
-                } } };
-
+                *(dPtr++) = DecodeFloat7e3A2(sPtr->v);
                 ++sPtr;
-
-                *(dPtr++) = vResult.v;
             }
             return true;
         }
@@ -1572,17 +2336,8 @@ _Use_decl_annotations_ bool DirectX::Internal::LoadScanline(
             for (size_t icount = 0; icount < (size - sizeof(XMUDECN4) + 1); icount += sizeof(XMUDECN4))
             {
                 if (dPtr >= ePtr) break;
-
-                XMVECTORF32 vResult = { { {
-                    FloatFrom6e4(sPtr->x),
-                    FloatFrom6e4(sPtr->y),
-                    FloatFrom6e4(sPtr->z),
-                    static_cast<float>(sPtr->v >> 30) / 3.0f
-                } } };
-
+                *(dPtr++) = DecodeFloat6e4A2(sPtr->v);
                 ++sPtr;
-
-                *(dPtr++) = vResult.v;
             }
             return true;
         }
@@ -1689,14 +2444,8 @@ bool DirectX::Internal::StoreScanline(
     case DXGI_FORMAT_R16G16B16A16_FLOAT:
         if (size >= sizeof(XMHALF4))
         {
-            XMHALF4* __restrict dPtr = static_cast<XMHALF4*>(pDestination);
-            for (size_t icount = 0; icount < (size - sizeof(XMHALF4) + 1); icount += sizeof(XMHALF4))
-            {
-                if (sPtr >= ePtr) break;
-                XMVECTOR v = *sPtr++;
-                v = XMVectorClamp(v, g_HalfMin, g_HalfMax);
-                XMStoreHalf4(dPtr++, v);
-            }
+            const size_t pixels = std::min<size_t>(count, size / sizeof(XMHALF4));
+            StoreHalfScanline(static_cast<HALF*>(pDestination), sPtr, pixels, 4);
             return true;
         }
         return false;
@@ -1754,7 +2503,7 @@ bool DirectX::Internal::StoreScanline(
         STORE_SCANLINE(XMUDEC4, XMStoreUDec4)
 
     case DXGI_FORMAT_R11G11B10_FLOAT:
-        STORE_SCANLINE(XMFLOAT3PK, XMStoreFloat3PK)
+        STORE_SCANLINE(XMFLOAT3PK, StoreFloat3PK)
 
     case DXGI_FORMAT_R8G8B8A8_UNORM:
     case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
@@ -1783,14 +2532,8 @@ bool DirectX::Internal::StoreScanline(
     case DXGI_FORMAT_R16G16_FLOAT:
         if (size >= sizeof(XMHALF2))
         {
-            XMHALF2* __restrict dPtr = static_cast<XMHALF2*>(pDestination);
-            for (size_t icount = 0; icount < (size - sizeof(XMHALF2) + 1); icount += sizeof(XMHALF2))
-            {
-                if (sPtr >= ePtr) break;
-                XMVECTOR v = *sPtr++;
-                v = XMVectorClamp(v, g_HalfMin, g_HalfMax);
-                XMStoreHalf2(dPtr++, v);
-            }
+            const size_t pixels = std::min<size_t>(count, size / sizeof(XMHALF2));
+            StoreHalfScanline(static_cast<HALF*>(pDestination), sPtr, pixels, 2);
             return true;
         }
         return false;
@@ -1882,14 +2625,8 @@ bool DirectX::Internal::StoreScanline(
     case DXGI_FORMAT_R16_FLOAT:
         if (size >= sizeof(HALF))
         {
-            HALF * __restrict dPtr = static_cast<HALF*>(pDestination);
-            for (size_t icount = 0; icount < (size - sizeof(HALF) + 1); icount += sizeof(HALF))
-            {
-                if (sPtr >= ePtr) break;
-                float v = XMVectorGetX(*sPtr++);
-                v = std::max<float>(std::min<float>(v, 65504.f), -65504.f);
-                *(dPtr++) = XMConvertFloatToHalf(v);
-            }
+            const size_t pixels = std::min<size_t>(count, size / sizeof(HALF));
+            StoreHalfScanline(static_cast<HALF*>(pDestination), sPtr, pixels, 1);
             return true;
         }
         return false;
@@ -2174,22 +2911,24 @@ bool DirectX::Internal::StoreScanline(
         if (size >= sizeof(XMUBYTEN4))
         {
             XMUBYTEN4 * __restrict dPtr = static_cast<XMUBYTEN4*>(pDestination);
-            for (size_t icount = 0; icount < (size - sizeof(XMUBYTEN4) + 1); icount += sizeof(XMUBYTEN4))
+            size_t icount = 0;
+        #if defined(_XM_SSE_INTRINSICS_) && !defined(_XM_NO_INTRINSICS_)
+            {
+                const size_t pixels = StoreAYUVRow(dPtr, sPtr, std::min<size_t>(size / sizeof(XMUBYTEN4), count));
+                sPtr += pixels;
+                dPtr += pixels;
+                icount = pixels * sizeof(XMUBYTEN4);
+            }
+        #endif
+            for (; icount < (size - sizeof(XMUBYTEN4) + 1); icount += sizeof(XMUBYTEN4))
             {
                 if (sPtr >= ePtr) break;
 
                 XMUBYTEN4 rgba;
                 XMStoreUByteN4(&rgba, *sPtr++);
 
-                // http://msdn.microsoft.com/en-us/library/windows/desktop/dd206750.aspx
-
-                // Y  =  0.2568R + 0.5041G + 0.1001B + 16
-                // Cb = -0.1482R - 0.2910G + 0.4392B + 128
-                // Cr =  0.4392R - 0.3678G - 0.0714B + 128
-
-                const int y = ((66 * rgba.x + 129 * rgba.y + 25 * rgba.z + 128) >> 8) + 16;
-                const int u = ((-38 * rgba.x - 74 * rgba.y + 112 * rgba.z + 128) >> 8) + 128;
-                const int v = ((112 * rgba.x - 94 * rgba.y - 18 * rgba.z + 128) >> 8) + 128;
+                int y, u, v;
+                RGBToYUV8(rgba.x, rgba.y, rgba.z, y, u, v);
 
                 dPtr->x = static_cast<uint8_t>(std::min<int>(std::max<int>(v, 0), 255));
                 dPtr->y = static_cast<uint8_t>(std::min<int>(std::max<int>(u, 0), 255));
@@ -2205,26 +2944,24 @@ bool DirectX::Internal::StoreScanline(
         if (size >= sizeof(XMUDECN4))
         {
             XMUDECN4 * __restrict dPtr = static_cast<XMUDECN4*>(pDestination);
-            for (size_t icount = 0; icount < (size - sizeof(XMUDECN4) + 1); icount += sizeof(XMUDECN4))
+            size_t icount = 0;
+        #if defined(_XM_SSE_INTRINSICS_) && !defined(_XM_NO_INTRINSICS_)
+            {
+                const size_t pixels = StoreY410Row(dPtr, sPtr, std::min<size_t>(size / sizeof(XMUDECN4), count));
+                sPtr += pixels;
+                dPtr += pixels;
+                icount = pixels * sizeof(XMUDECN4);
+            }
+        #endif
+            for (; icount < (size - sizeof(XMUDECN4) + 1); icount += sizeof(XMUDECN4))
             {
                 if (sPtr >= ePtr) break;
 
                 XMUDECN4 rgba;
                 XMStoreUDecN4(&rgba, *sPtr++);
 
-                // http://msdn.microsoft.com/en-us/library/windows/desktop/bb970578.aspx
-
-                // Y  =  0.2560R + 0.5027G + 0.0998B + 64
-                // Cb = -0.1478R - 0.2902G + 0.4379B + 512
-                // Cr =  0.4379R - 0.3667G - 0.0712B + 512
-
-                const int64_t r = rgba.x;
-                const int64_t g = rgba.y;
-                const int64_t b = rgba.z;
-
-                const int y = static_cast<int>((16780 * r + 32942 * g + 6544 * b + 32768) >> 16) + 64;
-                const int u = static_cast<int>((-9683 * r - 19017 * g + 28700 * b + 32768) >> 16) + 512;
-                const int v = static_cast<int>((28700 * r - 24033 * g - 4667 * b + 32768) >> 16) + 512;
+                int y, u, v;
+                RGBToYUV10(static_cast<int>(rgba.x), static_cast<int>(rgba.y), static_cast<int>(rgba.z), y, u, v);
 
                 dPtr->x = static_cast<uint32_t>(std::min<int>(std::max<int>(u, 0), 1023));
                 dPtr->y = static_cast<uint32_t>(std::min<int>(std::max<int>(y, 0), 1023));
@@ -2275,7 +3012,16 @@ bool DirectX::Internal::StoreScanline(
         if (size >= sizeof(XMUBYTEN4))
         {
             XMUBYTEN4 * __restrict dPtr = static_cast<XMUBYTEN4*>(pDestination);
-            for (size_t icount = 0; icount < (size - sizeof(XMUBYTEN4) + 1); icount += sizeof(XMUBYTEN4))
+            size_t icount = 0;
+        #if defined(_XM_SSE_INTRINSICS_) && !defined(_XM_NO_INTRINSICS_)
+            {
+                const size_t pixels = StoreYUY2Row(dPtr, sPtr, std::min<size_t>((size / sizeof(XMUBYTEN4)) * 2, count));
+                sPtr += pixels;
+                dPtr += pixels / 2;
+                icount = (pixels / 2) * sizeof(XMUBYTEN4);
+            }
+        #endif
+            for (; icount < (size - sizeof(XMUBYTEN4) + 1); icount += sizeof(XMUBYTEN4))
             {
                 if (sPtr >= ePtr) break;
 
@@ -2283,9 +3029,8 @@ bool DirectX::Internal::StoreScanline(
                 XMStoreUByteN4(&rgb1, *sPtr++);
 
                 // See AYUV
-                const int y0 = ((66 * rgb1.x + 129 * rgb1.y + 25 * rgb1.z + 128) >> 8) + 16;
-                const int u0 = ((-38 * rgb1.x - 74 * rgb1.y + 112 * rgb1.z + 128) >> 8) + 128;
-                const int v0 = ((112 * rgb1.x - 94 * rgb1.y - 18 * rgb1.z + 128) >> 8) + 128;
+                int y0, u0, v0;
+                RGBToYUV8(rgb1.x, rgb1.y, rgb1.z, y0, u0, v0);
 
                 XMUBYTEN4 rgb2 = {};
                 if (sPtr < ePtr)
@@ -2293,9 +3038,8 @@ bool DirectX::Internal::StoreScanline(
                     XMStoreUByteN4(&rgb2, *sPtr++);
                 }
 
-                const int y1 = ((66 * rgb2.x + 129 * rgb2.y + 25 * rgb2.z + 128) >> 8) + 16;
-                const int u1 = ((-38 * rgb2.x - 74 * rgb2.y + 112 * rgb2.z + 128) >> 8) + 128;
-                const int v1 = ((112 * rgb2.x - 94 * rgb2.y - 18 * rgb2.z + 128) >> 8) + 128;
+                int y1, u1, v1;
+                RGBToYUV8(rgb2.x, rgb2.y, rgb2.z, y1, u1, v1);
 
                 dPtr->x = static_cast<uint8_t>(std::min<int>(std::max<int>(y0, 0), 255));
                 dPtr->y = static_cast<uint8_t>(std::min<int>(std::max<int>((u0 + u1) >> 1, 0), 255));
@@ -2312,7 +3056,16 @@ bool DirectX::Internal::StoreScanline(
         if (size >= sizeof(XMUSHORTN4))
         {
             XMUSHORTN4 * __restrict dPtr = static_cast<XMUSHORTN4*>(pDestination);
-            for (size_t icount = 0; icount < (size - sizeof(XMUSHORTN4) + 1); icount += sizeof(XMUSHORTN4))
+            size_t icount = 0;
+        #if defined(_XM_SSE_INTRINSICS_) && !defined(_XM_NO_INTRINSICS_)
+            {
+                const size_t pixels = StoreY210Row(dPtr, sPtr, std::min<size_t>((size / sizeof(XMUSHORTN4)) * 2, count));
+                sPtr += pixels;
+                dPtr += pixels / 2;
+                icount = (pixels / 2) * sizeof(XMUSHORTN4);
+            }
+        #endif
+            for (; icount < (size - sizeof(XMUSHORTN4) + 1); icount += sizeof(XMUSHORTN4))
             {
                 if (sPtr >= ePtr) break;
 
@@ -2320,13 +3073,8 @@ bool DirectX::Internal::StoreScanline(
                 XMStoreUDecN4(&rgb1, *sPtr++);
 
                 // See Y410
-                int64_t r = rgb1.x;
-                int64_t g = rgb1.y;
-                int64_t b = rgb1.z;
-
-                const int y0 = static_cast<int>((16780 * r + 32942 * g + 6544 * b + 32768) >> 16) + 64;
-                const int u0 = static_cast<int>((-9683 * r - 19017 * g + 28700 * b + 32768) >> 16) + 512;
-                const int v0 = static_cast<int>((28700 * r - 24033 * g - 4667 * b + 32768) >> 16) + 512;
+                int y0, u0, v0;
+                RGBToYUV10(static_cast<int>(rgb1.x), static_cast<int>(rgb1.y), static_cast<int>(rgb1.z), y0, u0, v0);
 
                 XMUDECN4 rgb2 = {};
                 if (sPtr < ePtr)
@@ -2334,13 +3082,8 @@ bool DirectX::Internal::StoreScanline(
                     XMStoreUDecN4(&rgb2, *sPtr++);
                 }
 
-                r = rgb2.x;
-                g = rgb2.y;
-                b = rgb2.z;
-
-                const int y1 = static_cast<int>((16780 * r + 32942 * g + 6544 * b + 32768) >> 16) + 64;
-                const int u1 = static_cast<int>((-9683 * r - 19017 * g + 28700 * b + 32768) >> 16) + 512;
-                const int v1 = static_cast<int>((28700 * r - 24033 * g - 4667 * b + 32768) >> 16) + 512;
+                int y1, u1, v1;
+                RGBToYUV10(static_cast<int>(rgb2.x), static_cast<int>(rgb2.y), static_cast<int>(rgb2.z), y1, u1, v1);
 
                 dPtr->x = static_cast<uint16_t>(std::min<int>(std::max<int>(y0, 0), 1023) << 6);
                 dPtr->y = static_cast<uint16_t>(std::min<int>(std::max<int>((u0 + u1) >> 1, 0), 1023) << 6);
@@ -2451,13 +3194,7 @@ bool DirectX::Internal::StoreScanline(
                 XMVECTOR V = XMVectorMultiply(*sPtr++, Scale);
                 V = XMVectorClamp(V, g_XMZero, C);
 
-                XMFLOAT4A tmp;
-                XMStoreFloat4A(&tmp, V);
-
-                dPtr->x = FloatTo7e3(tmp.x);
-                dPtr->y = FloatTo7e3(tmp.y);
-                dPtr->z = FloatTo7e3(tmp.z);
-                dPtr->w = static_cast<uint32_t>(tmp.w);
+                dPtr->v = EncodeFloat7e3A2(V);
                 ++dPtr;
             }
             return true;
@@ -2479,13 +3216,7 @@ bool DirectX::Internal::StoreScanline(
                 XMVECTOR V = XMVectorMultiply(*sPtr++, Scale);
                 V = XMVectorClamp(V, g_XMZero, C);
 
-                XMFLOAT4A tmp;
-                XMStoreFloat4A(&tmp, V);
-
-                dPtr->x = FloatTo6e4(tmp.x);
-                dPtr->y = FloatTo6e4(tmp.y);
-                dPtr->z = FloatTo6e4(tmp.z);
-                dPtr->w = static_cast<uint32_t>(tmp.w);
+                dPtr->v = EncodeFloat6e4A2(V);
                 ++dPtr;
             }
             return true;
@@ -2714,7 +3445,7 @@ HRESULT DirectX::Internal::ConvertToR16G16B16A16(const Image& srcImage, ScratchI
     if (FAILED(hr))
         return hr;
 
-    auto scanline = make_AlignedArrayXMVECTOR(srcImage.width);
+    auto scanline = make_ScratchArrayXMVECTOR(srcImage.width);
     if (!scanline)
     {
         image.Release();
@@ -2767,7 +3498,7 @@ HRESULT DirectX::Internal::ConvertFromR16G16B16A16(const Image& srcImage, const
     if (srcImage.width != destImage.width || srcImage.height != destImage.height)
         return E_FAIL;
 
-    auto scanline = make_AlignedArrayXMVECTOR(srcImage.width);
+    auto scanline = make_ScratchArrayXMVECTOR(srcImage.width);
     if (!scanline)
         return E_OUTOFMEMORY;
 
@@ -4799,7 +5530,16 @@ namespace
     }
 
     //-------------------------------------------------------------------------------------
-    // Convert the source image (not using WIC)
+    // Number of XMVECTOR entries ConvertCustom needs for a row of the given width
+    //-------------------------------------------------------------------------------------
+    constexpr uint64_t GetConvertScanlineCount(TEX_FILTER_FLAGS filter, size_t width) noexcept
+    {
+        // Error diffusion also keeps the error terms for the next row
+        return (filter & TEX_FILTER_DITHER_DIFFUSION) ? (uint64_t(width) * 2 + 2) : uint64_t(width);
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Convert the source image (not using WIC) with a caller-provided scanline buffer
     //-------------------------------------------------------------------------------------
     HRESULT ConvertCustom(
         _In_ const Image& srcImage,
@@ -4807,10 +5547,12 @@ namespace
         _In_ const Image& destImage,
         _In_ float threshold,
         size_t z,
-        const std::function<bool __cdecl(size_t, size_t)>& statusCallback) noexcept
+        const std::function<bool __cdecl(size_t, size_t)>& statusCallback,
+        _Inout_ XMVECTOR* scanline) noexcept
     {
         assert(srcImage.width == destImage.width);
         assert(srcImage.height == destImage.height);
+        assert(scanline != nullptr);
 
         const uint8_t *pSrc = srcImage.pixels;
         uint8_t *pDest = destImage.pixels;
@@ -4822,11 +5564,7 @@ namespace
         if (filter & TEX_FILTER_DITHER_DIFFUSION)
         {
             // Error diffusion dithering (aka Floyd-Steinberg dithering)
-            auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 2 + 2);
-            if (!scanline)
-                return E_OUTOFMEMORY;
-
-            XMVECTOR* pDiffusionErrors = scanline.get() + width;
+            XMVECTOR* pDiffusionErrors = scanline + width;
             memset(pDiffusionErrors, 0, sizeof(XMVECTOR)*(width + 2));
 
             for (size_t h = 0; h < srcImage.height; ++h)
@@ -4839,12 +5577,12 @@ namespace
                     }
                 }
 
-                if (!LoadScanline(scanline.get(), width, pSrc, srcImage.rowPitch, srcImage.format))
+                if (!LoadScanline(scanline, width, pSrc, srcImage.rowPitch, srcImage.format))
                     return E_FAIL;
 
-                ConvertScanline(scanline.get(), width, destImage.format, srcImage.format, filter);
+                ConvertScanline(scanline, width, destImage.format, srcImage.format, filter);
 
-                if (!StoreScanlineDither(pDest, destImage.rowPitch, destImage.format, scanline.get(), width, threshold, h, z, pDiffusionErrors))
+                if (!StoreScanlineDither(pDest, destImage.rowPitch, destImage.format, scanline, width, threshold, h, z, pDiffusionErrors))
                     return E_FAIL;
 
                 pSrc += srcImage.rowPitch;
@@ -4853,10 +5591,6 @@ namespace
         }
         else
         {
-            auto scanline = make_AlignedArrayXMVECTOR(width);
-            if (!scanline)
-                return E_OUTOFMEMORY;
-
             if (filter & TEX_FILTER_DITHER)
             {
                 // Ordered dithering
@@ -4870,12 +5604,12 @@ namespace
                         }
                     }
 
-                    if (!LoadScanline(scanline.get(), width, pSrc, srcImage.rowPitch, srcImage.format))
+                    if (!LoadScanline(scanline, width, pSrc, srcImage.rowPitch, srcImage.format))
                         return E_FAIL;
 
-                    ConvertScanline(scanline.get(), width, destImage.format, srcImage.format, filter);
+                    ConvertScanline(scanline, width, destImage.format, srcImage.format, filter);
 
-                    if (!StoreScanlineDither(pDest, destImage.rowPitch, destImage.format, scanline.get(), width, threshold, h, z, nullptr))
+                    if (!StoreScanlineDither(pDest, destImage.rowPitch, destImage.format, scanline, width, threshold, h, z, nullptr))
                         return E_FAIL;
 
                     pSrc += srcImage.rowPitch;
@@ -4895,12 +5629,12 @@ namespace
                         }
                     }
 
-                    if (!LoadScanline(scanline.get(), width, pSrc, srcImage.rowPitch, srcImage.format))
+                    if (!LoadScanline(scanline, width, pSrc, srcImage.rowPitch, srcImage.format))
                         return E_FAIL;
 
-                    ConvertScanline(scanline.get(), width, destImage.format, srcImage.format, filter);
+                    ConvertScanline(scanline, width, destImage.format, srcImage.format, filter);
 
-                    if (!StoreScanline(pDest, destImage.rowPitch, destImage.format, scanline.get(), width, threshold))
+                    if (!StoreScanline(pDest, destImage.rowPitch, destImage.format, scanline, width, threshold))
                         return E_FAIL;
 
                     pSrc += srcImage.rowPitch;
@@ -4912,6 +5646,21 @@ namespace
         return S_OK;
     }
 
+    HRESULT ConvertCustom(
+        _In_ const Image& srcImage,
+        _In_ TEX_FILTER_FLAGS filter,
+        _In_ const Image& destImage,
+        _In_ float threshold,
+        size_t z,
+        const std::function<bool __cdecl(size_t, size_t)>& statusCallback) noexcept
+    {
+        auto scanline = make_ScratchArrayXMVECTOR(GetConvertScanlineCount(filter, srcImage.width));
+        if (!scanline)
+            return E_OUTOFMEMORY;
+
+        return ConvertCustom(srcImage, filter, destImage, threshold, z, statusCallback, scanline.get());
+    }
+
     //-------------------------------------------------------------------------------------
     DXGI_FORMAT PlanarToSingle(_In_ DXGI_FORMAT format) noexcept
     {
@@ -4938,10 +5687,63 @@ namespace
         }
     }
 
+    //-------------------------------------------------------------------------------------
+    // Interleaves a row of luma with a row of Cb,Cr pairs into packed 4:2:2 (Y0 Cb Y1 Cr)
+    //-------------------------------------------------------------------------------------
+    void Interleave422(
+        _Out_writes_(pairs * 4) uint8_t* __restrict pDestination,
+        _In_reads_(pairs * 2) const uint8_t* pLuma,
+        _In_reads_(pairs * 2) const uint8_t* pChroma,
+        size_t pairs) noexcept
+    {
+        size_t i = 0;
+    #if defined(_XM_SSE_INTRINSICS_) && !defined(_XM_NO_INTRINSICS_)
+        for (; (i + 8) <= pairs; i += 8)
+        {
+            const __m128i luma = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pLuma + i * 2));
+            const __m128i chroma = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pChroma + i * 2));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pDestination + i * 4), _mm_unpacklo_epi8(luma, chroma));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pDestination + i * 4 + 16), _mm_unpackhi_epi8(luma, chroma));
+        }
+    #endif
+        for (; i < pairs; ++i)
+        {
+            pDestination[i * 4] = pLuma[i * 2];
+            pDestination[i * 4 + 1] = pChroma[i * 2];
+            pDestination[i * 4 + 2] = pLuma[i * 2 + 1];
+            pDestination[i * 4 + 3] = pChroma[i * 2 + 1];
+        }
+    }
+
+    void Interleave422(
+        _Out_writes_(pairs * 4) uint16_t* __restrict pDestination,
+        _In_reads_(pairs * 2) const uint16_t* pLuma,
+        _In_reads_(pairs * 2) const uint16_t* pChroma,
+        size_t pairs) noexcept
+    {
+        size_t i = 0;
+    #if defined(_XM_SSE_INTRINSICS_) && !defined(_XM_NO_INTRINSICS_)
+        for (; (i + 4) <= pairs; i += 4)
+        {
+            const __m128i luma = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pLuma + i * 2));
+            const __m128i chroma = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pChroma + i * 2));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pDestination + i * 4), _mm_unpacklo_epi16(luma, chroma));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pDestination + i * 4 + 8), _mm_unpackhi_epi16(luma, chroma));
+        }
+    #endif
+        for (; i < pairs; ++i)
+        {
+            pDestination[i * 4] = pLuma[i * 2];
+            pDestination[i * 4 + 1] = pChroma[i * 2];
+            pDestination[i * 4 + 2] = pLuma[i * 2 + 1];
+            pDestination[i * 4 + 3] = pChroma[i * 2 + 1];
+        }
+    }
+
     //-------------------------------------------------------------------------------------
     // Convert the image from a planar to non-planar image
     //-------------------------------------------------------------------------------------
-#define CONVERT_420_TO_422( srcType, destType )\
+#define CONVERT_420_TO_422( srcType )\
         {\
             const size_t rowPitch = srcImage.rowPitch;\
             \
@@ -4950,32 +5752,14 @@ namespace
             \
             for(size_t y = 0; y < srcImage.height; y+= 2)\
             {\
-                auto sPtrY0 = reinterpret_cast<const srcType*>(pSrc);\
-                auto sPtrY2 = reinterpret_cast<const srcType*>(pSrc + rowPitch);\
                 auto sPtrUV = reinterpret_cast<const srcType*>(pSrcUV);\
+                const size_t pairs = (sPtrUV < sourceE)\
+                    ? std::min<size_t>(srcImage.width >> 1, static_cast<size_t>(sourceE - sPtrUV) >> 1) : 0;\
                 \
-                destType * __restrict dPtr0 = reinterpret_cast<destType*>(pDest);\
-                destType * __restrict dPtr1 = reinterpret_cast<destType*>(pDest + destImage.rowPitch);\
-                \
-                for(size_t x = 0; x < srcImage.width; x+= 2)\
-                {\
-                    if ((sPtrUV+1) >= sourceE) break;\
-                    \
-                    const srcType u = *(sPtrUV++);\
-                    const srcType v = *(sPtrUV++);\
-                    \
-                    dPtr0->x = *(sPtrY0++);\
-                    dPtr0->y = u;\
-                    dPtr0->z = *(sPtrY0++);\
-                    dPtr0->w = v;\
-                    ++dPtr0;\
-                    \
-                    dPtr1->x = *(sPtrY2++);\
-                    dPtr1->y = u;\
-                    dPtr1->z = *(sPtrY2++);\
-                    dPtr1->w = v;\
-                    ++dPtr1;\
-                }\
+                Interleave422(reinterpret_cast<srcType*>(pDest),\
+                    reinterpret_cast<const srcType*>(pSrc), sPtrUV, pairs);\
+                Interleave422(reinterpret_cast<srcType*>(pDest + destImage.rowPitch),\
+                    reinterpret_cast<const srcType*>(pSrc + rowPitch), sPtrUV, pairs);\
                 \
                 pSrc += rowPitch * 2;\
                 pSrcUV += rowPitch;\
@@ -5005,7 +5789,7 @@ namespace
             if ((srcImage.width % 2) != 0 || (srcImage.height % 2) != 0)
                 return E_INVALIDARG;
 
-            CONVERT_420_TO_422(uint8_t, XMUBYTEN4);
+            CONVERT_420_TO_422(uint8_t);
             return S_OK;
 
         case DXGI_FORMAT_P010:
@@ -5013,7 +5797,7 @@ namespace
             if ((srcImage.width % 2) != 0 || (srcImage.height % 2) != 0)
                 return E_INVALIDARG;
 
-            CONVERT_420_TO_422(uint16_t, XMUSHORTN4);
+            CONVERT_420_TO_422(uint16_t);
             return S_OK;
 
         case DXGI_FORMAT_P016:
@@ -5021,7 +5805,7 @@ namespace
             if ((srcImage.width % 2) != 0 || (srcImage.height % 2) != 0)
                 return E_INVALIDARG;
 
-            CONVERT_420_TO_422(uint16_t, XMUSHORTN4);
+            CONVERT_420_TO_422(uint16_t);
             return S_OK;
 
         case DXGI_FORMAT_NV11:
@@ -5404,6 +6188,248 @@ HRESULT DirectX::ConvertEx(
 }
 
 
+//-------------------------------------------------------------------------------------
+// Conversion plan
+//-------------------------------------------------------------------------------------
+namespace
+{
+    HRESULT ValidatePlanImages(
+        _In_ const Image& srcImage,
+        _In_ const Image& destImage,
+        _In_ DXGI_FORMAT srcFormat,
+        _In_ DXGI_FORMAT destFormat) noexcept
+    {
+        if (srcImage.format != srcFormat || destImage.format != destFormat)
+            return E_INVALIDARG;
+
+        if (srcImage.width != destImage.width || srcImage.height != destImage.height)
+            return E_INVALIDARG;
+
+        if ((srcImage.width > UINT32_MAX) || (srcImage.height > UINT32_MAX))
+            return E_INVALIDARG;
+
+        if (!srcImage.pixels || !destImage.pixels)
+            return E_POINTER;
+
+        return S_OK;
+    }
+}
+
+ConvertPlan& ConvertPlan::operator= (ConvertPlan&& moveFrom) noexcept
+{
+    if (this != &moveFrom)
+    {
+        Release();
+
+        m_srcFormat = moveFrom.m_srcFormat;
+        m_destFormat = moveFrom.m_destFormat;
+        m_options = moveFrom.m_options;
+        m_usewic = moveFrom.m_usewic;
+        m_pfGUID = moveFrom.m_pfGUID;
+        m_targetGUID = moveFrom.m_targetGUID;
+        m_scanline = moveFrom.m_scanline;
+        m_scanlineCount = moveFrom.m_scanlineCount;
+
+        moveFrom.m_srcFormat = DXGI_FORMAT_UNKNOWN;
+        moveFrom.m_destFormat = DXGI_FORMAT_UNKNOWN;
+        moveFrom.m_scanline = nullptr;
+        moveFrom.m_scanlineCount = 0;
+    }
+    return *this;
+}
+
+_Use_decl_annotations_
+HRESULT ConvertPlan::Initialize(DXGI_FORMAT srcFormat, DXGI_FORMAT destFormat, const ConvertOptions& options) noexcept
+{
+    Release();
+
+    if ((srcFormat == destFormat)
+        || !IsValid(destFormat)
+        || !IsValid(srcFormat))
+        return E_INVALIDARG;
+
+    if (IsCompressed(srcFormat) || IsCompressed(destFormat)
+        || IsPlanar(srcFormat) || IsPlanar(destFormat)
+        || IsPalettized(srcFormat) || IsPalettized(destFormat)
+        || IsTypeless(srcFormat) || IsTypeless(destFormat))
+        return HRESULT_E_NOT_SUPPORTED;
+
+    m_usewic = UseWICConversion(options.filter, srcFormat, destFormat, m_pfGUID, m_targetGUID);
+    m_srcFormat = srcFormat;
+    m_destFormat = destFormat;
+    m_options = options;
+
+    return S_OK;
+}
+
+void ConvertPlan::Release() noexcept
+{
+    m_srcFormat = DXGI_FORMAT_UNKNOWN;
+    m_destFormat = DXGI_FORMAT_UNKNOWN;
+    m_options = {};
+    m_usewic = false;
+    memset(&m_pfGUID, 0, sizeof(GUID));
+    memset(&m_targetGUID, 0, sizeof(GUID));
+
+    if (m_scanline)
+    {
+        aligned_deleter()(m_scanline);
+        m_scanline = nullptr;
+    }
+    m_scanlineCount = 0;
+}
+
+_Use_decl_annotations_
+HRESULT ConvertPlan::Execute(const Image& srcImage, const Image& destImage) noexcept
+{
+    if (m_srcFormat == DXGI_FORMAT_UNKNOWN)
+        return E_UNEXPECTED;
+
+    HRESULT hr = ValidatePlanImages(srcImage, destImage, m_srcFormat, m_destFormat);
+    if (FAILED(hr))
+        return hr;
+
+    if (m_usewic)
+    {
+        return ConvertUsingWIC(srcImage, m_pfGUID, m_targetGUID, m_options.filter, m_options.threshold, destImage);
+    }
+
+    const uint64_t count = GetConvertScanlineCount(m_options.filter, srcImage.width);
+    if (count > m_scanlineCount)
+    {
+        auto scanline = make_AlignedArrayXMVECTOR(count);
+        if (!scanline)
+            return E_OUTOFMEMORY;
+
+        if (m_scanline)
+        {
+            aligned_deleter()(m_scanline);
+        }
+        m_scanline = scanline.release();
+        m_scanlineCount = static_cast<size_t>(count);
+    }
+
+    return ConvertCustom(srcImage, m_options.filter, destImage, m_options.threshold, 0, nullptr, static_cast<XMVECTOR*>(m_scanline));
+}
+
+_Use_decl_annotations_
+HRESULT ConvertPlan::Execute(const Image& srcImage, ScratchImage& image) noexcept
+{
+    if (m_srcFormat == DXGI_FORMAT_UNKNOWN)
+        return E_UNEXPECTED;
+
+    HRESULT hr = image.Initialize2D(m_destFormat, srcImage.width, srcImage.height, 1, 1);
+    if (FAILED(hr))
+        return hr;
+
+    const Image *rimage = image.GetImage(0, 0, 0);
+    if (!rimage)
+    {
+        image.Release();
+        return E_POINTER;
+    }
+
+    hr = Execute(srcImage, *rimage);
+    if (FAILED(hr))
+    {
+        image.Release();
+        return hr;
+    }
+
+    return S_OK;
+}
+
+_Use_decl_annotations_
+HRESULT ConvertPlan::ExecuteBatch(const Image* srcImages, const Image* destImages, size_t nimages) const noexcept
+{
+    if (!srcImages || !destImages || !nimages)
+        return E_INVALIDARG;
+
+    if (m_srcFormat == DXGI_FORMAT_UNKNOWN)
+        return E_UNEXPECTED;
+
+    // Validate everything up front so the conversion loop has a single failure mode
+    uint64_t count = 0;
+    for (size_t index = 0; index < nimages; ++index)
+    {
+        HRESULT hr = ValidatePlanImages(srcImages[index], destImages[index], m_srcFormat, m_destFormat);
+        if (FAILED(hr))
+            return hr;
+
+        count = std::max<uint64_t>(count, GetConvertScanlineCount(m_options.filter, srcImages[index].width));
+    }
+
+#ifdef _OPENMP
+    // WIC needs COM initialized on the thread that uses it, which OpenMP worker threads
+    // never do, so WIC conversions stay on the calling thread
+    if (!m_usewic && (m_options.filter & TEX_FILTER_PARALLEL))
+    {
+        if (nimages > INT32_MAX)
+            return HRESULT_E_ARITHMETIC_OVERFLOW;
+
+        HRESULT result = S_OK;
+        bool fail = false;
+
+    #pragma omp parallel shared(result, fail)
+        {
+            // One scanline buffer per thread for the whole batch
+            auto scanline = make_ScratchArrayXMVECTOR(count);
+
+        #pragma omp for schedule(dynamic)
+            for (int index = 0; index < static_cast<int>(nimages); ++index)
+            {
+            #pragma omp flush (fail)
+                if (fail)
+                {
+                    // Short circuit the loop body if a failure has occurred.
+                    // OpenMP 2.0 does not support cancellation of a 'parallel for' loop.
+                    continue;
+                }
+
+                const HRESULT hr = (scanline)
+                    ? ConvertCustom(srcImages[index], m_options.filter, destImages[index], m_options.threshold, 0, nullptr, scanline.get())
+                    : E_OUTOFMEMORY;
+                if (FAILED(hr))
+                {
+                #pragma omp critical
+                    {
+                        if (SUCCEEDED(result))
+                            result = hr;
+                    }
+                    fail = true;
+                #pragma omp flush (fail)
+                }
+            }
+        }
+
+        return result;
+    }
+#endif
+
+    auto scanline = make_ScratchArrayXMVECTOR(m_usewic ? 0 : count);
+    if (!m_usewic && !scanline)
+        return E_OUTOFMEMORY;
+
+    for (size_t index = 0; index < nimages; ++index)
+    {
+        HRESULT hr;
+        if (m_usewic)
+        {
+            hr = ConvertUsingWIC(srcImages[index], m_pfGUID, m_targetGUID, m_options.filter, m_options.threshold, destImages[index]);
+        }
+        else
+        {
+            hr = ConvertCustom(srcImages[index], m_options.filter, destImages[index], m_options.threshold, 0, nullptr, scanline.get());
+        }
+
+        if (FAILED(hr))
+            return hr;
+    }
+
+    return S_OK;
+}
+
+
 //-------------------------------------------------------------------------------------
 // Convert image from planar to single plane (image)
 //-------------------------------------------------------------------------------------
@@ -11,12 +11,20 @@
 
 #include "DirectXTexP.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#pragma warning(disable : 4616 6993)
+#endif
+
+#include "BC.h"
+
 using namespace DirectX;
 using namespace DirectX::Internal;
 using Microsoft::WRL::ComPtr;
 
 namespace
 {
+#ifdef _WIN32
     //-------------------------------------------------------------------------------------
     // Do flip/rotate operation using WIC
     //-------------------------------------------------------------------------------------
@@ -52,7 +60,8 @@ namespace
         if (FAILED(hr))
             return hr;
 
-        hr = FR->Initialize(source.Get(), static_cast<WICBitmapTransformOptions>(flags));
+        hr = FR->Initialize(source.Get(),
+            static_cast<WICBitmapTransformOptions>(flags & (TEX_FR_ROTATE270 | TEX_FR_FLIP_HORIZONTAL | TEX_FR_FLIP_VERTICAL)));
         if (FAILED(hr))
             return hr;
 
@@ -81,15 +90,214 @@ namespace
 
         return S_OK;
     }
+#endif // WIN32
 
 
     //-------------------------------------------------------------------------------------
-    // Do conversion, flip/rotate using WIC, conversion cycle
+    // Flip/rotate without WIC
     //
-    // For large images we have to use F16 instead of F32 to avoid exceeding the 32-bit
-    // memory limitations of WIC.
+    // Each destination row is a straight walk over the source: along a source row for
+    // flips and 180 rotation, or down a source column for 90/270 rotation. Flips apply
+    // after the rotation, matching WICBitmapTransformOptions.
+    //-------------------------------------------------------------------------------------
+    struct FlipRotateWalk
+    {
+        size_t      x;      // Source pixel for the first destination pixel of the row
+        size_t      y;
+        ptrdiff_t   dx;     // Source step per destination pixel
+        ptrdiff_t   dy;
+    };
+
+    FlipRotateWalk GetFlipRotateWalk(
+        TEX_FR_FLAGS flags,
+        const Image& srcImage,
+        const Image& destImage,
+        size_t destY) noexcept
+    {
+        const size_t ry = (flags & TEX_FR_FLIP_VERTICAL) ? (destImage.height - destY - 1) : destY;
+        const bool flipx = (flags & TEX_FR_FLIP_HORIZONTAL) != 0;
+        const size_t rx0 = flipx ? (destImage.width - 1) : 0;
+        const ptrdiff_t drx = flipx ? -1 : 1;
+
+        switch (flags & (TEX_FR_ROTATE0 | TEX_FR_ROTATE90 | TEX_FR_ROTATE180 | TEX_FR_ROTATE270))
+        {
+        case TEX_FR_ROTATE90:
+            return { ry, srcImage.height - rx0 - 1, 0, -drx };
+
+        case TEX_FR_ROTATE180:
+            return { srcImage.width - rx0 - 1, srcImage.height - ry - 1, -drx, 0 };
+
+        case TEX_FR_ROTATE270:
+            return { srcImage.width - ry - 1, rx0, 0, drx };
+
+        default:
+            return { rx0, ry, drx, 0 };
+        }
+    }
+
+    // step may be negative, so the walk is kept as a signed offset from pSrc and a pointer is
+    // only formed for texels that are read (never one step before the start of a row or image)
+    template<size_t bytesPerPixel>
+    void GatherPixels(
+        _Out_writes_bytes_(count * bytesPerPixel) uint8_t* pDest,
+        _In_ const uint8_t* pSrc,
+        ptrdiff_t step,
+        size_t count) noexcept
+    {
+        ptrdiff_t offset = 0;
+        for (size_t i = 0; i < count; ++i, offset += step)
+        {
+            memcpy(pDest + i * bytesPerPixel, pSrc + offset, bytesPerPixel);
+        }
+    }
+
+    //-------------------------------------------------------------------------------------
+    // 90/270 rotation is a transpose: each destination row walks down a source column.
+    // The destination is processed in square tiles so the source rows a tile reads stay
+    // in cache, and within a tile small blocks of texels are transposed in registers.
     //-------------------------------------------------------------------------------------
-    HRESULT PerformFlipRotateViaF16(
+    constexpr size_t c_TransposeTileBytes = 128;
+
+    // pSrc is the source texel for destination (x, y); stepX steps to the source texel
+    // for (x + 1, y) and stepY to the one for (x, y + 1)
+    template<size_t bytesPerPixel>
+    struct TransposeBlock
+    {
+        static constexpr size_t size = 1;
+
+        static void Copy(uint8_t* pDest, size_t, const uint8_t* pSrc, ptrdiff_t, ptrdiff_t) noexcept
+        {
+            memcpy(pDest, pSrc, bytesPerPixel);
+        }
+    };
+
+#if defined(_XM_SSE_INTRINSICS_) && !defined(_XM_NO_INTRINSICS_)
+    template<>
+    struct TransposeBlock<4>
+    {
+        static constexpr size_t size = 4;
+
+        static void Copy(uint8_t* pDest, size_t destPitch, const uint8_t* pSrc, ptrdiff_t stepX, ptrdiff_t stepY) noexcept
+        {
+            // The four texels for a destination column are adjacent in one source row
+            const uint8_t* pBase = (stepY > 0) ? pSrc : (pSrc + 3 * stepY);
+
+            __m128 r0 = _mm_loadu_ps(reinterpret_cast<const float*>(pBase));
+            __m128 r1 = _mm_loadu_ps(reinterpret_cast<const float*>(pBase + stepX));
+            __m128 r2 = _mm_loadu_ps(reinterpret_cast<const float*>(pBase + 2 * stepX));
+            __m128 r3 = _mm_loadu_ps(reinterpret_cast<const float*>(pBase + 3 * stepX));
+
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+            if (stepY < 0)
+            {
+                std::swap(r0, r3);
+                std::swap(r1, r2);
+            }
+
+            _mm_storeu_ps(reinterpret_cast<float*>(pDest), r0);
+            _mm_storeu_ps(reinterpret_cast<float*>(pDest + destPitch), r1);
+            _mm_storeu_ps(reinterpret_cast<float*>(pDest + 2 * destPitch), r2);
+            _mm_storeu_ps(reinterpret_cast<float*>(pDest + 3 * destPitch), r3);
+        }
+    };
+
+    template<>
+    struct TransposeBlock<8>
+    {
+        static constexpr size_t size = 2;
+
+        static void Copy(uint8_t* pDest, size_t destPitch, const uint8_t* pSrc, ptrdiff_t stepX, ptrdiff_t stepY) noexcept
+        {
+            const uint8_t* pBase = (stepY > 0) ? pSrc : (pSrc + stepY);
+
+            const __m128i r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pBase));
+            const __m128i r1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pBase + stepX));
+
+            const __m128i lo = _mm_unpacklo_epi64(r0, r1);
+            const __m128i hi = _mm_unpackhi_epi64(r0, r1);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pDest), (stepY > 0) ? lo : hi);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pDest + destPitch), (stepY > 0) ? hi : lo);
+        }
+    };
+#endif
+
+    template<size_t bytesPerPixel>
+    void TransposePixels(
+        const Image& srcImage,
+        TEX_FR_FLAGS flags,
+        const Image& destImage) noexcept
+    {
+        constexpr size_t tile = std::max<size_t>(4, c_TransposeTileBytes / bytesPerPixel);
+        constexpr size_t block = TransposeBlock<bytesPerPixel>::size;
+        static_assert((tile % block) == 0, "Transpose tiles must hold whole blocks");
+
+        for (size_t ty = 0; ty < destImage.height; ty += tile)
+        {
+            const size_t tileHeight = std::min(tile, destImage.height - ty);
+
+            for (size_t tx = 0; tx < destImage.width; tx += tile)
+            {
+                const size_t tileWidth = std::min(tile, destImage.width - tx);
+
+                size_t y = ty;
+                while (y < ty + tileHeight)
+                {
+                    const FlipRotateWalk walk = GetFlipRotateWalk(flags, srcImage, destImage, y);
+                    assert(walk.dx == 0);
+
+                    const ptrdiff_t stepX = walk.dy * static_cast<ptrdiff_t>(srcImage.rowPitch);
+                    const uint8_t* pSrc = srcImage.pixels + walk.y * srcImage.rowPitch + walk.x * bytesPerPixel
+                        + static_cast<ptrdiff_t>(tx) * stepX;
+                    uint8_t* pDest = destImage.pixels + y * destImage.rowPitch + tx * bytesPerPixel;
+
+                    const size_t rows = (y + block <= ty + tileHeight) ? block : 1;
+                    if (rows > 1)
+                    {
+                        const FlipRotateWalk next = GetFlipRotateWalk(flags, srcImage, destImage, y + 1);
+                        const ptrdiff_t stepY = (static_cast<ptrdiff_t>(next.x) - static_cast<ptrdiff_t>(walk.x))
+                            * static_cast<ptrdiff_t>(bytesPerPixel);
+
+                        size_t x = 0;
+                        for (; x + block <= tileWidth; x += block)
+                        {
+                            TransposeBlock<bytesPerPixel>::Copy(pDest + x * bytesPerPixel, destImage.rowPitch,
+                                pSrc + static_cast<ptrdiff_t>(x) * stepX, stepX, stepY);
+                        }
+
+                        if (x < tileWidth)
+                        {
+                            for (size_t j = 0; j < rows; ++j)
+                            {
+                                GatherPixels<bytesPerPixel>(pDest + j * destImage.rowPitch + x * bytesPerPixel,
+                                    pSrc + static_cast<ptrdiff_t>(j) * stepY + static_cast<ptrdiff_t>(x) * stepX,
+                                    stepX, tileWidth - x);
+                            }
+                        }
+                    }
+                    else
+                    {
+                        GatherPixels<bytesPerPixel>(pDest, pSrc, stepX, tileWidth);
+                    }
+
+                    y += rows;
+                }
+            }
+        }
+    }
+
+    //--- Formats with whole-byte pixels are flipped/rotated by copying texels as-is ---
+    bool IsFlipRotateRawFormat(DXGI_FORMAT format) noexcept
+    {
+        if (IsCompressed(format) || IsPacked(format) || IsPlanar(format))
+            return false;
+
+        const size_t bpp = BitsPerPixel(format);
+        return (bpp >= 8) && !(bpp & 7);
+    }
+
+    HRESULT PerformFlipRotateRaw(
         const Image& srcImage,
         TEX_FR_FLAGS flags,
         const Image& destImage) noexcept
@@ -97,41 +305,398 @@ namespace
         if (!srcImage.pixels || !destImage.pixels)
             return E_POINTER;
 
-        assert(srcImage.format != DXGI_FORMAT_R16G16B16A16_FLOAT);
         assert(srcImage.format == destImage.format);
 
-        ScratchImage temp;
-        HRESULT hr = ConvertToR16G16B16A16(srcImage, temp);
-        if (FAILED(hr))
-            return hr;
+        const size_t bytesPerPixel = BitsPerPixel(srcImage.format) / 8;
+        const size_t rowBytes = destImage.width * bytesPerPixel;
 
-        const Image *tsrc = temp.GetImage(0, 0, 0);
-        if (!tsrc)
+        const size_t rotateMode = static_cast<size_t>(flags & (TEX_FR_ROTATE90 | TEX_FR_ROTATE270));
+        if (rotateMode == TEX_FR_ROTATE90 || rotateMode == TEX_FR_ROTATE270)
+        {
+            switch (bytesPerPixel)
+            {
+            case 1:  TransposePixels<1>(srcImage, flags, destImage); return S_OK;
+            case 2:  TransposePixels<2>(srcImage, flags, destImage); return S_OK;
+            case 4:  TransposePixels<4>(srcImage, flags, destImage); return S_OK;
+            case 8:  TransposePixels<8>(srcImage, flags, destImage); return S_OK;
+            case 12: TransposePixels<12>(srcImage, flags, destImage); return S_OK;
+            case 16: TransposePixels<16>(srcImage, flags, destImage); return S_OK;
+            default: break;
+            }
+        }
+
+        uint8_t* pDest = destImage.pixels;
+        for (size_t y = 0; y < destImage.height; ++y, pDest += destImage.rowPitch)
+        {
+            const FlipRotateWalk walk = GetFlipRotateWalk(flags, srcImage, destImage, y);
+
+            const uint8_t* pSrc = srcImage.pixels + walk.y * srcImage.rowPitch + walk.x * bytesPerPixel;
+            const ptrdiff_t step = walk.dy * static_cast<ptrdiff_t>(srcImage.rowPitch)
+                + walk.dx * static_cast<ptrdiff_t>(bytesPerPixel);
+
+            if (step == static_cast<ptrdiff_t>(bytesPerPixel))
+            {
+                memcpy(pDest, pSrc, rowBytes);
+                continue;
+            }
+
+            switch (bytesPerPixel)
+            {
+            case 1:  GatherPixels<1>(pDest, pSrc, step, destImage.width); break;
+            case 2:  GatherPixels<2>(pDest, pSrc, step, destImage.width); break;
+            case 4:  GatherPixels<4>(pDest, pSrc, step, destImage.width); break;
+            case 8:  GatherPixels<8>(pDest, pSrc, step, destImage.width); break;
+            case 12: GatherPixels<12>(pDest, pSrc, step, destImage.width); break;
+            case 16: GatherPixels<16>(pDest, pSrc, step, destImage.width); break;
+
+            default:
+                {
+                    ptrdiff_t offset = 0;
+                    for (size_t x = 0; x < destImage.width; ++x, offset += step)
+                    {
+                        memcpy(pDest + x * bytesPerPixel, pSrc + offset, bytesPerPixel);
+                    }
+                }
+                break;
+            }
+        }
+
+        return S_OK;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Formats without whole-byte pixels (packed 4:2:2, 1-bit) go through float scanlines.
+    // Rows that come from source columns are gathered a band at a time, decoding each
+    // source row once per band, so memory stays bounded by the band size.
+    //-------------------------------------------------------------------------------------
+    constexpr size_t c_FlipRotateBandBytes = 16 * 1024 * 1024;
+
+    HRESULT PerformFlipRotateViaScanlines(
+        const Image& srcImage,
+        TEX_FR_FLAGS flags,
+        const Image& destImage) noexcept
+    {
+        if (!srcImage.pixels || !destImage.pixels)
             return E_POINTER;
 
-        ScratchImage rtemp;
-        hr = rtemp.Initialize2D(DXGI_FORMAT_R16G16B16A16_FLOAT, destImage.width, destImage.height, 1, 1);
-        if (FAILED(hr))
-            return hr;
+        assert(srcImage.format == destImage.format);
 
-        const Image *tdest = rtemp.GetImage(0, 0, 0);
-        if (!tdest)
+        const size_t rotateMode = static_cast<size_t>(flags & (TEX_FR_ROTATE90 | TEX_FR_ROTATE270));
+        if (rotateMode != TEX_FR_ROTATE90 && rotateMode != TEX_FR_ROTATE270)
+        {
+            auto scanline = make_ScratchArrayXMVECTOR(srcImage.width);
+            if (!scanline)
+                return E_OUTOFMEMORY;
+
+            XMVECTOR* row = scanline.get();
+
+            uint8_t* pDest = destImage.pixels;
+            for (size_t y = 0; y < destImage.height; ++y, pDest += destImage.rowPitch)
+            {
+                const FlipRotateWalk walk = GetFlipRotateWalk(flags, srcImage, destImage, y);
+
+                if (!LoadScanline(row, srcImage.width, srcImage.pixels + walk.y * srcImage.rowPitch, srcImage.rowPitch, srcImage.format))
+                    return E_FAIL;
+
+                if (walk.dx < 0)
+                {
+                    std::reverse(row, row + srcImage.width);
+                }
+
+                if (!StoreScanline(pDest, destImage.rowPitch, destImage.format, row, destImage.width))
+                    return E_FAIL;
+            }
+
+            return S_OK;
+        }
+
+        const size_t bandHeight = std::max<size_t>(1,
+            std::min<size_t>(destImage.height, c_FlipRotateBandBytes / (destImage.width * sizeof(XMVECTOR))));
+
+        auto scanline = make_ScratchArrayXMVECTOR(uint64_t(srcImage.width) + uint64_t(destImage.width) * bandHeight);
+        if (!scanline)
+            return E_OUTOFMEMORY;
+
+        XMVECTOR* row = scanline.get();
+        XMVECTOR* band = row + srcImage.width;
+
+        uint8_t* pDest = destImage.pixels;
+        for (size_t y0 = 0; y0 < destImage.height; y0 += bandHeight)
+        {
+            const size_t rows = std::min(bandHeight, destImage.height - y0);
+
+            // Every row of a band walks the source rows in the same direction, from adjacent source columns
+            const FlipRotateWalk first = GetFlipRotateWalk(flags, srcImage, destImage, y0);
+            const FlipRotateWalk last = GetFlipRotateWalk(flags, srcImage, destImage, y0 + rows - 1);
+            const ptrdiff_t columnStep = (last.x < first.x) ? -1 : 1;
+
+            const uint8_t* pSrc = srcImage.pixels;
+            for (size_t sy = 0; sy < srcImage.height; ++sy, pSrc += srcImage.rowPitch)
+            {
+                if (!LoadScanline(row, srcImage.width, pSrc, srcImage.rowPitch, srcImage.format))
+                    return E_FAIL;
+
+                const size_t x = (first.dy > 0) ? (sy - first.y) : (first.y - sy);
+
+                const XMVECTOR* pColumn = row + first.x;
+                for (size_t j = 0; j < rows; ++j, pColumn += columnStep)
+                {
+                    band[j * destImage.width + x] = *pColumn;
+                }
+            }
+
+            const XMVECTOR* pBand = band;
+            for (size_t j = 0; j < rows; ++j, pBand += destImage.width, pDest += destImage.rowPitch)
+            {
+                if (!StoreScanline(pDest, destImage.rowPitch, destImage.format, pBand, destImage.width))
+                    return E_FAIL;
+            }
+        }
+
+        return S_OK;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Block-compressed formats
+    //
+    // BC1-BC5 store each texel as an independent index into per-block endpoints, so a
+    // flip/rotate that keeps 4x4 blocks whole is exact: the blocks are permuted and the
+    // index fields within each block are remapped. That holds when every dimension is a
+    // multiple of 4 or fits in a single block. BC6H/BC7 blocks can be remapped the same
+    // way in their single-region modes; multi-region modes have fixed partition shapes.
+    // Anything else is only decoded, flipped/rotated, and encoded again when the caller
+    // opts in with TEX_FR_ALLOW_REENCODE.
+    //-------------------------------------------------------------------------------------
+    bool IsFlipRotateBlockFormat(DXGI_FORMAT format) noexcept
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_BC1_TYPELESS:
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+        case DXGI_FORMAT_BC2_TYPELESS:
+        case DXGI_FORMAT_BC2_UNORM:
+        case DXGI_FORMAT_BC2_UNORM_SRGB:
+        case DXGI_FORMAT_BC3_TYPELESS:
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:
+        case DXGI_FORMAT_BC4_TYPELESS:
+        case DXGI_FORMAT_BC4_UNORM:
+        case DXGI_FORMAT_BC4_SNORM:
+        case DXGI_FORMAT_BC5_TYPELESS:
+        case DXGI_FORMAT_BC5_UNORM:
+        case DXGI_FORMAT_BC5_SNORM:
+        case DXGI_FORMAT_BC6H_TYPELESS:
+        case DXGI_FORMAT_BC6H_UF16:
+        case DXGI_FORMAT_BC6H_SF16:
+        case DXGI_FORMAT_BC7_TYPELESS:
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    inline bool IsBlockAlignedDimension(size_t size) noexcept
+    {
+        return (size <= 4) || !(size & 3);
+    }
+
+    // Source pixel for a destination pixel, clamping block padding into the image
+    inline void GetFlipRotateSource(
+        TEX_FR_FLAGS flags,
+        const Image& srcImage,
+        const Image& destImage,
+        size_t destX,
+        size_t destY,
+        size_t& srcX,
+        size_t& srcY) noexcept
+    {
+        destX = std::min(destX, destImage.width - 1);
+        destY = std::min(destY, destImage.height - 1);
+
+        const FlipRotateWalk walk = GetFlipRotateWalk(flags, srcImage, destImage, destY);
+
+        srcX = static_cast<size_t>(static_cast<ptrdiff_t>(walk.x) + walk.dx * static_cast<ptrdiff_t>(destX));
+        srcY = static_cast<size_t>(static_cast<ptrdiff_t>(walk.y) + walk.dy * static_cast<ptrdiff_t>(destX));
+    }
+
+    // BC1 color block: two 565 endpoints followed by 2-bit indices
+    void RemapColorBlock(uint8_t* pDest, const uint8_t* pSrc, const uint8_t* remap) noexcept
+    {
+        uint32_t indices;
+        memcpy(&indices, pSrc + 4, sizeof(indices));
+
+        uint32_t result = 0;
+        for (size_t i = 0; i < 16; ++i)
+        {
+            result |= ((indices >> (2 * remap[i])) & 0x3u) << (2 * i);
+        }
+
+        memcpy(pDest, pSrc, 4);
+        memcpy(pDest + 4, &result, sizeof(result));
+    }
+
+    // BC2 alpha block: 4-bit explicit alpha
+    void RemapExplicitAlphaBlock(uint8_t* pDest, const uint8_t* pSrc, const uint8_t* remap) noexcept
+    {
+        uint64_t alpha;
+        memcpy(&alpha, pSrc, sizeof(alpha));
+
+        uint64_t result = 0;
+        for (size_t i = 0; i < 16; ++i)
+        {
+            result |= ((alpha >> (4 * remap[i])) & 0xFu) << (4 * i);
+        }
+
+        memcpy(pDest, &result, sizeof(result));
+    }
+
+    // BC3 alpha block and BC4/BC5 channel block: two endpoints followed by 3-bit indices
+    void RemapInterpolatedBlock(uint8_t* pDest, const uint8_t* pSrc, const uint8_t* remap) noexcept
+    {
+        uint64_t indices = 0;
+        memcpy(&indices, pSrc + 2, 6);
+
+        uint64_t result = 0;
+        for (size_t i = 0; i < 16; ++i)
+        {
+            result |= ((indices >> (3 * remap[i])) & 0x7u) << (3 * i);
+        }
+
+        memcpy(pDest, pSrc, 2);
+        memcpy(pDest + 2, &result, 6);
+    }
+
+    // BC6H/BC7 block that can't be rearranged exactly: decode it, rearrange the texels, and
+    // encode the result, which is lossy (typeless formats can't be decoded)
+    bool ReencodeBlock(DXGI_FORMAT format, uint8_t* pDest, const uint8_t* pSrc, const uint8_t* remap) noexcept
+    {
+        BC_DECODE pfDecode = nullptr;
+        BC_ENCODE pfEncode = nullptr;
+        switch (format)
+        {
+        case DXGI_FORMAT_BC6H_UF16:         pfDecode = D3DXDecodeBC6HU; pfEncode = D3DXEncodeBC6HU; break;
+        case DXGI_FORMAT_BC6H_SF16:         pfDecode = D3DXDecodeBC6HS; pfEncode = D3DXEncodeBC6HS; break;
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:    pfDecode = D3DXDecodeBC7;   pfEncode = D3DXEncodeBC7;   break;
+        default:
+            return false;
+        }
+
+        XM_ALIGNED_DATA(16) XMVECTOR decoded[NUM_PIXELS_PER_BLOCK];
+        pfDecode(decoded, pSrc);
+
+        XM_ALIGNED_DATA(16) XMVECTOR temp[NUM_PIXELS_PER_BLOCK];
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            temp[i] = decoded[remap[i]];
+        }
+
+        pfEncode(pDest, temp, BC_FLAGS_NONE);
+        return true;
+    }
+
+    HRESULT PerformFlipRotateBlocks(
+        const Image& srcImage,
+        TEX_FR_FLAGS flags,
+        const Image& destImage) noexcept
+    {
+        if (!srcImage.pixels || !destImage.pixels)
             return E_POINTER;
 
-        hr = PerformFlipRotateUsingWIC(*tsrc, flags, GUID_WICPixelFormat64bppRGBAHalf, *tdest);
-        if (FAILED(hr))
-            return hr;
+        assert(srcImage.format == destImage.format);
+        assert(IsBlockAlignedDimension(srcImage.width) && IsBlockAlignedDimension(srcImage.height));
 
-        temp.Release();
+        // Every destination block reads a single source block with the same texel remapping
+        uint8_t remap[16];
+        for (size_t py = 0; py < 4; ++py)
+        {
+            for (size_t px = 0; px < 4; ++px)
+            {
+                size_t sx, sy;
+                GetFlipRotateSource(flags, srcImage, destImage, px, py, sx, sy);
+                remap[py * 4 + px] = static_cast<uint8_t>((sy & 3) * 4 + (sx & 3));
+            }
+        }
 
-        hr = ConvertFromR16G16B16A16(*tdest, destImage);
-        if (FAILED(hr))
-            return hr;
+        const size_t blockBytes = (BitsPerPixel(srcImage.format) == 4) ? 8 : 16;
+        const size_t nbw = std::max<size_t>(1, (destImage.width + 3) / 4);
+        const size_t nbh = std::max<size_t>(1, (destImage.height + 3) / 4);
+
+        for (size_t by = 0; by < nbh; ++by)
+        {
+            uint8_t* pDest = destImage.pixels + by * destImage.rowPitch;
+            for (size_t bx = 0; bx < nbw; ++bx, pDest += blockBytes)
+            {
+                size_t sx, sy;
+                GetFlipRotateSource(flags, srcImage, destImage, bx * 4, by * 4, sx, sy);
+
+                const uint8_t* pSrc = srcImage.pixels + (sy / 4) * srcImage.rowPitch + (sx / 4) * blockBytes;
+
+                switch (srcImage.format)
+                {
+                case DXGI_FORMAT_BC1_TYPELESS:
+                case DXGI_FORMAT_BC1_UNORM:
+                case DXGI_FORMAT_BC1_UNORM_SRGB:
+                    RemapColorBlock(pDest, pSrc, remap);
+                    break;
+
+                case DXGI_FORMAT_BC2_TYPELESS:
+                case DXGI_FORMAT_BC2_UNORM:
+                case DXGI_FORMAT_BC2_UNORM_SRGB:
+                    RemapExplicitAlphaBlock(pDest, pSrc, remap);
+                    RemapColorBlock(pDest + 8, pSrc + 8, remap);
+                    break;
+
+                case DXGI_FORMAT_BC3_TYPELESS:
+                case DXGI_FORMAT_BC3_UNORM:
+                case DXGI_FORMAT_BC3_UNORM_SRGB:
+                    RemapInterpolatedBlock(pDest, pSrc, remap);
+                    RemapColorBlock(pDest + 8, pSrc + 8, remap);
+                    break;
+
+                case DXGI_FORMAT_BC4_TYPELESS:
+                case DXGI_FORMAT_BC4_UNORM:
+                case DXGI_FORMAT_BC4_SNORM:
+                    RemapInterpolatedBlock(pDest, pSrc, remap);
+                    break;
+
+                case DXGI_FORMAT_BC5_TYPELESS:
+                case DXGI_FORMAT_BC5_UNORM:
+                case DXGI_FORMAT_BC5_SNORM:
+                    RemapInterpolatedBlock(pDest, pSrc, remap);
+                    RemapInterpolatedBlock(pDest + 8, pSrc + 8, remap);
+                    break;
+
+                case DXGI_FORMAT_BC6H_TYPELESS:
+                case DXGI_FORMAT_BC6H_UF16:
+                case DXGI_FORMAT_BC6H_SF16:
+                    if (!D3DXRemapBC6H(pDest, pSrc, remap)
+                        && (!(flags & TEX_FR_ALLOW_REENCODE) || !ReencodeBlock(srcImage.format, pDest, pSrc, remap)))
+                        return HRESULT_E_NOT_SUPPORTED;
+                    break;
+
+                case DXGI_FORMAT_BC7_TYPELESS:
+                case DXGI_FORMAT_BC7_UNORM:
+                case DXGI_FORMAT_BC7_UNORM_SRGB:
+                    if (!D3DXRemapBC7(pDest, pSrc, remap)
+                        && (!(flags & TEX_FR_ALLOW_REENCODE) || !ReencodeBlock(srcImage.format, pDest, pSrc, remap)))
+                        return HRESULT_E_NOT_SUPPORTED;
+                    break;
+
+                default:
+                    return HRESULT_E_NOT_SUPPORTED;
+                }
+            }
+        }
 
         return S_OK;
     }
 
-    HRESULT PerformFlipRotateViaF32(
+    HRESULT PerformFlipRotateViaDecompress(
         const Image& srcImage,
         TEX_FR_FLAGS flags,
         const Image& destImage) noexcept
@@ -139,39 +704,90 @@ namespace
         if (!srcImage.pixels || !destImage.pixels)
             return E_POINTER;
 
-        assert(srcImage.format != DXGI_FORMAT_R32G32B32A32_FLOAT);
         assert(srcImage.format == destImage.format);
 
-        ScratchImage temp;
-        HRESULT hr = ConvertToR32G32B32A32(srcImage, temp);
+        if (IsTypeless(srcImage.format))
+            return HRESULT_E_NOT_SUPPORTED;
+
+        ScratchImage decoded;
+        HRESULT hr = Decompress(srcImage, DXGI_FORMAT_UNKNOWN, decoded);
         if (FAILED(hr))
             return hr;
 
-        const Image *tsrc = temp.GetImage(0, 0, 0);
-        if (!tsrc)
+        const Image* img = decoded.GetImage(0, 0, 0);
+        if (!img)
             return E_POINTER;
 
-        ScratchImage rtemp;
-        hr = rtemp.Initialize2D(DXGI_FORMAT_R32G32B32A32_FLOAT, destImage.width, destImage.height, 1, 1);
+        ScratchImage rotated;
+        hr = FlipRotate(*img, flags, rotated);
         if (FAILED(hr))
             return hr;
 
-        const Image *tdest = rtemp.GetImage(0, 0, 0);
-        if (!tdest)
+        decoded.Release();
+
+        img = rotated.GetImage(0, 0, 0);
+        if (!img)
             return E_POINTER;
 
-        hr = PerformFlipRotateUsingWIC(*tsrc, flags, GUID_WICPixelFormat128bppRGBAFloat, *tdest);
+        ScratchImage encoded;
+        hr = Compress(*img, srcImage.format, TEX_COMPRESS_DEFAULT, TEX_THRESHOLD_DEFAULT, encoded);
         if (FAILED(hr))
             return hr;
 
-        temp.Release();
+        img = encoded.GetImage(0, 0, 0);
+        if (!img)
+            return E_POINTER;
 
-        hr = ConvertFromR32G32B32A32(*tdest, destImage);
-        if (FAILED(hr))
-            return hr;
+        if (img->width != destImage.width || img->height != destImage.height)
+            return E_FAIL;
+
+        const size_t rowBytes = std::min(img->rowPitch, destImage.rowPitch);
+        const size_t rows = ComputeScanlines(destImage.format, destImage.height);
+
+        const uint8_t* pSrc = img->pixels;
+        uint8_t* pDest = destImage.pixels;
+        for (size_t y = 0; y < rows; ++y, pSrc += img->rowPitch, pDest += destImage.rowPitch)
+        {
+            memcpy(pDest, pSrc, rowBytes);
+        }
 
         return S_OK;
     }
+
+    HRESULT PerformFlipRotateCompressed(
+        const Image& srcImage,
+        TEX_FR_FLAGS flags,
+        const Image& destImage) noexcept
+    {
+        if (IsFlipRotateBlockFormat(srcImage.format)
+            && IsBlockAlignedDimension(srcImage.width)
+            && IsBlockAlignedDimension(srcImage.height))
+        {
+            const HRESULT hr = PerformFlipRotateBlocks(srcImage, flags, destImage);
+            if (hr != HRESULT_E_NOT_SUPPORTED)
+                return hr;
+        }
+
+        // Re-encoding is lossy, so it is only done on request
+        if (!(flags & TEX_FR_ALLOW_REENCODE))
+            return HRESULT_E_NOT_SUPPORTED;
+
+        return PerformFlipRotateViaDecompress(srcImage, flags, destImage);
+    }
+
+    //-------------------------------------------------------------------------------------
+    HRESULT PerformFlipRotateWithoutWIC(
+        const Image& srcImage,
+        TEX_FR_FLAGS flags,
+        const Image& destImage) noexcept
+    {
+        if (IsCompressed(srcImage.format))
+            return PerformFlipRotateCompressed(srcImage, flags, destImage);
+
+        return IsFlipRotateRawFormat(srcImage.format)
+            ? PerformFlipRotateRaw(srcImage, flags, destImage)
+            : PerformFlipRotateViaScanlines(srcImage, flags, destImage);
+    }
 }
 
 
@@ -197,18 +813,14 @@ HRESULT DirectX::FlipRotate(
     if ((srcImage.width > UINT32_MAX) || (srcImage.height > UINT32_MAX))
         return E_INVALIDARG;
 
-    if (IsCompressed(srcImage.format))
-    {
-        // We don't support flip/rotate operations on compressed images
-        return HRESULT_E_NOT_SUPPORTED;
-    }
-
+#ifdef _WIN32
     static_assert(static_cast<int>(TEX_FR_ROTATE0) == static_cast<int>(WICBitmapTransformRotate0), "TEX_FR_ROTATE0 no longer matches WIC");
     static_assert(static_cast<int>(TEX_FR_ROTATE90) == static_cast<int>(WICBitmapTransformRotate90), "TEX_FR_ROTATE90 no longer matches WIC");
     static_assert(static_cast<int>(TEX_FR_ROTATE180) == static_cast<int>(WICBitmapTransformRotate180), "TEX_FR_ROTATE180 no longer matches WIC");
     static_assert(static_cast<int>(TEX_FR_ROTATE270) == static_cast<int>(WICBitmapTransformRotate270), "TEX_FR_ROTATE270 no longer matches WIC");
     static_assert(static_cast<int>(TEX_FR_FLIP_HORIZONTAL) == static_cast<int>(WICBitmapTransformFlipHorizontal), "TEX_FR_FLIP_HORIZONTAL no longer matches WIC");
     static_assert(static_cast<int>(TEX_FR_FLIP_VERTICAL) == static_cast<int>(WICBitmapTransformFlipVertical), "TEX_FR_FLIP_VERTICAL no longer matches WIC");
+#endif
 
     // Only supports 90, 180, 270, or no rotation flags... not a combination of rotation flags
     const int rotateMode = static_cast<int>(flags & (TEX_FR_ROTATE0 | TEX_FR_ROTATE90 | TEX_FR_ROTATE180 | TEX_FR_ROTATE270));
@@ -245,25 +857,18 @@ HRESULT DirectX::FlipRotate(
         return E_POINTER;
     }
 
+#ifdef _WIN32
     WICPixelFormatGUID pfGUID;
-    if (DXGIToWIC(srcImage.format, pfGUID))
+    if (!IsCompressed(srcImage.format) && DXGIToWIC(srcImage.format, pfGUID))
     {
         // Case 1: Source format is supported by Windows Imaging Component
         hr = PerformFlipRotateUsingWIC(srcImage, flags, pfGUID, *rimage);
     }
     else
+    #endif
     {
-        // Case 2: Source format is not supported by WIC, so we have to convert, flip/rotate, and convert back
-        const uint64_t expandedSize = uint64_t(srcImage.width) * uint64_t(srcImage.height) * sizeof(float) * 4;
-        if (expandedSize > UINT32_MAX)
-        {
-            // Image is too large for float32, so have to use float16 instead
-            hr = PerformFlipRotateViaF16(srcImage, flags, *rimage);
-        }
-        else
-        {
-            hr = PerformFlipRotateViaF32(srcImage, flags, *rimage);
-        }
+        // Case 2: Source format is not supported by WIC, so flip/rotate row by row (or by block)
+        hr = PerformFlipRotateWithoutWIC(srcImage, flags, *rimage);
     }
 
     if (FAILED(hr))
@@ -290,18 +895,14 @@ HRESULT DirectX::FlipRotate(
     if (!srcImages || !nimages)
         return E_INVALIDARG;
 
-    if (IsCompressed(metadata.format))
-    {
-        // We don't support flip/rotate operations on compressed images
-        return HRESULT_E_NOT_SUPPORTED;
-    }
-
+#ifdef _WIN32
     static_assert(static_cast<int>(TEX_FR_ROTATE0) == static_cast<int>(WICBitmapTransformRotate0), "TEX_FR_ROTATE0 no longer matches WIC");
     static_assert(static_cast<int>(TEX_FR_ROTATE90) == static_cast<int>(WICBitmapTransformRotate90), "TEX_FR_ROTATE90 no longer matches WIC");
     static_assert(static_cast<int>(TEX_FR_ROTATE180) == static_cast<int>(WICBitmapTransformRotate180), "TEX_FR_ROTATE180 no longer matches WIC");
     static_assert(static_cast<int>(TEX_FR_ROTATE270) == static_cast<int>(WICBitmapTransformRotate270), "TEX_FR_ROTATE270 no longer matches WIC");
     static_assert(static_cast<int>(TEX_FR_FLIP_HORIZONTAL) == static_cast<int>(WICBitmapTransformFlipHorizontal), "TEX_FR_FLIP_HORIZONTAL no longer matches WIC");
     static_assert(static_cast<int>(TEX_FR_FLIP_VERTICAL) == static_cast<int>(WICBitmapTransformFlipVertical), "TEX_FR_FLIP_VERTICAL no longer matches WIC");
+#endif
 
     // Only supports 90, 180, 270, or no rotation flags... not a combination of rotation flags
     const int rotateMode = static_cast<int>(flags & (TEX_FR_ROTATE0 | TEX_FR_ROTATE90 | TEX_FR_ROTATE180 | TEX_FR_ROTATE270));
@@ -345,9 +946,7 @@ HRESULT DirectX::FlipRotate(
         return E_POINTER;
     }
 
-    WICPixelFormatGUID pfGUID;
-    const bool wicpf = DXGIToWIC(metadata.format, pfGUID);
-
+    // Validate everything up front so the flip/rotate loop has a single failure mode
     for (size_t index = 0; index < nimages; ++index)
     {
         const Image& src = srcImages[index];
@@ -358,7 +957,10 @@ HRESULT DirectX::FlipRotate(
         }
 
         if ((src.width > UINT32_MAX) || (src.height > UINT32_MAX))
+        {
+            result.Release();
             return E_FAIL;
+        }
 
         const Image& dst = dest[index];
         assert(dst.format == metadata.format);
@@ -379,24 +981,53 @@ HRESULT DirectX::FlipRotate(
                 return E_FAIL;
             }
         }
+    }
 
-        if (wicpf)
+#ifdef _WIN32
+    WICPixelFormatGUID pfGUID;
+    const bool wicpf = !IsCompressed(metadata.format) && DXGIToWIC(metadata.format, pfGUID);
+#endif
+
+#ifdef _OPENMP
+    bool parallel = (nimages > 1) && (flags & TEX_FR_PARALLEL);
+#ifdef _WIN32
+    parallel = parallel && !wicpf;
+#endif
+
+    if (parallel)
+    {
+        // Array items, faces, and mips are independent, so spread them across threads
+        if (nimages > INT32_MAX)
         {
-            // Case 1: Source format is supported by Windows Imaging Component
-            hr = PerformFlipRotateUsingWIC(src, flags, pfGUID, dst);
+            result.Release();
+            return HRESULT_E_ARITHMETIC_OVERFLOW;
         }
-        else
+
+        hr = S_OK;
+        bool fail = false;
+
+    #pragma omp parallel for schedule(dynamic) shared(hr, fail)
+        for (int index = 0; index < static_cast<int>(nimages); ++index)
         {
-            // Case 2: Source format is not supported by WIC, so we have to convert, flip/rotate, and convert back
-            const uint64_t expandedSize = uint64_t(src.width) * uint64_t(src.height) * sizeof(float) * 4;
-            if (expandedSize > UINT32_MAX)
+        #pragma omp flush (fail)
+            if (fail)
             {
-                // Image is too large for float32, so have to use float16 instead
-                hr = PerformFlipRotateViaF16(src, flags, dst);
+                // Short circuit the loop body if a failure has occurred.
+                // OpenMP 2.0 does not support cancellation of a 'parallel for' loop.
+                continue;
             }
-            else
+
+            const HRESULT hrItem = PerformFlipRotateWithoutWIC(srcImages[index], flags, dest[index]);
+            if (FAILED(hrItem))
             {
-                hr = PerformFlipRotateViaF32(src, flags, dst);
+            #pragma omp critical
+                {
+                    if (SUCCEEDED(hr))
+                        hr = hrItem;
+                }
+
+                fail = true;
+            #pragma omp flush (fail)
             }
         }
 
@@ -405,6 +1036,31 @@ HRESULT DirectX::FlipRotate(
             result.Release();
             return hr;
         }
+
+        return S_OK;
+    }
+#endif // _OPENMP
+
+    for (size_t index = 0; index < nimages; ++index)
+    {
+    #ifdef _WIN32
+        if (wicpf)
+        {
+            // Case 1: Source format is supported by Windows Imaging Component
+            hr = PerformFlipRotateUsingWIC(srcImages[index], flags, pfGUID, dest[index]);
+        }
+        else
+        #endif
+        {
+            // Case 2: Source format is not supported by WIC, so flip/rotate row by row (or by block)
+            hr = PerformFlipRotateWithoutWIC(srcImages[index], flags, dest[index]);
+        }
+
+        if (FAILED(hr))
+        {
+            result.Release();
+            return hr;
+        }
     }
 
     return S_OK;
@@ -815,7 +815,7 @@ bool ScratchImage::IsAlphaAllOpaque() const noexcept
     }
     else
     {
-        auto scanline = make_AlignedArrayXMVECTOR(m_metadata.width);
+        auto scanline = make_ScratchArrayXMVECTOR(m_metadata.width);
         if (!scanline)
             return false;
 
@@ -13,6 +13,11 @@
 
 #include "filters.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#pragma warning(disable : 4616 6993)
+#endif
+
 using namespace DirectX;
 using namespace DirectX::Internal;
 using Microsoft::WRL::ComPtr;
@@ -124,22 +129,6 @@ namespace
 #endif // WIN32
 
 
-#if DIRECTX_MATH_VERSION >= 310
-#define VectorSum XMVectorSum
-#else
-    inline XMVECTOR XM_CALLCONV VectorSum
-    (
-        FXMVECTOR V
-    )
-    {
-        XMVECTOR vTemp = XMVectorSwizzle<2, 3, 0, 1>(V);
-        XMVECTOR vTemp2 = XMVectorAdd(V, vTemp);
-        vTemp = XMVectorSwizzle<1, 0, 3, 2>(vTemp2);
-        return XMVectorAdd(vTemp, vTemp2);
-    }
-#endif
-
-
     HRESULT ScaleAlpha(
         const Image& srcImage,
         float alphaScale,
@@ -148,7 +137,7 @@ namespace
         assert(srcImage.width == destImage.width);
         assert(srcImage.height == destImage.height);
 
-        auto scanline = make_AlignedArrayXMVECTOR(srcImage.width);
+        auto scanline = make_ScratchArrayXMVECTOR(srcImage.width);
         if (!scanline)
         {
             return E_OUTOFMEMORY;
@@ -191,150 +180,181 @@ namespace
     }
 
 
-    void GenerateAlphaCoverageConvolutionVectors(
-        _In_ size_t N,
-        _Out_writes_(N*N) XMVECTOR* vectors) noexcept
+    //-------------------------------------------------------------------------------------
+    // Alpha coverage
+    //
+    // Coverage is the fraction of 2x2 quads of a level whose bilinear alpha sample at
+    // (1/16, 1/16) of the quad exceeds alphaReference once alpha is scaled and saturated.
+    // That sample only grows with the scale, so every quad has a threshold scale above
+    // which it is covered. A level is read once to bin those thresholds; the coverage at
+    // any scale the binary search can visit (a multiple of 1/512 in [0, 4)) is then a
+    // prefix sum of the histogram.
+    //-------------------------------------------------------------------------------------
+    constexpr float c_MaxAlphaScale = 4.0f;
+    constexpr size_t c_AlphaScaleSteps = 10;
+    constexpr size_t c_CoverageBins = 2048;
+    constexpr float c_CoverageBinsPerUnit = float(c_CoverageBins) / c_MaxAlphaScale;
+
+    struct AlphaCoverageHistogram
     {
-        for (size_t sy = 0; sy < N; ++sy)
+        size_t  total;                  // Quads in the level
+        size_t  always;                 // Quads covered at any scale
+        size_t  covered[c_CoverageBins];// Quads covered at scale (i + 1) / 512, excluding 'always'
+    };
+
+    // Smallest alpha scale 's' such that w . saturate(alpha * s) > alphaReference; negative if the
+    // quad is always covered, FLT_MAX if it never is
+    float GetAlphaCoverageThreshold(const float* alpha, const float* weight, float alphaReference) noexcept
+    {
+        if (alphaReference < 0.f)
+            return -1.f;
+
+        // Only positive alphas contribute, and the largest one saturates first
+        float a[4];
+        float w[4];
+        size_t count = 0;
+        float slope = 0.f;
+        for (size_t j = 0; j < 4; ++j)
         {
-            const float fy = (float(sy) + 0.5f) / float(N);
-            const float ify = 1.0f - fy;
-
-            for (size_t sx = 0; sx < N; ++sx)
+            if (alpha[j] > 0.f)
             {
-                const float fx = (float(sx) + 0.5f) / float(N);
-                const float ifx = 1.0f - fx;
+                size_t k = count++;
+                for (; k > 0 && a[k - 1] < alpha[j]; --k)
+                {
+                    a[k] = a[k - 1];
+                    w[k] = w[k - 1];
+                }
+                a[k] = alpha[j];
+                w[k] = weight[j];
+                slope += weight[j] * alpha[j];
+            }
+        }
 
-                // [0]=(x+0, y+0), [1]=(x+0, y+1), [2]=(x+1, y+0), [3]=(x+1, y+1)
-                vectors[sy * N + sx] = XMVectorSet(ifx * ify, ifx * fy, fx * ify, fx * fy);
+        // The sample is piecewise linear in the scale, with a corner each time an alpha saturates
+        float saturated = 0.f;
+        float start = 0.f;
+        for (size_t k = 0; k < count; ++k)
+        {
+            const float corner = 1.f / a[k];
+            if (saturated + slope * corner > alphaReference)
+            {
+                return (slope > 0.f) ? std::max(start, (alphaReference - saturated) / slope) : start;
             }
+
+            saturated += w[k];
+            slope -= w[k] * a[k];
+            start = corner;
         }
-    }
 
+        return FLT_MAX;
+    }
 
-    HRESULT CalculateAlphaCoverage(
+    HRESULT BuildAlphaCoverageHistogram(
         const Image& srcImage,
         float alphaReference,
-        float alphaScale,
-        float& coverage) noexcept
+        AlphaCoverageHistogram& hist) noexcept
     {
-        coverage = 0.0f;
+        memset(&hist, 0, sizeof(AlphaCoverageHistogram));
 
-        auto row0 = make_AlignedArrayXMVECTOR(srcImage.width);
-        if (!row0)
+        const uint8_t *pSrc = srcImage.pixels;
+        if (!pSrc)
         {
-            return E_OUTOFMEMORY;
+            return E_POINTER;
+        }
+
+        if (srcImage.width < 2 || srcImage.height < 2)
+        {
+            return S_OK;
         }
 
-        auto row1 = make_AlignedArrayXMVECTOR(srcImage.width);
-        if (!row1)
+        auto scanline = make_ScratchArrayXMVECTOR(uint64_t(srcImage.width) * 2);
+        if (!scanline)
         {
             return E_OUTOFMEMORY;
         }
 
-        const XMVECTOR scale = XMVectorReplicate(alphaScale);
+        XMVECTOR* row0 = scanline.get();
+        XMVECTOR* row1 = row0 + srcImage.width;
+
+        // Bilinear weights of the sample, [0]=(x+0, y+0), [1]=(x+0, y+1), [2]=(x+1, y+0), [3]=(x+1, y+1)
+        constexpr float f = 0.5f / 8.f;
+        constexpr float fi = 1.0f - f;
+        const float weight[4] = { fi * fi, fi * f, f * fi, f * f };
 
-        const uint8_t *pSrcRow0 = srcImage.pixels;
-        if (!pSrcRow0)
+        if (!LoadScanlineLinear(row0, srcImage.width, pSrc, srcImage.rowPitch, srcImage.format, TEX_FILTER_DEFAULT))
         {
-            return E_POINTER;
+            return E_FAIL;
         }
 
-        constexpr size_t N = 8;
-        XMVECTOR convolution[N * N];
-        GenerateAlphaCoverageConvolutionVectors(N, convolution);
-
-        size_t coverageCount = 0;
         for (size_t y = 0; y < srcImage.height - 1; ++y)
         {
-            if (!LoadScanlineLinear(row0.get(), srcImage.width, pSrcRow0, srcImage.rowPitch, srcImage.format, TEX_FILTER_DEFAULT))
-            {
-                return E_FAIL;
-            }
-
-            const uint8_t *pSrcRow1 = pSrcRow0 + srcImage.rowPitch;
-            if (!LoadScanlineLinear(row1.get(), srcImage.width, pSrcRow1, srcImage.rowPitch, srcImage.format, TEX_FILTER_DEFAULT))
+            pSrc += srcImage.rowPitch;
+            if (!LoadScanlineLinear(row1, srcImage.width, pSrc, srcImage.rowPitch, srcImage.format, TEX_FILTER_DEFAULT))
             {
                 return E_FAIL;
             }
 
-            const XMVECTOR* pRow0 = row0.get();
-            const XMVECTOR* pRow1 = row1.get();
+            float alpha[4];
+            alpha[2] = XMVectorGetW(row0[0]);
+            alpha[3] = XMVectorGetW(row1[0]);
             for (size_t x = 0; x < srcImage.width - 1; ++x)
             {
-                // [0]=(x+0, y+0), [1]=(x+0, y+1), [2]=(x+1, y+0), [3]=(x+1, y+1)
-                XMVECTOR r0 = XMVectorSplatW(*pRow0);
-                XMVECTOR r1 = XMVectorSplatW(*pRow1);
-
-                XMVECTOR v1 = XMVectorSaturate(XMVectorMultiply(r0, scale));
-                const XMVECTOR v2 = XMVectorSaturate(XMVectorMultiply(r1, scale));
-
-                r0 = XMVectorSplatW(*(++pRow0));
-                r1 = XMVectorSplatW(*(++pRow1));
+                alpha[0] = alpha[2];
+                alpha[1] = alpha[3];
+                alpha[2] = XMVectorGetW(row0[x + 1]);
+                alpha[3] = XMVectorGetW(row1[x + 1]);
 
-                XMVECTOR v3 = XMVectorSaturate(XMVectorMultiply(XMVectorSplatW(r0), scale));
-                const XMVECTOR v4 = XMVectorSaturate(XMVectorMultiply(XMVectorSplatW(r1), scale));
-
-                v1 = XMVectorMergeXY(v1, v2); // [v1.x v2.x --- ---]
-                v3 = XMVectorMergeXY(v3, v4); // [v3.x v4.x --- ---]
-
-                XMVECTOR v = XMVectorPermute<0, 1, 4, 5>(v1, v3); // [v1.x v2.x v3.x v4.x]
-
-                for (size_t sy = 0; sy < N; ++sy)
+                const float t = GetAlphaCoverageThreshold(alpha, weight, alphaReference);
+                if (t < 0.f)
                 {
-                    const size_t ry = sy * N;
-                    for (size_t sx = 0; sx < N; ++sx)
-                    {
-                        v = VectorSum(XMVectorMultiply(v, convolution[ry + sx]));
-                        if (XMVectorGetX(v) > alphaReference)
-                        {
-                            ++coverageCount;
-                        }
-                    }
+                    ++hist.always;
+                }
+                else if (t < c_MaxAlphaScale)
+                {
+                    const auto bin = std::min(static_cast<size_t>(t * c_CoverageBinsPerUnit), c_CoverageBins - 1);
+                    ++hist.covered[bin];
                 }
             }
 
-            pSrcRow0 = pSrcRow1;
+            std::swap(row0, row1);
         }
 
-        float cscale = static_cast<float>((srcImage.width - 1) * (srcImage.height - 1) * N * N);
-        if (cscale > 0.f)
+        hist.total = (srcImage.width - 1) * (srcImage.height - 1);
+
+        for (size_t j = 1; j < c_CoverageBins; ++j)
         {
-            coverage = static_cast<float>(coverageCount) / cscale;
+            hist.covered[j] += hist.covered[j - 1];
         }
 
         return S_OK;
     }
 
 
-    HRESULT EstimateAlphaScaleForCoverage(
-        const Image& srcImage,
-        float alphaReference,
-        float targetCoverage,
-        float& alphaScale) noexcept
+    float GetAlphaCoverage(const AlphaCoverageHistogram& hist, float alphaScale) noexcept
     {
-        float minAlphaScale = 0.0f;
-        float maxAlphaScale = 4.0f;
-        float bestError = FLT_MAX;
+        if (!hist.total)
+            return 0.f;
 
-        // Determine desired scale using a binary search. Hardcoded to 10 steps max.
-        alphaScale = 1.0f;
-        constexpr size_t N = 10;
-        for (size_t i = 0; i < N; ++i)
-        {
-            float currentCoverage = 0.0f;
-            HRESULT hr = CalculateAlphaCoverage(srcImage, alphaReference, alphaScale, currentCoverage);
-            if (FAILED(hr))
-            {
-                return hr;
-            }
+        // Quads are covered when the scale is above their threshold
+        const auto step = std::min(static_cast<size_t>(alphaScale * c_CoverageBinsPerUnit), c_CoverageBins);
+        const size_t count = hist.always + ((step > 0) ? hist.covered[step - 1] : 0);
 
-            const float error = fabsf(currentCoverage - targetCoverage);
-            if (error < bestError)
-            {
-                bestError = error;
-            }
+        return static_cast<float>(count) / static_cast<float>(hist.total);
+    }
+
+
+    float EstimateAlphaScaleForCoverage(
+        const AlphaCoverageHistogram& hist,
+        float targetCoverage) noexcept
+    {
+        float minAlphaScale = 0.0f;
+        float maxAlphaScale = c_MaxAlphaScale;
 
+        // Determine desired scale using a binary search. Every scale it visits is a bin edge.
+        float alphaScale = 1.0f;
+        for (size_t i = 0; i < c_AlphaScaleSteps; ++i)
+        {
+            const float currentCoverage = GetAlphaCoverage(hist, alphaScale);
             if (currentCoverage < targetCoverage)
             {
                 minAlphaScale = alphaScale;
@@ -351,7 +371,7 @@ namespace
             alphaScale = (minAlphaScale + maxAlphaScale) * 0.5f;
         }
 
-        return S_OK;
+        return alphaScale;
     }
 }
 
@@ -615,6 +635,276 @@ HRESULT DirectX::Internal::ResizeSeparateColorAndAlpha(
 
     return hr;
 }
+
+namespace
+{
+    // Target size of each band of float rows pulled from a WIC scaler
+    constexpr size_t c_WICBandBytes = 4 * 1024 * 1024;
+
+    //-------------------------------------------------------------------------------------
+    // WIC bitmap source that decodes rows of an image to GUID_WICPixelFormat128bppRGBAFloat
+    // only as they are requested, so WIC can filter formats it doesn't support without a
+    // full-size float copy of the source
+    //-------------------------------------------------------------------------------------
+    class ScanlineBitmapSource : public IWICBitmapSource
+    {
+        ScanlineBitmapSource(const Image& image, ScopedAlignedArrayXMVECTOR&& row) noexcept :
+            mImage(image),
+            mRow(std::move(row)),
+            mRefCount(1)
+        {
+        }
+
+    public:
+        virtual ~ScanlineBitmapSource() = default;
+
+        ScanlineBitmapSource(ScanlineBitmapSource&&) = delete;
+        ScanlineBitmapSource& operator= (ScanlineBitmapSource&&) = delete;
+
+        ScanlineBitmapSource(ScanlineBitmapSource const&) = delete;
+        ScanlineBitmapSource& operator= (ScanlineBitmapSource const&) = delete;
+
+        // IUnknown
+        HRESULT STDMETHODCALLTYPE QueryInterface(REFIID iid, void** ppvObject) override
+        {
+            if (iid == __uuidof(IUnknown)
+                || iid == __uuidof(IWICBitmapSource))
+            {
+                *ppvObject = static_cast<IWICBitmapSource*>(this);
+                AddRef();
+                return S_OK;
+            }
+            else
+                return E_NOINTERFACE;
+        }
+
+        ULONG STDMETHODCALLTYPE AddRef() override
+        {
+            return InterlockedIncrement(&mRefCount);
+        }
+
+        ULONG STDMETHODCALLTYPE Release() override
+        {
+            const ULONG res = InterlockedDecrement(&mRefCount);
+            if (res == 0)
+            {
+                delete this;
+            }
+            return res;
+        }
+
+        // IWICBitmapSource
+        HRESULT STDMETHODCALLTYPE GetSize(UINT* puiWidth, UINT* puiHeight) override
+        {
+            if (!puiWidth || !puiHeight)
+                return E_INVALIDARG;
+
+            *puiWidth = static_cast<UINT>(mImage.width);
+            *puiHeight = static_cast<UINT>(mImage.height);
+            return S_OK;
+        }
+
+        HRESULT STDMETHODCALLTYPE GetPixelFormat(WICPixelFormatGUID* pPixelFormat) override
+        {
+            if (!pPixelFormat)
+                return E_INVALIDARG;
+
+            *pPixelFormat = GUID_WICPixelFormat128bppRGBAFloat;
+            return S_OK;
+        }
+
+        HRESULT STDMETHODCALLTYPE GetResolution(double* pDpiX, double* pDpiY) override
+        {
+            if (!pDpiX || !pDpiY)
+                return E_INVALIDARG;
+
+            *pDpiX = *pDpiY = 96.0;
+            return S_OK;
+        }
+
+        HRESULT STDMETHODCALLTYPE CopyPalette(IWICPalette*) override
+        {
+            return WINCODEC_ERR_PALETTEUNAVAILABLE;
+        }
+
+        HRESULT STDMETHODCALLTYPE CopyPixels(const WICRect* prc, UINT cbStride, UINT cbBufferSize, BYTE* pbBuffer) override
+        {
+            if (!pbBuffer)
+                return E_INVALIDARG;
+
+            WICRect rc = { 0, 0, static_cast<INT>(mImage.width), static_cast<INT>(mImage.height) };
+            if (prc)
+            {
+                if (prc->X < 0 || prc->Y < 0 || prc->Width < 0 || prc->Height < 0
+                    || size_t(prc->X) + size_t(prc->Width) > mImage.width
+                    || size_t(prc->Y) + size_t(prc->Height) > mImage.height)
+                    return E_INVALIDARG;
+
+                rc = *prc;
+            }
+
+            if (!rc.Width || !rc.Height)
+                return S_OK;
+
+            const uint64_t rowBytes = uint64_t(rc.Width) * sizeof(XMVECTOR);
+            if (rowBytes > cbStride
+                || uint64_t(cbStride) * uint64_t(rc.Height - 1) + rowBytes > cbBufferSize)
+                return E_INVALIDARG;
+
+            const uint8_t* pSrc = mImage.pixels + size_t(rc.Y) * mImage.rowPitch;
+            for (INT y = 0; y < rc.Height; ++y)
+            {
+                if (!LoadScanline(mRow.get(), mImage.width, pSrc, mImage.rowPitch, mImage.format))
+                    return E_FAIL;
+
+                memcpy(pbBuffer, mRow.get() + rc.X, static_cast<size_t>(rowBytes));
+
+                pSrc += mImage.rowPitch;
+                pbBuffer += cbStride;
+            }
+
+            return S_OK;
+        }
+
+        static HRESULT Create(const Image& image, _Outptr_ ScanlineBitmapSource** source) noexcept
+        {
+            if (!source)
+                return E_INVALIDARG;
+
+            *source = nullptr;
+
+            if (!image.pixels)
+                return E_POINTER;
+
+            if (image.width > INT32_MAX || image.height > INT32_MAX)
+                return HRESULT_E_ARITHMETIC_OVERFLOW;
+
+            auto row = make_AlignedArrayXMVECTOR(image.width);
+            if (!row)
+                return E_OUTOFMEMORY;
+
+            auto ptr = new (std::nothrow) ScanlineBitmapSource(image, std::move(row));
+            if (!ptr)
+                return E_OUTOFMEMORY;
+
+            *source = ptr;
+
+            return S_OK;
+        }
+
+    private:
+        Image mImage;
+        ScopedAlignedArrayXMVECTOR mRow;
+        ULONG mRefCount;
+    };
+
+
+    //--- Pulls a 128bppRGBAFloat WIC source in bands of rows and stores them to the destination format ---
+    HRESULT StoreBitmapSourceBands(_In_ IWICBitmapSource* source, const Image& destImage) noexcept
+    {
+        if (destImage.width > INT32_MAX || destImage.height > INT32_MAX)
+            return HRESULT_E_ARITHMETIC_OVERFLOW;
+
+        const uint64_t rowBytes = uint64_t(destImage.width) * sizeof(XMVECTOR);
+        if (rowBytes > UINT32_MAX)
+            return HRESULT_E_ARITHMETIC_OVERFLOW;
+
+        const size_t bandHeight = std::max<size_t>(1,
+            std::min<size_t>(destImage.height, c_WICBandBytes / static_cast<size_t>(rowBytes)));
+
+        auto band = make_ScratchArrayXMVECTOR(uint64_t(destImage.width) * bandHeight);
+        if (!band)
+            return E_OUTOFMEMORY;
+
+        uint8_t* pDest = destImage.pixels;
+        for (size_t y = 0; y < destImage.height; y += bandHeight)
+        {
+            const size_t rows = std::min(bandHeight, destImage.height - y);
+
+            const WICRect rc = { 0, static_cast<INT>(y), static_cast<INT>(destImage.width), static_cast<INT>(rows) };
+            HRESULT hr = source->CopyPixels(&rc, static_cast<UINT>(rowBytes), static_cast<UINT>(rowBytes * rows),
+                reinterpret_cast<BYTE*>(band.get()));
+            if (FAILED(hr))
+                return hr;
+
+            const XMVECTOR* pSrc = band.get();
+            for (size_t j = 0; j < rows; ++j)
+            {
+                if (!StoreScanline(pDest, destImage.rowPitch, destImage.format, pSrc, destImage.width))
+                    return E_FAIL;
+
+                pSrc += destImage.width;
+                pDest += destImage.rowPitch;
+            }
+        }
+
+        return S_OK;
+    }
+}
+
+//--- Resizing a format WIC doesn't support by streaming rows through 128bppRGBAFloat ---
+_Use_decl_annotations_
+HRESULT DirectX::Internal::ResizeViaR32G32B32A32UsingWIC(
+    IWICImagingFactory* pWIC,
+    const Image& srcImage,
+    TEX_FILTER_FLAGS filter,
+    const Image& destImage) noexcept
+{
+    if (!pWIC)
+        return E_POINTER;
+
+    if (!srcImage.pixels || !destImage.pixels)
+        return E_POINTER;
+
+    assert(srcImage.format == destImage.format);
+
+    ComPtr<ScanlineBitmapSource> source;
+    HRESULT hr = ScanlineBitmapSource::Create(srcImage, source.GetAddressOf());
+    if (FAILED(hr))
+        return hr;
+
+    ComPtr<IWICBitmapScaler> scaler;
+    hr = pWIC->CreateBitmapScaler(scaler.GetAddressOf());
+    if (FAILED(hr))
+        return hr;
+
+    hr = scaler->Initialize(source.Get(),
+        static_cast<UINT>(destImage.width), static_cast<UINT>(destImage.height),
+        GetWICInterp(filter));
+    if (FAILED(hr))
+        return hr;
+
+    WICPixelFormatGUID pfScaler;
+    hr = scaler->GetPixelFormat(&pfScaler);
+    if (FAILED(hr))
+        return hr;
+
+    if (memcmp(&pfScaler, &GUID_WICPixelFormat128bppRGBAFloat, sizeof(WICPixelFormatGUID)) == 0)
+    {
+        return StoreBitmapSourceBands(scaler.Get(), destImage);
+    }
+
+    // The WIC bitmap scaler is free to return a different pixel format than the source image, so here we
+    // convert it back
+    ComPtr<IWICFormatConverter> FC;
+    hr = pWIC->CreateFormatConverter(FC.GetAddressOf());
+    if (FAILED(hr))
+        return hr;
+
+    BOOL canConvert = FALSE;
+    hr = FC->CanConvert(pfScaler, GUID_WICPixelFormat128bppRGBAFloat, &canConvert);
+    if (FAILED(hr) || !canConvert)
+    {
+        return E_UNEXPECTED;
+    }
+
+    hr = FC->Initialize(scaler.Get(), GUID_WICPixelFormat128bppRGBAFloat, GetWICDither(filter), nullptr,
+        0, WICBitmapPaletteTypeMedianCut);
+    if (FAILED(hr))
+        return hr;
+
+    return StoreBitmapSourceBands(FC.Get(), destImage);
+}
 #endif // WIN32
 
 namespace
@@ -842,47 +1132,139 @@ namespace
 
         return S_OK;
     }
-#endif // WIN32
 
-
-    //-------------------------------------------------------------------------------------
-    // Generate (1D/2D) mip-map helpers (custom filtering)
-    //-------------------------------------------------------------------------------------
-    HRESULT Setup2DMips(
-        _In_reads_(nimages) const Image* baseImages,
-        _In_ size_t nimages,
-        _In_ const TexMetadata& mdata,
-        _Out_ ScratchImage& mipChain) noexcept
+    //--- mipmap (1D/2D) generation using WIC for formats it doesn't support directly ---
+    HRESULT GenerateMipMapsViaR32G32B32A32UsingWIC(
+        _In_ const Image& baseImage,
+        _In_ TEX_FILTER_FLAGS filter,
+        _In_ size_t levels,
+        _In_ const ScratchImage& mipChain,
+        _In_ size_t item) noexcept
     {
-        if (!baseImages || !nimages)
-            return E_INVALIDARG;
+        assert(levels > 1);
+        assert(baseImage.format != DXGI_FORMAT_R32G32B32A32_FLOAT);
 
-        assert(mdata.mipLevels > 1);
-        assert(mdata.arraySize == nimages);
-        assert(mdata.depth == 1 && mdata.dimension != TEX_DIMENSION_TEXTURE3D);
-        assert(mdata.width == baseImages[0].width);
-        assert(mdata.height == baseImages[0].height);
-        assert(mdata.format == baseImages[0].format);
+        if (!baseImage.pixels || !mipChain.GetPixels())
+            return E_POINTER;
 
-        HRESULT hr = mipChain.Initialize(mdata);
-        if (FAILED(hr))
-            return hr;
+        // Copy base image to top miplevel
+        const Image *img0 = mipChain.GetImage(0, item, 0);
+        if (!img0)
+            return E_POINTER;
 
-        // Copy base image(s) to top of mip chain
-        for (size_t item = 0; item < nimages; ++item)
+        uint8_t* pDest = img0->pixels;
+        if (!pDest)
+            return E_POINTER;
+
+        const uint8_t *pSrc = baseImage.pixels;
+        for (size_t h = 0; h < baseImage.height; ++h)
         {
-            const Image& src = baseImages[item];
+            const size_t msize = std::min<size_t>(img0->rowPitch, baseImage.rowPitch);
+            memcpy_s(pDest, img0->rowPitch, pSrc, msize);
+            pSrc += baseImage.rowPitch;
+            pDest += img0->rowPitch;
+        }
 
-            const Image *dest = mipChain.GetImage(0, item, 0);
-            if (!dest)
-            {
-                mipChain.Release();
+        if (filter & TEX_FILTER_SEPARATE_ALPHA)
+        {
+            // Separate color and alpha resizing works on whole WIC bitmaps, so this item still needs a float copy
+            ScratchImage temp;
+            HRESULT hr = ConvertToR32G32B32A32(baseImage, temp);
+            if (FAILED(hr))
+                return hr;
+
+            const Image *timg = temp.GetImage(0, 0, 0);
+            if (!timg)
                 return E_POINTER;
-            }
 
-            assert(src.format == dest->format);
+            ScratchImage tMipChain;
+            hr = tMipChain.Initialize2D(DXGI_FORMAT_R32G32B32A32_FLOAT, baseImage.width, baseImage.height, 1, levels);
+            if (FAILED(hr))
+                return hr;
 
-            uint8_t* pDest = dest->pixels;
+            hr = GenerateMipMapsUsingWIC(*timg, filter, levels, GUID_WICPixelFormat128bppRGBAFloat, tMipChain, 0);
+            if (FAILED(hr))
+                return hr;
+
+            temp.Release();
+
+            for (size_t level = 1; level < levels; ++level)
+            {
+                const Image *timgLevel = tMipChain.GetImage(level, 0, 0);
+                const Image *img = mipChain.GetImage(level, item, 0);
+                if (!timgLevel || !img)
+                    return E_POINTER;
+
+                hr = ConvertFromR32G32B32A32(*timgLevel, *img);
+                if (FAILED(hr))
+                    return hr;
+            }
+
+            return S_OK;
+        }
+
+        bool iswic2 = false;
+        auto pWIC = GetWICFactory(iswic2);
+        if (!pWIC)
+            return E_NOINTERFACE;
+
+        // Resize base image to each target mip level, decoding source rows as WIC requests them
+        for (size_t level = 1; level < levels; ++level)
+        {
+            const Image *img = mipChain.GetImage(level, item, 0);
+            if (!img)
+                return E_POINTER;
+
+            assert(img->format == baseImage.format);
+
+            HRESULT hr = ResizeViaR32G32B32A32UsingWIC(pWIC, baseImage, filter, *img);
+            if (FAILED(hr))
+                return hr;
+        }
+
+        return S_OK;
+    }
+#endif // WIN32
+
+
+    //-------------------------------------------------------------------------------------
+    // Generate (1D/2D) mip-map helpers (custom filtering)
+    //-------------------------------------------------------------------------------------
+    HRESULT Setup2DMips(
+        _In_reads_(nimages) const Image* baseImages,
+        _In_ size_t nimages,
+        _In_ const TexMetadata& mdata,
+        _Out_ ScratchImage& mipChain) noexcept
+    {
+        if (!baseImages || !nimages)
+            return E_INVALIDARG;
+
+        assert(mdata.mipLevels > 1);
+        assert(mdata.arraySize == nimages);
+        assert(mdata.depth == 1 && mdata.dimension != TEX_DIMENSION_TEXTURE3D);
+        assert(mdata.width == baseImages[0].width);
+        assert(mdata.height == baseImages[0].height);
+        assert(mdata.format == baseImages[0].format);
+
+        HRESULT hr = mipChain.Initialize(mdata);
+        if (FAILED(hr))
+            return hr;
+
+        // Copy base image(s) to top of mip chain
+        for (size_t item = 0; item < nimages; ++item)
+        {
+            const Image& src = baseImages[item];
+
+            const Image *dest = mipChain.GetImage(0, item, 0);
+            if (!dest)
+            {
+                mipChain.Release();
+                return E_POINTER;
+            }
+
+            assert(src.format == dest->format);
+
+            uint8_t* pDest = dest->pixels;
             if (!pDest)
             {
                 mipChain.Release();
@@ -903,299 +1285,839 @@ namespace
         return S_OK;
     }
 
-    //--- 2D Point Filter ---
-    HRESULT Generate2DMipsPointFilter(size_t levels, const ScratchImage& mipChain, size_t item) noexcept
+    // Box filter footprint of output 'i' along an axis reduced from 'n' to 'm' texels: returns the
+    // first tap. Even axes average two texels. Odd axes (n = 2m + 1) use the polyphase weights
+    // (m - i)/n, m/n, (i + 1)/n over three texels, so every source texel contributes exactly 1/n.
+    size_t GetBoxTaps(size_t n, size_t m, size_t i, float& w0, float& w1, float& w2) noexcept
     {
-        if (!mipChain.GetImages())
-            return E_INVALIDARG;
+        if (n <= 1)
+        {
+            w0 = 1.f;
+            w1 = w2 = 0.f;
+            return 0;
+        }
 
-        // This assumes that the base image is already placed into the mipChain at the top level... (see _Setup2DMips)
+        if (!(n & 1))
+        {
+            w0 = w1 = 0.5f;
+            w2 = 0.f;
+            return i * 2;
+        }
 
-        assert(levels > 1);
+        assert(m == (n >> 1));
+        const float scale = 1.f / float(n);
+        w0 = float(m - i) * scale;
+        w1 = float(m) * scale;
+        w2 = float(i + 1) * scale;
+        return i * 2;
+    }
 
-        size_t width = mipChain.GetMetadata().width;
-        size_t height = mipChain.GetMetadata().height;
+    //-------------------------------------------------------------------------------------
+    // Single-sweep 2D mip chain generation (box, linear, and cubic filters)
+    //
+    // The base level is read once, top to bottom. Each level keeps a ring of the last four
+    // rows of its parent, already filtered horizontally. As soon as every row under an
+    // output row has arrived, it is filtered vertically, stored, and passed down to the
+    // next level while still in float. Only a few rows per level are live, so the whole
+    // pyramid stays in cache, and lower levels are built from unquantized values instead
+    // of re-reading the stored level above.
+    //
+    // Vertical taps must not reach back beyond the rows already seen, which rules out
+    // cubic filtering with TEX_FILTER_WRAP_V (the first row needs the last one).
+    //
+    // A sweep can also own just one horizontal band of every level. It then reads only
+    // the base rows under that band (plus the filter overlap), computes but does not store
+    // the overlap rows, and produces exactly the values a full sweep would. The same goes
+    // for UpdateMipMaps, where each level owns the texels that depend on a dirty rectangle
+    // of the base; columns are narrowed too when pixels start on byte boundaries.
+    //-------------------------------------------------------------------------------------
+    enum MIP_SWEEP_FILTER
+    {
+        MIP_SWEEP_BOX,
+        MIP_SWEEP_LINEAR,
+        MIP_SWEEP_CUBIC,
+    };
 
-        // Allocate temporary space (2 scanlines)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 2);
-        if (!scanline)
-            return E_OUTOFMEMORY;
+    class MipSweep2D
+    {
+    public:
+        MipSweep2D(MIP_SWEEP_FILTER type, TEX_FILTER_FLAGS filter) noexcept :
+            m_type(type),
+            m_filter(filter),
+            m_count(0),
+            m_bytesPerPixel(0)
+        {
+        }
 
-        XMVECTOR* target = scanline.get();
+        MipSweep2D(MipSweep2D&&) = delete;
+        MipSweep2D& operator= (MipSweep2D&&) = delete;
 
-        XMVECTOR* row = target + width;
+        MipSweep2D(MipSweep2D const&) = delete;
+        MipSweep2D& operator= (MipSweep2D const&) = delete;
 
-        // Resize base image to each target mip level
-        for (size_t level = 1; level < levels; ++level)
+        HRESULT Generate(size_t levels, const ScratchImage& mipChain, size_t item, size_t band = 0, size_t bands = 1) noexcept
         {
-        #ifdef _DEBUG
-            memset(row, 0xCD, sizeof(XMVECTOR)*width);
-        #endif
+            assert(band < bands);
+            return Sweep(levels, mipChain, item, band, bands, nullptr, nullptr);
+        }
 
-            // 2D point filter
-            const Image* src = mipChain.GetImage(level - 1, item, 0);
-            const Image* dest = mipChain.GetImage(level, item, 0);
+        // Recomputes only the texels of each level that depend on 'dirty' in level 0, and reports
+        // their extent in 'dirtyLevels' (one entry per level)
+        HRESULT Update(size_t levels, const ScratchImage& mipChain, size_t item, const Rect& dirty, Rect* dirtyLevels) noexcept
+        {
+            assert(dirtyLevels != nullptr);
+            return Sweep(levels, mipChain, item, 0, 1, &dirty, dirtyLevels);
+        }
 
-            if (!src || !dest)
-                return E_POINTER;
+    private:
+        struct Level
+        {
+            const Image*    dest;
+            size_t          width;
+            size_t          height;
+            size_t          srcWidth;
+            size_t          srcHeight;
+            size_t          rowStart;   // Rows computed by this sweep
+            size_t          rowEnd;
+            size_t          ownStart;   // Rows stored by this sweep
+            size_t          ownEnd;
+            size_t          colStart;   // Columns computed by this sweep
+            size_t          colEnd;
+            size_t          ownColStart;// Columns stored by this sweep
+            size_t          ownColEnd;
+            size_t          nextRow;    // Next output row waiting on parent rows
+            size_t          filterX;    // Offsets of this level's filter tables
+            size_t          filterY;
+            XMVECTOR*       ring[4];    // Horizontally filtered parent rows, indexed by (row & 3)
+            XMVECTOR*       target;
+            XMVECTOR*       store;      // StoreScanlineLinear modifies its input, so it gets a copy
+        };
+
+        HRESULT Sweep(size_t levels, const ScratchImage& mipChain, size_t item, size_t band, size_t bands,
+            const Rect* dirty, Rect* dirtyLevels) noexcept
+        {
+            using namespace DirectX::Filters;
 
-            const uint8_t* pSrc = src->pixels;
-            uint8_t* pDest = dest->pixels;
+            assert(levels > 1);
 
-            const size_t rowPitch = src->rowPitch;
+            const Image* base = mipChain.GetImage(0, item, 0);
+            if (!base || !base->pixels)
+                return E_POINTER;
 
-            const size_t nwidth = (width > 1) ? (width >> 1) : 1;
-            const size_t nheight = (height > 1) ? (height >> 1) : 1;
+            m_level.reset(new (std::nothrow) Level[levels]);
+            if (!m_level)
+                return E_OUTOFMEMORY;
 
-            const size_t xinc = (width << 16) / nwidth;
-            const size_t yinc = (height << 16) / nheight;
+            m_count = levels;
 
-            size_t lasty = size_t(-1);
+            // Partial rows can only be loaded and stored when every pixel starts on a byte boundary
+            const size_t bpp = BitsPerPixel(base->format);
+            m_bytesPerPixel = (!IsPacked(base->format) && bpp >= 8 && !(bpp & 7)) ? (bpp / 8) : 0;
 
-            size_t sy = 0;
-            for (size_t y = 0; y < nheight; ++y)
+            // Lay out the scanlines and filter tables for every level
+            uint64_t scanlines = base->width;
+            size_t tables = 0;
+            for (size_t level = 1; level < levels; ++level)
             {
-                if ((lasty ^ sy) >> 16)
-                {
-                    if (!LoadScanline(row, width, pSrc + (rowPitch * (sy >> 16)), rowPitch, src->format))
-                        return E_FAIL;
-                    lasty = sy;
-                }
+                const Image* dest = mipChain.GetImage(level, item, 0);
+                if (!dest || !dest->pixels)
+                    return E_POINTER;
 
-                size_t sx = 0;
-                for (size_t x = 0; x < nwidth; ++x)
-                {
-                    target[x] = row[sx >> 16];
-                    sx += xinc;
-                }
+                const Image* src = mipChain.GetImage(level - 1, item, 0);
 
-                if (!StoreScanline(pDest, dest->rowPitch, dest->format, target, nwidth))
-                    return E_FAIL;
-                pDest += dest->rowPitch;
+                Level& lv = m_level[level];
+                lv.dest = dest;
+                lv.width = dest->width;
+                lv.height = dest->height;
+                lv.srcWidth = src->width;
+                lv.srcHeight = src->height;
 
-                sy += yinc;
+                scanlines += uint64_t(lv.width) * 6;
+                tables += lv.width + lv.height;
             }
 
-            if (height > 1)
-                height >>= 1;
+            auto scanline = make_ScratchArrayXMVECTOR(scanlines);
+            if (!scanline)
+                return E_OUTOFMEMORY;
 
-            if (width > 1)
-                width >>= 1;
-        }
+            switch (m_type)
+            {
+            case MIP_SWEEP_LINEAR:
+                m_linear.reset(new (std::nothrow) LinearFilter[tables]);
+                if (!m_linear)
+                    return E_OUTOFMEMORY;
+                break;
 
-        return S_OK;
-    }
+            case MIP_SWEEP_CUBIC:
+                m_cubic.reset(new (std::nothrow) CubicFilter[tables]);
+                if (!m_cubic)
+                    return E_OUTOFMEMORY;
+                break;
 
+            default:
+                break;
+            }
 
-    //--- 2D Box Filter ---
-    HRESULT Generate2DMipsBoxFilter(size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain, size_t item) noexcept
-    {
-        using namespace DirectX::Filters;
+            XMVECTOR* row = scanline.get();
+            XMVECTOR* next = row + base->width;
+            size_t table = 0;
+            for (size_t level = 1; level < levels; ++level)
+            {
+                Level& lv = m_level[level];
 
-        if (!mipChain.GetImages())
-            return E_INVALIDARG;
+                for (size_t j = 0; j < 4; ++j, next += lv.width)
+                {
+                    lv.ring[j] = next;
+                }
 
-        // This assumes that the base image is already placed into the mipChain at the top level... (see _Setup2DMips)
+                lv.target = next;
+                next += lv.width;
 
-        assert(levels > 1);
+                lv.store = next;
+                next += lv.width;
 
-        size_t width = mipChain.GetMetadata().width;
-        size_t height = mipChain.GetMetadata().height;
+                lv.filterX = table;
+                lv.filterY = table + lv.width;
+                table += lv.width + lv.height;
 
-        if (!ispow2(width) || !ispow2(height))
-            return E_FAIL;
+                if (m_type == MIP_SWEEP_LINEAR)
+                {
+                    CreateLinearFilter(lv.srcWidth, lv.width, (m_filter & TEX_FILTER_WRAP_U) != 0, &m_linear[lv.filterX]);
+                    CreateLinearFilter(lv.srcHeight, lv.height, (m_filter & TEX_FILTER_WRAP_V) != 0, &m_linear[lv.filterY]);
+                }
+                else if (m_type == MIP_SWEEP_CUBIC)
+                {
+                    assert(!(m_filter & TEX_FILTER_WRAP_V));
+                    CreateCubicFilter(lv.srcWidth, lv.width, (m_filter & TEX_FILTER_WRAP_U) != 0, (m_filter & TEX_FILTER_MIRROR_U) != 0, &m_cubic[lv.filterX]);
+                    CreateCubicFilter(lv.srcHeight, lv.height, false, (m_filter & TEX_FILTER_MIRROR_V) != 0, &m_cubic[lv.filterY]);
+                }
+            }
 
-        // Allocate temporary space (3 scanlines)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 3);
-        if (!scanline)
-            return E_OUTOFMEMORY;
+            // Decide which rows and columns of each level this sweep stores
+            if (dirty)
+            {
+                // Follow the dirty texels down the chain: a level stores every texel with a tap
+                // on a dirty texel of its parent
+                size_t x0 = dirty->x;
+                size_t x1 = dirty->x + dirty->w;
+                size_t y0 = dirty->y;
+                size_t y1 = dirty->y + dirty->h;
+
+                dirtyLevels[0] = *dirty;
+                for (size_t level = 1; level < levels; ++level)
+                {
+                    Level& lv = m_level[level];
 
-        XMVECTOR* target = scanline.get();
+                    if (x0 < x1 && y0 < y1)
+                    {
+                        GetAffected(lv, false, x0, x1);
+                        GetAffected(lv, true, y0, y1);
+                    }
+
+                    if (x0 >= x1 || y0 >= y1)
+                    {
+                        // Nothing below this level changes
+                        for (size_t j = level; j < levels; ++j)
+                        {
+                            dirtyLevels[j] = Rect(0, 0, 0, 0);
+                        }
+                        m_count = level;
+                        break;
+                    }
 
-        XMVECTOR* urow0 = target + width;
-        XMVECTOR* urow1 = target + width * 2;
+                    dirtyLevels[level] = Rect(x0, y0, x1 - x0, y1 - y0);
 
-        const XMVECTOR* urow2 = urow0 + 1;
-        const XMVECTOR* urow3 = urow1 + 1;
+                    lv.ownStart = y0;
+                    lv.ownEnd = y1;
+                    lv.ownColStart = (m_bytesPerPixel) ? x0 : 0;
+                    lv.ownColEnd = (m_bytesPerPixel) ? x1 : lv.width;
+                }
 
-        // Resize base image to each target mip level
-        for (size_t level = 1; level < levels; ++level)
-        {
-            if (height <= 1)
+                if (m_count < 2)
+                    return S_OK;
+            }
+            else
             {
-                urow1 = urow0;
+                for (size_t level = 1; level < levels; ++level)
+                {
+                    Level& lv = m_level[level];
+                    lv.ownStart = lv.height * band / bands;
+                    lv.ownEnd = lv.height * (band + 1) / bands;
+                    lv.ownColStart = 0;
+                    lv.ownColEnd = lv.width;
+                }
             }
 
-            if (width <= 1)
+            // Work out the rows and columns each level needs, from the bottom of the chain up: the
+            // ones this sweep stores, plus the parent texels under the ones needed by the level below
+            size_t needStart = 0;
+            size_t needEnd = 0;
+            size_t needColStart = 0;
+            size_t needColEnd = 0;
+            for (size_t level = m_count - 1; level > 0; --level)
             {
-                urow2 = urow0;
-                urow3 = urow1;
+                Level& lv = m_level[level];
+
+                GetNeeded(lv.ownStart, lv.ownEnd, needStart, needEnd, lv.rowStart, lv.rowEnd);
+                GetNeeded(lv.ownColStart, lv.ownColEnd, needColStart, needColEnd, lv.colStart, lv.colEnd);
+
+                lv.nextRow = lv.rowStart;
+
+                GetTapHull(lv, true, lv.rowStart, lv.rowEnd, needStart, needEnd);
+                GetTapHull(lv, false, lv.colStart, lv.colEnd, needColStart, needColEnd);
             }
 
-            // 2D box filter
-            const Image* src = mipChain.GetImage(level - 1, item, 0);
-            const Image* dest = mipChain.GetImage(level, item, 0);
+            // Sweep the base level once
+            const bool partialRow = (m_bytesPerPixel > 0) && (needColStart > 0 || needColEnd < base->width);
 
-            if (!src || !dest)
-                return E_POINTER;
+            const uint8_t* pSrc = base->pixels + needStart * base->rowPitch;
+            for (size_t y = needStart; y < needEnd; ++y, pSrc += base->rowPitch)
+            {
+                const bool ok = (partialRow)
+                    ? LoadScanlineLinear(row + needColStart, needColEnd - needColStart,
+                        pSrc + needColStart * m_bytesPerPixel, (needColEnd - needColStart) * m_bytesPerPixel, base->format, m_filter)
+                    : LoadScanlineLinear(row, base->width, pSrc, base->rowPitch, base->format, m_filter);
+                if (!ok)
+                    return E_FAIL;
 
-            const uint8_t* pSrc = src->pixels;
-            uint8_t* pDest = dest->pixels;
+                const HRESULT hr = Push(1, y, row);
+                if (FAILED(hr))
+                    return hr;
+            }
 
-            const size_t rowPitch = src->rowPitch;
+        #ifdef _DEBUG
+            for (size_t level = 1; level < m_count; ++level)
+            {
+                assert(m_level[level].nextRow == m_level[level].rowEnd);
+            }
+        #endif
 
-            const size_t nwidth = (width > 1) ? (width >> 1) : 1;
-            const size_t nheight = (height > 1) ? (height >> 1) : 1;
+            return S_OK;
+        }
 
-            for (size_t y = 0; y < nheight; ++y)
+        // Range of parent texels read by output texel 'i' along one axis
+        void GetTaps(const Level& lv, bool vertical, size_t i, size_t& lo, size_t& hi) const noexcept
+        {
+            const size_t filter = (vertical ? lv.filterY : lv.filterX) + i;
+
+            switch (m_type)
             {
-                if (!LoadScanlineLinear(urow0, width, pSrc, rowPitch, src->format, filter))
-                    return E_FAIL;
-                pSrc += rowPitch;
+            case MIP_SWEEP_LINEAR:
+                {
+                    const auto& to = m_linear[filter];
+                    lo = std::min(to.u0, to.u1);
+                    hi = std::max(to.u0, to.u1);
+                }
+                break;
 
-                if (urow0 != urow1)
+            case MIP_SWEEP_CUBIC:
                 {
-                    if (!LoadScanlineLinear(urow1, width, pSrc, rowPitch, src->format, filter))
-                        return E_FAIL;
-                    pSrc += rowPitch;
+                    const auto& to = m_cubic[filter];
+                    lo = std::min(std::min(to.u0, to.u1), std::min(to.u2, to.u3));
+                    hi = std::max(std::max(to.u0, to.u1), std::max(to.u2, to.u3));
                 }
+                break;
 
-                for (size_t x = 0; x < nwidth; ++x)
+            default:
                 {
-                    const size_t x2 = x << 1;
+                    const size_t n = vertical ? lv.srcHeight : lv.srcWidth;
+                    const size_t m = vertical ? lv.height : lv.width;
 
-                    AVERAGE4(target[x], urow0[x2], urow1[x2], urow2[x2], urow3[x2])
+                    float w0, w1, w2;
+                    lo = GetBoxTaps(n, m, i, w0, w1, w2);
+                    hi = lo + ((n > 1) ? ((n & 1) ? 2 : 1) : 0);
                 }
-
-                if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
-                    return E_FAIL;
-                pDest += dest->rowPitch;
+                break;
             }
-
-            if (height > 1)
-                height >>= 1;
-
-            if (width > 1)
-                width >>= 1;
         }
 
-        return S_OK;
-    }
+        // Hull of the parent texels read by outputs [start, end)
+        void GetTapHull(const Level& lv, bool vertical, size_t start, size_t end, size_t& lo, size_t& hi) const noexcept
+        {
+            lo = hi = 0;
+            for (size_t i = start; i < end; ++i)
+            {
+                size_t tlo, thi;
+                GetTaps(lv, vertical, i, tlo, thi);
+                if (i == start)
+                {
+                    lo = tlo;
+                    hi = thi + 1;
+                }
+                else
+                {
+                    lo = std::min(lo, tlo);
+                    hi = std::max(hi, thi + 1);
+                }
+            }
+        }
 
+        // Narrows parent range [start, end) to the hull of the outputs with a tap inside it
+        void GetAffected(const Level& lv, bool vertical, size_t& start, size_t& end) const noexcept
+        {
+            const size_t count = vertical ? lv.height : lv.width;
 
-    //--- 2D Linear Filter ---
-    HRESULT Generate2DMipsLinearFilter(size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain, size_t item) noexcept
-    {
-        using namespace DirectX::Filters;
+            bool any = false;
+            size_t first = 0;
+            size_t last = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                size_t lo, hi;
+                GetTaps(lv, vertical, i, lo, hi);
 
-        if (!mipChain.GetImages())
-            return E_INVALIDARG;
+                // Wrapped taps can straddle the parent range without touching it, so each one is checked
+                if (lo < end && hi >= start && HasTapIn(lv, vertical, i, start, end))
+                {
+                    if (!any)
+                    {
+                        first = i;
+                        any = true;
+                    }
+                    last = i + 1;
+                }
+            }
 
-        // This assumes that the base image is already placed into the mipChain at the top level... (see _Setup2DMips)
+            start = first;
+            end = last;
+        }
 
-        assert(levels > 1);
+        bool HasTapIn(const Level& lv, bool vertical, size_t i, size_t start, size_t end) const noexcept
+        {
+            const size_t filter = (vertical ? lv.filterY : lv.filterX) + i;
 
-        size_t width = mipChain.GetMetadata().width;
-        size_t height = mipChain.GetMetadata().height;
+            switch (m_type)
+            {
+            case MIP_SWEEP_LINEAR:
+                {
+                    const auto& to = m_linear[filter];
+                    return (to.u0 >= start && to.u0 < end) || (to.u1 >= start && to.u1 < end);
+                }
 
-        // Allocate temporary space (3 scanlines, plus X and Y filters)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 3);
-        if (!scanline)
-            return E_OUTOFMEMORY;
-
-        std::unique_ptr<LinearFilter[]> lf(new (std::nothrow) LinearFilter[width + height]);
-        if (!lf)
-            return E_OUTOFMEMORY;
-
-        LinearFilter* lfX = lf.get();
-        LinearFilter* lfY = lf.get() + width;
+            case MIP_SWEEP_CUBIC:
+                {
+                    const auto& to = m_cubic[filter];
+                    return (to.u0 >= start && to.u0 < end) || (to.u1 >= start && to.u1 < end)
+                        || (to.u2 >= start && to.u2 < end) || (to.u3 >= start && to.u3 < end);
+                }
 
-        XMVECTOR* target = scanline.get();
+            default:
+                // Box taps are contiguous
+                return true;
+            }
+        }
 
-        XMVECTOR* row0 = target + width;
-        XMVECTOR* row1 = target + width * 2;
+        // Union of the texels a level stores with the ones the level below needs from it
+        static void GetNeeded(size_t ownStart, size_t ownEnd, size_t needStart, size_t needEnd, size_t& start, size_t& end) noexcept
+        {
+            start = ownStart;
+            end = ownEnd;
+            if (needStart < needEnd)
+            {
+                if (start >= end)
+                {
+                    start = needStart;
+                    end = needEnd;
+                }
+                else
+                {
+                    start = std::min(start, needStart);
+                    end = std::max(end, needEnd);
+                }
+            }
+        }
 
-        // Resize base image to each target mip level
-        for (size_t level = 1; level < levels; ++level)
+        // Accepts parent row 'row' for 'level', emitting every output row it completes
+        HRESULT Push(size_t level, size_t row, const XMVECTOR* pixels) noexcept
         {
-            // 2D linear filter
-            const Image* src = mipChain.GetImage(level - 1, item, 0);
-            const Image* dest = mipChain.GetImage(level, item, 0);
+            using namespace DirectX::Filters;
 
-            if (!src || !dest)
-                return E_POINTER;
+            Level& lv = m_level[level];
 
-            const uint8_t* pSrc = src->pixels;
-            uint8_t* pDest = dest->pixels;
+            XMVECTOR* hrow = lv.ring[row & 3];
+            switch (m_type)
+            {
+            case MIP_SWEEP_LINEAR:
+                {
+                    const LinearFilter* lfX = &m_linear[lv.filterX];
+                    for (size_t x = lv.colStart; x < lv.colEnd; ++x)
+                    {
+                        const auto& toX = lfX[x];
+                        hrow[x] = XMVectorAdd(XMVectorScale(pixels[toX.u0], toX.weight0), XMVectorScale(pixels[toX.u1], toX.weight1));
+                    }
+                }
+                break;
 
-            const size_t rowPitch = src->rowPitch;
+            case MIP_SWEEP_CUBIC:
+                CubicFilterRow(hrow + lv.colStart, lv.colEnd - lv.colStart, pixels, &m_cubic[lv.filterX + lv.colStart]);
+                break;
 
-            const size_t nwidth = (width > 1) ? (width >> 1) : 1;
-            CreateLinearFilter(width, nwidth, (filter & TEX_FILTER_WRAP_U) != 0, lfX);
+            default:
+                if (lv.srcWidth <= 1)
+                {
+                    hrow[0] = pixels[0];
+                }
+                else if (!(lv.srcWidth & 1))
+                {
+                    for (size_t x = lv.colStart; x < lv.colEnd; ++x)
+                    {
+                        hrow[x] = XMVectorMultiply(XMVectorAdd(pixels[x * 2], pixels[x * 2 + 1]), g_XMOneHalf);
+                    }
+                }
+                else
+                {
+                    for (size_t x = lv.colStart; x < lv.colEnd; ++x)
+                    {
+                        float w0, w1, w2;
+                        const size_t u0 = GetBoxTaps(lv.srcWidth, lv.width, x, w0, w1, w2);
+                        hrow[x] = XMVectorAdd(XMVectorAdd(XMVectorScale(pixels[u0], w0), XMVectorScale(pixels[u0 + 1], w1)),
+                            XMVectorScale(pixels[u0 + 2], w2));
+                    }
+                }
+                break;
+            }
 
-            const size_t nheight = (height > 1) ? (height >> 1) : 1;
-            CreateLinearFilter(height, nheight, (filter & TEX_FILTER_WRAP_V) != 0, lfY);
+            for (; lv.nextRow < lv.rowEnd; ++lv.nextRow)
+            {
+                const size_t y = lv.nextRow;
 
-        #ifdef _DEBUG
-            memset(row0, 0xCD, sizeof(XMVECTOR)*width);
-            memset(row1, 0xDD, sizeof(XMVECTOR)*width);
-        #endif
+                switch (m_type)
+                {
+                case MIP_SWEEP_LINEAR:
+                    {
+                        const auto& toY = m_linear[lv.filterY + y];
+                        if (std::max(toY.u0, toY.u1) > row)
+                            return S_OK;
 
-            size_t u0 = size_t(-1);
-            size_t u1 = size_t(-1);
+                        const XMVECTOR* row0 = lv.ring[toY.u0 & 3];
+                        const XMVECTOR* row1 = lv.ring[toY.u1 & 3];
+                        for (size_t x = lv.colStart; x < lv.colEnd; ++x)
+                        {
+                            lv.target[x] = XMVectorAdd(XMVectorScale(row0[x], toY.weight0), XMVectorScale(row1[x], toY.weight1));
+                        }
+                    }
+                    break;
 
-            for (size_t y = 0; y < nheight; ++y)
-            {
-                const auto& toY = lfY[y];
+                case MIP_SWEEP_CUBIC:
+                    {
+                        const auto& toY = m_cubic[lv.filterY + y];
+                        if (std::max(std::max(toY.u0, toY.u1), std::max(toY.u2, toY.u3)) > row)
+                            return S_OK;
+
+                        const XMVECTOR* row0 = lv.ring[toY.u0 & 3];
+                        const XMVECTOR* row1 = lv.ring[toY.u1 & 3];
+                        const XMVECTOR* row2 = lv.ring[toY.u2 & 3];
+                        const XMVECTOR* row3 = lv.ring[toY.u3 & 3];
+                        for (size_t x = lv.colStart; x < lv.colEnd; ++x)
+                        {
+                            CUBIC_INTERPOLATE(lv.target[x], toY.x, row0[x], row1[x], row2[x], row3[x])
+                        }
+                    }
+                    break;
 
-                if (toY.u0 != u0)
-                {
-                    if (toY.u0 != u1)
+                default:
+                    if (lv.srcHeight <= 1)
                     {
-                        u0 = toY.u0;
+                        memcpy(lv.target + lv.colStart, lv.ring[0] + lv.colStart, sizeof(XMVECTOR) * (lv.colEnd - lv.colStart));
+                    }
+                    else if (!(lv.srcHeight & 1))
+                    {
+                        const size_t u0 = y * 2;
+                        if (u0 + 1 > row)
+                            return S_OK;
 
-                        if (!LoadScanlineLinear(row0, width, pSrc + (rowPitch * u0), rowPitch, src->format, filter))
-                            return E_FAIL;
+                        const XMVECTOR* row0 = lv.ring[u0 & 3];
+                        const XMVECTOR* row1 = lv.ring[(u0 + 1) & 3];
+                        for (size_t x = lv.colStart; x < lv.colEnd; ++x)
+                        {
+                            lv.target[x] = XMVectorMultiply(XMVectorAdd(row0[x], row1[x]), g_XMOneHalf);
+                        }
                     }
                     else
                     {
-                        u0 = u1;
-                        u1 = size_t(-1);
-
-                        std::swap(row0, row1);
+                        float w0, w1, w2;
+                        const size_t u0 = GetBoxTaps(lv.srcHeight, lv.height, y, w0, w1, w2);
+                        if (u0 + 2 > row)
+                            return S_OK;
+
+                        const XMVECTOR* row0 = lv.ring[u0 & 3];
+                        const XMVECTOR* row1 = lv.ring[(u0 + 1) & 3];
+                        const XMVECTOR* row2 = lv.ring[(u0 + 2) & 3];
+                        for (size_t x = lv.colStart; x < lv.colEnd; ++x)
+                        {
+                            lv.target[x] = XMVectorAdd(XMVectorAdd(XMVectorScale(row0[x], w0), XMVectorScale(row1[x], w1)),
+                                XMVectorScale(row2[x], w2));
+                        }
                     }
+                    break;
                 }
 
-                if (toY.u1 != u1)
+                if (y >= lv.ownStart && y < lv.ownEnd)
                 {
-                    u1 = toY.u1;
-
-                    if (!LoadScanlineLinear(row1, width, pSrc + (rowPitch * u1), rowPitch, src->format, filter))
+                    const size_t x0 = lv.ownColStart;
+                    const size_t count = lv.ownColEnd - x0;
+                    memcpy(lv.store + x0, lv.target + x0, sizeof(XMVECTOR) * count);
+
+                    uint8_t* pDest = lv.dest->pixels + lv.dest->rowPitch * y;
+                    const bool ok = (count < lv.width)
+                        ? StoreScanlineLinear(pDest + x0 * m_bytesPerPixel, count * m_bytesPerPixel, lv.dest->format,
+                            lv.store + x0, count, m_filter)
+                        : StoreScanlineLinear(pDest, lv.dest->rowPitch, lv.dest->format,
+                            lv.store, lv.width, m_filter);
+                    if (!ok)
                         return E_FAIL;
                 }
 
-                for (size_t x = 0; x < nwidth; ++x)
+                if (level + 1 < m_count)
+                {
+                    const HRESULT hr = Push(level + 1, y, lv.target);
+                    if (FAILED(hr))
+                        return hr;
+                }
+            }
+
+            return S_OK;
+        }
+
+        MIP_SWEEP_FILTER                                m_type;
+        TEX_FILTER_FLAGS                                m_filter;
+        size_t                                          m_count;
+        size_t                                          m_bytesPerPixel;    // 0 if rows can't be split
+        std::unique_ptr<Level[]>                        m_level;
+        std::unique_ptr<DirectX::Filters::LinearFilter[]>   m_linear;
+        std::unique_ptr<DirectX::Filters::CubicFilter[]>    m_cubic;
+    };
+
+
+#ifdef _OPENMP
+    // Smaller images are not worth the cost of starting a parallel region
+    constexpr uint64_t c_MinParallelMipPixels = 64 * 1024;
+
+    // Each band owns at least this many rows of the first mip level, which keeps the
+    // filter overlap recomputed by neighboring bands small
+    constexpr size_t c_MinMipBandRows = 16;
+
+    size_t GetMipBandCount(const Image& image, size_t rows) noexcept
+    {
+        if (uint64_t(image.width) * uint64_t(image.height) < c_MinParallelMipPixels)
+            return 1;
+
+        return std::max<size_t>(1, std::min<size_t>(rows, static_cast<size_t>(std::max(omp_get_max_threads(), 1))));
+    }
+#endif
+
+    HRESULT Generate2DMipsSweep(
+        MIP_SWEEP_FILTER type,
+        size_t levels,
+        TEX_FILTER_FLAGS filter,
+        const ScratchImage& mipChain,
+        size_t item) noexcept
+    {
+    #ifdef _OPENMP
+        if (filter & TEX_FILTER_PARALLEL)
+        {
+            const Image* base = mipChain.GetImage(0, item, 0);
+            if (!base)
+                return E_POINTER;
+
+            const size_t height1 = std::max<size_t>(1, base->height >> 1);
+            const size_t bands = GetMipBandCount(*base, height1 / c_MinMipBandRows);
+            if (bands > 1)
+            {
+                HRESULT result = S_OK;
+                bool fail = false;
+
+            #pragma omp parallel for shared(result, fail)
+                for (int band = 0; band < static_cast<int>(bands); ++band)
                 {
-                    const auto& toX = lfX[x];
+                #pragma omp flush (fail)
+                    if (fail)
+                    {
+                        // Short circuit the loop body if a failure has occurred.
+                        // OpenMP 2.0 does not support cancellation of a 'parallel for' loop.
+                        continue;
+                    }
 
-                    BILINEAR_INTERPOLATE(target[x], toX, toY, row0, row1)
+                    MipSweep2D sweep(type, filter);
+                    const HRESULT hr = sweep.Generate(levels, mipChain, item, size_t(band), bands);
+                    if (FAILED(hr))
+                    {
+                    #pragma omp critical
+                        {
+                            if (SUCCEEDED(result))
+                                result = hr;
+                        }
+                        fail = true;
+                    #pragma omp flush (fail)
+                    }
                 }
 
-                if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
+                return result;
+            }
+        }
+    #endif
+
+        MipSweep2D sweep(type, filter);
+        return sweep.Generate(levels, mipChain, item);
+    }
+
+
+    //--- 2D Point Filter ---
+    HRESULT Point2DRows(const Image& src, const Image& dest, size_t yStart, size_t yEnd) noexcept
+    {
+        const size_t width = src.width;
+        const size_t nwidth = dest.width;
+
+        // Allocate temporary space (2 scanlines)
+        auto scanline = make_ScratchArrayXMVECTOR(uint64_t(width) * 2);
+        if (!scanline)
+            return E_OUTOFMEMORY;
+
+        XMVECTOR* target = scanline.get();
+
+        XMVECTOR* row = target + width;
+
+    #ifdef _DEBUG
+        memset(row, 0xCD, sizeof(XMVECTOR)*width);
+    #endif
+
+        const uint8_t* pSrc = src.pixels;
+        uint8_t* pDest = dest.pixels + dest.rowPitch * yStart;
+
+        const size_t rowPitch = src.rowPitch;
+
+        const size_t xinc = (width << 16) / nwidth;
+        const size_t yinc = (src.height << 16) / dest.height;
+
+        size_t lasty = size_t(-1);
+
+        size_t sy = yinc * yStart;
+        for (size_t y = yStart; y < yEnd; ++y)
+        {
+            if ((lasty ^ sy) >> 16)
+            {
+                if (!LoadScanline(row, width, pSrc + (rowPitch * (sy >> 16)), rowPitch, src.format))
                     return E_FAIL;
-                pDest += dest->rowPitch;
+                lasty = sy;
             }
 
-            if (height > 1)
-                height >>= 1;
+            size_t sx = 0;
+            for (size_t x = 0; x < nwidth; ++x)
+            {
+                target[x] = row[sx >> 16];
+                sx += xinc;
+            }
 
-            if (width > 1)
-                width >>= 1;
+            if (!StoreScanline(pDest, dest.rowPitch, dest.format, target, nwidth))
+                return E_FAIL;
+            pDest += dest.rowPitch;
+
+            sy += yinc;
+        }
+
+        return S_OK;
+    }
+
+    HRESULT Generate2DMipsPointFilter(size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain, size_t item) noexcept
+    {
+        if (!mipChain.GetImages())
+            return E_INVALIDARG;
+
+        // This assumes that the base image is already placed into the mipChain at the top level... (see _Setup2DMips)
+
+        assert(levels > 1);
+
+    #ifndef _OPENMP
+        UNREFERENCED_PARAMETER(filter);
+    #endif
+
+        // Resize base image to each target mip level
+        for (size_t level = 1; level < levels; ++level)
+        {
+            // 2D point filter
+            const Image* src = mipChain.GetImage(level - 1, item, 0);
+            const Image* dest = mipChain.GetImage(level, item, 0);
+
+            if (!src || !dest)
+                return E_POINTER;
+
+        #ifdef _OPENMP
+            const size_t bands = (filter & TEX_FILTER_PARALLEL) ? GetMipBandCount(*src, dest->height) : 1;
+            if (bands > 1)
+            {
+                // Rows of a level are independent; the level is complete before the next one reads it
+                const size_t bandHeight = (dest->height + bands - 1) / bands;
+
+                HRESULT result = S_OK;
+                bool fail = false;
+
+            #pragma omp parallel for shared(result, fail)
+                for (int band = 0; band < static_cast<int>(bands); ++band)
+                {
+                #pragma omp flush (fail)
+                    if (fail)
+                    {
+                        continue;
+                    }
+
+                    const size_t yStart = std::min(size_t(band) * bandHeight, dest->height);
+                    const size_t yEnd = std::min(yStart + bandHeight, dest->height);
+
+                    const HRESULT hr = Point2DRows(*src, *dest, yStart, yEnd);
+                    if (FAILED(hr))
+                    {
+                    #pragma omp critical
+                        {
+                            if (SUCCEEDED(result))
+                                result = hr;
+                        }
+                        fail = true;
+                    #pragma omp flush (fail)
+                    }
+                }
+
+                if (FAILED(result))
+                    return result;
+
+                continue;
+            }
+        #endif
+
+            const HRESULT hr = Point2DRows(*src, *dest, 0, dest->height);
+            if (FAILED(hr))
+                return hr;
         }
 
         return S_OK;
     }
 
+
+    //--- 2D Box Filter ---
+    HRESULT Generate2DMipsBoxFilter(size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain, size_t item) noexcept
+    {
+        if (!mipChain.GetImages())
+            return E_INVALIDARG;
+
+        // This assumes that the base image is already placed into the mipChain at the top level... (see _Setup2DMips)
+
+        assert(levels > 1);
+
+        return Generate2DMipsSweep(MIP_SWEEP_BOX, levels, filter, mipChain, item);
+    }
+
+
+    //--- 2D Linear Filter ---
+    HRESULT Generate2DMipsLinearFilter(size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain, size_t item) noexcept
+    {
+        if (!mipChain.GetImages())
+            return E_INVALIDARG;
+
+        // This assumes that the base image is already placed into the mipChain at the top level... (see _Setup2DMips)
+
+        assert(levels > 1);
+
+        return Generate2DMipsSweep(MIP_SWEEP_LINEAR, levels, filter, mipChain, item);
+    }
+
     //--- 2D Cubic Filter ---
 #ifdef __clang__
 #pragma clang diagnostic ignored "-Wextra-semi-stmt"
@@ -1212,21 +2134,21 @@ namespace
 
         assert(levels > 1);
 
+        if (!(filter & TEX_FILTER_WRAP_V))
+        {
+            return Generate2DMipsSweep(MIP_SWEEP_CUBIC, levels, filter, mipChain, item);
+        }
+
+        // Wrapping vertically needs the last row of each level before its first, so build level by level
+
         size_t width = mipChain.GetMetadata().width;
         size_t height = mipChain.GetMetadata().height;
 
         // Allocate temporary space (5 scanlines, plus X and Y filters)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 5);
+        auto scanline = make_ScratchArrayXMVECTOR(uint64_t(width) * 5);
         if (!scanline)
             return E_OUTOFMEMORY;
 
-        std::unique_ptr<CubicFilter[]> cf(new (std::nothrow) CubicFilter[width + height]);
-        if (!cf)
-            return E_OUTOFMEMORY;
-
-        CubicFilter* cfX = cf.get();
-        CubicFilter* cfY = cf.get() + width;
-
         XMVECTOR* target = scanline.get();
 
         XMVECTOR* row0 = target + width;
@@ -1250,10 +2172,15 @@ namespace
             const size_t rowPitch = src->rowPitch;
 
             const size_t nwidth = (width > 1) ? (width >> 1) : 1;
-            CreateCubicFilter(width, nwidth, (filter & TEX_FILTER_WRAP_U) != 0, (filter & TEX_FILTER_MIRROR_U) != 0, cfX);
-
             const size_t nheight = (height > 1) ? (height >> 1) : 1;
-            CreateCubicFilter(height, nheight, (filter & TEX_FILTER_WRAP_V) != 0, (filter & TEX_FILTER_MIRROR_V) != 0, cfY);
+
+            const FilterTable tableX(FILTER_TABLE_CUBIC, width, nwidth, (filter & TEX_FILTER_WRAP_U) != 0, (filter & TEX_FILTER_MIRROR_U) != 0);
+            const FilterTable tableY(FILTER_TABLE_CUBIC, height, nheight, (filter & TEX_FILTER_WRAP_V) != 0, (filter & TEX_FILTER_MIRROR_V) != 0);
+            if (!tableX || !tableY)
+                return E_OUTOFMEMORY;
+
+            const CubicFilter* cfX = tableX.Cubic();
+            const CubicFilter* cfY = tableY.Cubic();
 
         #ifdef _DEBUG
             memset(row0, 0xCD, sizeof(XMVECTOR)*width);
@@ -1404,7 +2331,7 @@ namespace
         size_t height = mipChain.GetMetadata().height;
 
         // Allocate initial temporary space (1 scanline, accumulation rows, plus X and Y filters)
-        auto scanline = make_AlignedArrayXMVECTOR(width);
+        auto scanline = make_ScratchArrayXMVECTOR(width);
         if (!scanline)
             return E_OUTOFMEMORY;
 
@@ -1414,8 +2341,6 @@ namespace
 
         TriangleRow * rowFree = nullptr;
 
-        std::unique_ptr<Filter> tfX, tfY;
-
         XMVECTOR* row = scanline.get();
 
         // Resize base image to each target mip level
@@ -1435,24 +2360,25 @@ namespace
             uint8_t* pDest = dest->pixels;
 
             const size_t nwidth = (width > 1) ? (width >> 1) : 1;
-            HRESULT hr = CreateTriangleFilter(width, nwidth, (filter & TEX_FILTER_WRAP_U) != 0, tfX);
-            if (FAILED(hr))
-                return hr;
-
             const size_t nheight = (height > 1) ? (height >> 1) : 1;
-            hr = CreateTriangleFilter(height, nheight, (filter & TEX_FILTER_WRAP_V) != 0, tfY);
-            if (FAILED(hr))
-                return hr;
+
+            const FilterTable tableX(FILTER_TABLE_TRIANGLE, width, nwidth, (filter & TEX_FILTER_WRAP_U) != 0);
+            const FilterTable tableY(FILTER_TABLE_TRIANGLE, height, nheight, (filter & TEX_FILTER_WRAP_V) != 0);
+            if (!tableX || !tableY)
+                return E_OUTOFMEMORY;
+
+            const Filter* tfX = tableX.Triangle();
+            const Filter* tfY = tableY.Triangle();
 
         #ifdef _DEBUG
             memset(row, 0xCD, sizeof(XMVECTOR)*width);
         #endif
 
-            auto xFromEnd = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(tfX.get()) + tfX->sizeInBytes);
-            auto yFromEnd = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(tfY.get()) + tfY->sizeInBytes);
+            auto xFromEnd = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(tfX) + tfX->sizeInBytes);
+            auto yFromEnd = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(tfY) + tfY->sizeInBytes);
 
             // Count times rows get written (and clear out any leftover accumulation rows from last miplevel)
-            for (FilterFrom* yFrom = tfY->from; yFrom < yFromEnd; )
+            for (auto yFrom = tfY->from; yFrom < yFromEnd; )
             {
                 for (size_t j = 0; j < yFrom->count; ++j)
                 {
@@ -1468,11 +2394,11 @@ namespace
                     }
                 }
 
-                yFrom = reinterpret_cast<FilterFrom*>(reinterpret_cast<uint8_t*>(yFrom) + yFrom->sizeInBytes);
+                yFrom = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(yFrom) + yFrom->sizeInBytes);
             }
 
             // Filter image
-            for (FilterFrom* yFrom = tfY->from; yFrom < yFromEnd; )
+            for (auto yFrom = tfY->from; yFrom < yFromEnd; )
             {
                 // Create accumulation rows as needed
                 for (size_t j = 0; j < yFrom->count; ++j)
@@ -1514,7 +2440,7 @@ namespace
 
                 // Process row
                 size_t x = 0;
-                for (FilterFrom* xFrom = tfX->from; xFrom < xFromEnd; ++x)
+                for (auto xFrom = tfX->from; xFrom < xFromEnd; ++x)
                 {
                     for (size_t j = 0; j < yFrom->count; ++j)
                     {
@@ -1538,7 +2464,7 @@ namespace
                         }
                     }
 
-                    xFrom = reinterpret_cast<FilterFrom*>(reinterpret_cast<uint8_t*>(xFrom) + xFrom->sizeInBytes);
+                    xFrom = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(xFrom) + xFrom->sizeInBytes);
                 }
 
                 // Write completed accumulation rows
@@ -1588,7 +2514,7 @@ namespace
                     }
                 }
 
-                yFrom = reinterpret_cast<FilterFrom*>(reinterpret_cast<uint8_t*>(yFrom) + yFrom->sizeInBytes);
+                yFrom = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(yFrom) + yFrom->sizeInBytes);
             }
 
             if (height > 1)
@@ -1603,18 +2529,180 @@ namespace
 
 
     //-------------------------------------------------------------------------------------
-    // Generate volume mip-map helpers
+    // Generate (1D/2D) mip-maps for every item of a mip chain with the custom filters
     //-------------------------------------------------------------------------------------
-    HRESULT Setup3DMips(
-        _In_reads_(depth) const Image* baseImages,
-        size_t depth,
+    HRESULT Generate2DMipsItem(
+        uint32_t filter_select,
         size_t levels,
-        _Out_ ScratchImage& mipChain) noexcept
+        TEX_FILTER_FLAGS filter,
+        const ScratchImage& mipChain,
+        size_t item) noexcept
     {
-        if (!baseImages || !depth)
-            return E_INVALIDARG;
-
-        if (depth > INT16_MAX)
+        switch (filter_select)
+        {
+        case TEX_FILTER_BOX:
+            return Generate2DMipsBoxFilter(levels, filter, mipChain, item);
+
+        case TEX_FILTER_POINT:
+            return Generate2DMipsPointFilter(levels, filter, mipChain, item);
+
+        case TEX_FILTER_LINEAR:
+            return Generate2DMipsLinearFilter(levels, filter, mipChain, item);
+
+        case TEX_FILTER_CUBIC:
+            return Generate2DMipsCubicFilter(levels, filter, mipChain, item);
+
+        case TEX_FILTER_TRIANGLE:
+            return Generate2DMipsTriangleFilter(levels, filter, mipChain, item);
+
+        default:
+            return HRESULT_E_NOT_SUPPORTED;
+        }
+    }
+
+    HRESULT Generate2DMipsItems(
+        uint32_t filter_select,
+        size_t levels,
+        TEX_FILTER_FLAGS filter,
+        const ScratchImage& mipChain,
+        size_t items) noexcept
+    {
+    #ifdef _OPENMP
+        // Spread whole items (array slices, cube faces) across threads when there are enough
+        // of them, otherwise each item below is split into row bands
+        if ((filter & TEX_FILTER_PARALLEL)
+            && (items > 1)
+            && (items >= static_cast<size_t>(omp_get_max_threads())))
+        {
+            if (items > INT32_MAX)
+                return HRESULT_E_ARITHMETIC_OVERFLOW;
+
+            // Threads are already busy with whole items, so each item is generated serially
+            const auto itemFilter = static_cast<TEX_FILTER_FLAGS>(filter & ~TEX_FILTER_PARALLEL);
+
+            HRESULT result = S_OK;
+            bool fail = false;
+
+        #pragma omp parallel for schedule(dynamic) shared(result, fail)
+            for (int item = 0; item < static_cast<int>(items); ++item)
+            {
+            #pragma omp flush (fail)
+                if (fail)
+                {
+                    continue;
+                }
+
+                const HRESULT hr = Generate2DMipsItem(filter_select, levels, itemFilter, mipChain, size_t(item));
+                if (FAILED(hr))
+                {
+                #pragma omp critical
+                    {
+                        if (SUCCEEDED(result))
+                            result = hr;
+                    }
+                    fail = true;
+                #pragma omp flush (fail)
+                }
+            }
+
+            return result;
+        }
+    #endif
+
+        for (size_t item = 0; item < items; ++item)
+        {
+            const HRESULT hr = Generate2DMipsItem(filter_select, levels, filter, mipChain, item);
+            if (FAILED(hr))
+                return hr;
+        }
+
+        return S_OK;
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    // Incremental (1D/2D) mip-map update helpers
+    //-------------------------------------------------------------------------------------
+
+    // Narrows parent range [start, end) to the hull of the point-sampled outputs inside it
+    void GetPointAffected(size_t srcSize, size_t destSize, size_t& start, size_t& end) noexcept
+    {
+        const size_t inc = (srcSize << 16) / destSize;
+
+        bool any = false;
+        size_t first = 0;
+        size_t last = 0;
+        size_t s = 0;
+        for (size_t i = 0; i < destSize; ++i, s += inc)
+        {
+            const size_t u = s >> 16;
+            if (u >= start && u < end)
+            {
+                if (!any)
+                {
+                    first = i;
+                    any = true;
+                }
+                last = i + 1;
+            }
+        }
+
+        start = first;
+        end = last;
+    }
+
+    HRESULT UpdatePointMips(size_t levels, const ScratchImage& mipChain, size_t item, const Rect& dirty, _Out_writes_(levels) Rect* dirtyLevels) noexcept
+    {
+        size_t x0 = dirty.x;
+        size_t x1 = dirty.x + dirty.w;
+        size_t y0 = dirty.y;
+        size_t y1 = dirty.y + dirty.h;
+
+        dirtyLevels[0] = dirty;
+        for (size_t level = 1; level < levels; ++level)
+        {
+            const Image* src = mipChain.GetImage(level - 1, item, 0);
+            const Image* dest = mipChain.GetImage(level, item, 0);
+            if (!src || !dest)
+                return E_POINTER;
+
+            if (x0 < x1 && y0 < y1)
+            {
+                GetPointAffected(src->width, dest->width, x0, x1);
+                GetPointAffected(src->height, dest->height, y0, y1);
+            }
+
+            if (x0 >= x1 || y0 >= y1)
+            {
+                x0 = x1 = y0 = y1 = 0;
+                dirtyLevels[level] = Rect(0, 0, 0, 0);
+                continue;
+            }
+
+            dirtyLevels[level] = Rect(x0, y0, x1 - x0, y1 - y0);
+
+            // Whole rows are resampled; the columns outside the dirty range are rewritten unchanged
+            const HRESULT hr = Point2DRows(*src, *dest, y0, y1);
+            if (FAILED(hr))
+                return hr;
+        }
+
+        return S_OK;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Generate volume mip-map helpers
+    //-------------------------------------------------------------------------------------
+    HRESULT Setup3DMips(
+        _In_reads_(depth) const Image* baseImages,
+        size_t depth,
+        size_t levels,
+        _Out_ ScratchImage& mipChain) noexcept
+    {
+        if (!baseImages || !depth)
+            return E_INVALIDARG;
+
+        if (depth > INT16_MAX)
             return E_INVALIDARG;
 
         assert(levels > 1);
@@ -1662,529 +2750,583 @@ namespace
     }
 
 
-    //--- 3D Point Filter ---
-    HRESULT Generate3DMipsPointFilter(size_t depth, size_t levels, const ScratchImage& mipChain) noexcept
+    //-------------------------------------------------------------------------------------
+    // Slab-streamed 3D mip chain generation (point, box, linear, and cubic filters)
+    //
+    // Base slices arrive a slab at a time. Each one is filtered in X and Y to the size of
+    // the first level, a few rows at a time as in the 2D sweep, and kept in a small window
+    // of that level. Once every slice under an output slice is in the window, they are
+    // filtered in Z; the result is stored and moves on to the next level as a parent slice
+    // while still in float. A level only holds a slab plus the filter overlap, so memory
+    // depends on the slab and slice sizes rather than the depth. With TEX_FILTER_PARALLEL
+    // the slab is one slice per thread, and both the new slices and the output slices they
+    // complete are filtered in parallel.
+    //
+    // As in 2D, taps in Y and Z must not wrap around to the far end, which rules out cubic
+    // filtering with TEX_FILTER_WRAP_V or TEX_FILTER_WRAP_W.
+    //-------------------------------------------------------------------------------------
+    struct MipAxisTap
     {
-        if (!depth || !mipChain.GetImages())
-            return E_INVALIDARG;
-
-        if (depth > INT16_MAX)
-            return E_INVALIDARG;
-
-        // This assumes that the base images are already placed into the mipChain at the top level... (see _Setup3DMips)
-
-        assert(levels > 1);
-
-        size_t width = mipChain.GetMetadata().width;
-        size_t height = mipChain.GetMetadata().height;
-
-        // Allocate temporary space (2 scanlines)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 2);
-        if (!scanline)
-            return E_OUTOFMEMORY;
-
-        XMVECTOR* target = scanline.get();
-
-        XMVECTOR* row = target + width;
+        size_t  count;
+        size_t  u[4];
+        float   weight[4];
+    };
+
+    HRESULT CreateMipAxisTaps(
+        uint32_t filter_select,
+        size_t source,
+        size_t dest,
+        bool wrap,
+        bool mirror,
+        _Out_writes_(dest) MipAxisTap* taps) noexcept
+    {
+        using namespace DirectX::Filters;
 
-        // Resize base image to each target mip level
-        for (size_t level = 1; level < levels; ++level)
+        switch (filter_select)
         {
-        #ifdef _DEBUG
-            memset(row, 0xCD, sizeof(XMVECTOR)*width);
-        #endif
-
-            if (depth > 1)
+        case TEX_FILTER_POINT:
             {
-                // 3D point filter
-                const size_t ndepth = depth >> 1;
-
-                const size_t zinc = (depth << 16) / ndepth;
+                const size_t inc = (source << 16) / dest;
 
-                size_t sz = 0;
-                for (size_t slice = 0; slice < ndepth; ++slice)
+                size_t s = 0;
+                for (size_t i = 0; i < dest; ++i, s += inc)
                 {
-                    const Image* src = mipChain.GetImage(level - 1, 0, (sz >> 16));
-                    const Image* dest = mipChain.GetImage(level, 0, slice);
-
-                    if (!src || !dest)
-                        return E_POINTER;
-
-                    const uint8_t* pSrc = src->pixels;
-                    uint8_t* pDest = dest->pixels;
-
-                    const size_t rowPitch = src->rowPitch;
-
-                    const size_t nwidth = (width > 1) ? (width >> 1) : 1;
-                    const size_t nheight = (height > 1) ? (height >> 1) : 1;
-
-                    const size_t xinc = (width << 16) / nwidth;
-                    const size_t yinc = (height << 16) / nheight;
-
-                    size_t lasty = size_t(-1);
-
-                    size_t sy = 0;
-                    for (size_t y = 0; y < nheight; ++y)
-                    {
-                        if ((lasty ^ sy) >> 16)
-                        {
-                            if (!LoadScanline(row, width, pSrc + (rowPitch * (sy >> 16)), rowPitch, src->format))
-                                return E_FAIL;
-                            lasty = sy;
-                        }
-
-                        size_t sx = 0;
-                        for (size_t x = 0; x < nwidth; ++x)
-                        {
-                            target[x] = row[sx >> 16];
-                            sx += xinc;
-                        }
-
-                        if (!StoreScanline(pDest, dest->rowPitch, dest->format, target, nwidth))
-                            return E_FAIL;
-                        pDest += dest->rowPitch;
-
-                        sy += yinc;
-                    }
-
-                    sz += zinc;
+                    taps[i].count = 1;
+                    taps[i].u[0] = s >> 16;
+                    taps[i].weight[0] = 1.f;
                 }
             }
-            else
-            {
-                // 2D point filter
-                const Image* src = mipChain.GetImage(level - 1, 0, 0);
-                const Image* dest = mipChain.GetImage(level, 0, 0);
-
-                if (!src || !dest)
-                    return E_POINTER;
-
-                const uint8_t* pSrc = src->pixels;
-                uint8_t* pDest = dest->pixels;
-
-                const size_t rowPitch = src->rowPitch;
-
-                const size_t nwidth = (width > 1) ? (width >> 1) : 1;
-                const size_t nheight = (height > 1) ? (height >> 1) : 1;
-
-                const size_t xinc = (width << 16) / nwidth;
-                const size_t yinc = (height << 16) / nheight;
+            break;
 
-                size_t lasty = size_t(-1);
+        case TEX_FILTER_LINEAR:
+            {
+                FilterTable table(FILTER_TABLE_LINEAR, source, dest, wrap);
+                if (!table)
+                    return E_OUTOFMEMORY;
 
-                size_t sy = 0;
-                for (size_t y = 0; y < nheight; ++y)
+                const LinearFilter* lf = table.Linear();
+                for (size_t i = 0; i < dest; ++i)
                 {
-                    if ((lasty ^ sy) >> 16)
-                    {
-                        if (!LoadScanline(row, width, pSrc + (rowPitch * (sy >> 16)), rowPitch, src->format))
-                            return E_FAIL;
-                        lasty = sy;
-                    }
-
-                    size_t sx = 0;
-                    for (size_t x = 0; x < nwidth; ++x)
-                    {
-                        target[x] = row[sx >> 16];
-                        sx += xinc;
-                    }
-
-                    if (!StoreScanline(pDest, dest->rowPitch, dest->format, target, nwidth))
-                        return E_FAIL;
-                    pDest += dest->rowPitch;
-
-                    sy += yinc;
+                    taps[i].count = 2;
+                    taps[i].u[0] = lf[i].u0;
+                    taps[i].u[1] = lf[i].u1;
+                    taps[i].weight[0] = lf[i].weight0;
+                    taps[i].weight[1] = lf[i].weight1;
                 }
             }
+            break;
 
-            if (height > 1)
-                height >>= 1;
+        case TEX_FILTER_CUBIC:
+            {
+                FilterTable table(FILTER_TABLE_CUBIC, source, dest, wrap, mirror);
+                if (!table)
+                    return E_OUTOFMEMORY;
 
-            if (width > 1)
-                width >>= 1;
+                const CubicFilter* cf = table.Cubic();
+                for (size_t i = 0; i < dest; ++i)
+                {
+                    // Weights of each point in the CUBIC_INTERPOLATE polynomial
+                    const float x = cf[i].x;
+                    const float w0 = x * (-1.f / 3.f + x * (0.5f - x / 6.f));
+                    const float w2 = x * (1.f + x * (0.5f - x * 0.5f));
+                    const float w3 = x * (-1.f / 6.f + x * x / 6.f);
+
+                    taps[i].count = 4;
+                    taps[i].u[0] = cf[i].u0;
+                    taps[i].u[1] = cf[i].u1;
+                    taps[i].u[2] = cf[i].u2;
+                    taps[i].u[3] = cf[i].u3;
+                    taps[i].weight[0] = w0;
+                    taps[i].weight[1] = 1.f - w0 - w2 - w3;
+                    taps[i].weight[2] = w2;
+                    taps[i].weight[3] = w3;
+                }
+            }
+            break;
 
-            if (depth > 1)
-                depth >>= 1;
+        default:
+            for (size_t i = 0; i < dest; ++i)
+            {
+                const size_t u0 = GetBoxTaps(source, dest, i, taps[i].weight[0], taps[i].weight[1], taps[i].weight[2]);
+                taps[i].count = (source <= 1) ? 1 : ((source & 1) ? 3 : 2);
+                for (size_t k = 0; k < 3; ++k)
+                {
+                    taps[i].u[k] = u0 + k;
+                }
+            }
+            break;
         }
 
         return S_OK;
     }
 
+    inline size_t GetLastTap(const MipAxisTap& tap) noexcept
+    {
+        size_t last = tap.u[0];
+        for (size_t k = 1; k < tap.count; ++k)
+        {
+            last = std::max(last, tap.u[k]);
+        }
+        return last;
+    }
 
-    //--- 3D Box Filter ---
-    HRESULT Generate3DMipsBoxFilter(size_t depth, size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain) noexcept
+    // Weighted sum of 'count' values at 'rows[k][index]'
+    inline XMVECTOR XM_CALLCONV ApplyMipTaps(size_t count, const XMVECTOR* const* rows, const XMVECTOR* weights, size_t index) noexcept
     {
-        using namespace DirectX::Filters;
+        XMVECTOR v = XMVectorMultiply(rows[0][index], weights[0]);
+        for (size_t k = 1; k < count; ++k)
+        {
+            v = XMVectorMultiplyAdd(rows[k][index], weights[k], v);
+        }
+        return v;
+    }
 
-        if (!depth || !mipChain.GetImages())
-            return E_INVALIDARG;
+    bool IsMipSweep3DSupported(uint32_t filter_select, TEX_FILTER_FLAGS filter) noexcept
+    {
+        switch (filter_select)
+        {
+        case TEX_FILTER_POINT:
+        case TEX_FILTER_BOX:
+        case TEX_FILTER_LINEAR:
+            return true;
 
-        if (depth > INT16_MAX)
-            return E_INVALIDARG;
+        case TEX_FILTER_CUBIC:
+            return !(filter & (TEX_FILTER_WRAP_V | TEX_FILTER_WRAP_W));
 
-        // This assumes that the base images are already placed into the mipChain at the top level... (see _Setup3DMips)
+        default:
+            return false;
+        }
+    }
 
-        assert(levels > 1);
+    // Where a 3D sweep reads base slices and writes the slices it generates
+    class MipSliceIO
+    {
+    public:
+        virtual ~MipSliceIO() = default;
 
-        size_t width = mipChain.GetMetadata().width;
-        size_t height = mipChain.GetMetadata().height;
+        // Makes base slices [start, end) available to GetBase
+        virtual HRESULT LoadBase(size_t start, size_t end) = 0;
+        virtual const Image* GetBase(size_t slice) const noexcept = 0;
 
-        if (!ispow2(width) || !ispow2(height) || !ispow2(depth))
-            return E_FAIL;
+        // Destination of 'slice' of 'level', which is the 'index'-th slice of the current batch
+        virtual const Image* GetDest(size_t level, size_t slice, size_t index) const noexcept = 0;
 
-        // Allocate temporary space (5 scanlines)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 5);
-        if (!scanline)
-            return E_OUTOFMEMORY;
+        // Called once the batch [start, end) of 'level' is stored
+        virtual HRESULT Commit(size_t level, size_t start, size_t end) = 0;
+    };
 
-        XMVECTOR* target = scanline.get();
+    class MipSweep3D
+    {
+    public:
+        MipSweep3D(uint32_t filter_select, TEX_FILTER_FLAGS filter) noexcept :
+            m_select(filter_select),
+            m_filter(filter),
+            m_count(0),
+            m_slab(GetSlabSize(filter))
+        {
+            assert(IsMipSweep3DSupported(filter_select, filter));
+        }
 
-        XMVECTOR* urow0 = target + width;
-        XMVECTOR* urow1 = target + width * 2;
-        XMVECTOR* vrow0 = target + width * 3;
-        XMVECTOR* vrow1 = target + width * 4;
+        MipSweep3D(MipSweep3D&&) = delete;
+        MipSweep3D& operator= (MipSweep3D&&) = delete;
 
-        const XMVECTOR* urow2 = urow0 + 1;
-        const XMVECTOR* urow3 = urow1 + 1;
-        const XMVECTOR* vrow2 = vrow0 + 1;
-        const XMVECTOR* vrow3 = vrow1 + 1;
+        MipSweep3D(MipSweep3D const&) = delete;
+        MipSweep3D& operator= (MipSweep3D const&) = delete;
 
-        // Resize base image to each target mip level
-        for (size_t level = 1; level < levels; ++level)
+        // Base slices read per step, which is also the most output slices of a level per batch
+        static size_t GetSlabSize(TEX_FILTER_FLAGS filter) noexcept
         {
-            if (height <= 1)
-            {
-                urow1 = urow0;
-                vrow1 = vrow0;
-            }
+        #ifdef _OPENMP
+            if (filter & TEX_FILTER_PARALLEL)
+                return std::max<size_t>(2, static_cast<size_t>(omp_get_max_threads()));
+        #else
+            UNREFERENCED_PARAMETER(filter);
+        #endif
+            return 2;
+        }
+
+        HRESULT Generate(MipSliceIO& io, size_t width, size_t height, size_t depth, size_t levels)
+        {
+            assert(levels > 1);
 
-            if (width <= 1)
+            m_level.reset(new (std::nothrow) Level[levels]);
+            if (!m_level)
+                return E_OUTOFMEMORY;
+
+            m_count = levels;
+
+            size_t taps = 0;
+            for (size_t level = 1; level < levels; ++level)
             {
-                urow2 = urow0;
-                urow3 = urow1;
-                vrow2 = vrow0;
-                vrow3 = vrow1;
+                Level& lv = m_level[level];
+                lv.srcWidth = width;
+                lv.srcHeight = height;
+                lv.srcDepth = depth;
+                lv.width = width = std::max<size_t>(1, width >> 1);
+                lv.height = height = std::max<size_t>(1, height >> 1);
+                lv.depth = depth = std::max<size_t>(1, depth >> 1);
+                lv.tapsX = taps;
+                lv.tapsY = lv.tapsX + lv.width;
+                lv.tapsZ = lv.tapsY + lv.height;
+                lv.arrived = 0;
+                lv.nextOut = 0;
+                taps += lv.width + lv.height + lv.depth;
             }
 
-            if (depth > 1)
+            m_taps.reset(new (std::nothrow) MipAxisTap[taps]);
+            if (!m_taps)
+                return E_OUTOFMEMORY;
+
+            for (size_t level = 1; level < levels; ++level)
             {
-                // 3D box filter
-                const size_t ndepth = depth >> 1;
+                Level& lv = m_level[level];
 
-                for (size_t slice = 0; slice < ndepth; ++slice)
+                HRESULT hr = CreateMipAxisTaps(m_select, lv.srcWidth, lv.width,
+                    (m_filter & TEX_FILTER_WRAP_U) != 0, (m_filter & TEX_FILTER_MIRROR_U) != 0, &m_taps[lv.tapsX]);
+                if (SUCCEEDED(hr))
+                {
+                    hr = CreateMipAxisTaps(m_select, lv.srcHeight, lv.height,
+                        (m_filter & TEX_FILTER_WRAP_V) != 0, (m_filter & TEX_FILTER_MIRROR_V) != 0, &m_taps[lv.tapsY]);
+                }
+                if (SUCCEEDED(hr))
                 {
-                    const size_t slicea = std::min<size_t>(slice * 2, depth - 1);
-                    const size_t sliceb = std::min<size_t>(slicea + 1, depth - 1);
+                    hr = CreateMipAxisTaps(m_select, lv.srcDepth, lv.depth,
+                        (m_filter & TEX_FILTER_WRAP_W) != 0, (m_filter & TEX_FILTER_MIRROR_W) != 0, &m_taps[lv.tapsZ]);
+                }
+                if (FAILED(hr))
+                    return hr;
 
-                    const Image* srca = mipChain.GetImage(level - 1, 0, slicea);
-                    const Image* srcb = mipChain.GetImage(level - 1, 0, sliceb);
-                    const Image* dest = mipChain.GetImage(level, 0, slice);
+                // The window holds a slab of parent slices plus the ones older output slices still need
+                const uint64_t sliceSize = uint64_t(lv.width) * uint64_t(lv.height);
+                const uint64_t count = sliceSize * (uint64_t(GetWindowSlots()) + m_slab);
+                if (count > SIZE_MAX / sizeof(XMVECTOR))
+                    return HRESULT_E_ARITHMETIC_OVERFLOW;
 
-                    if (!srca || !srcb || !dest)
-                        return E_POINTER;
+                lv.memory = make_AlignedArrayXMVECTOR(count);
+                if (!lv.memory)
+                    return E_OUTOFMEMORY;
 
-                    const uint8_t* pSrc1 = srca->pixels;
-                    const uint8_t* pSrc2 = srcb->pixels;
-                    uint8_t* pDest = dest->pixels;
+                lv.window = lv.memory.get();
+                lv.batch = lv.window + sliceSize * GetWindowSlots();
+            }
 
-                    const size_t aRowPitch = srca->rowPitch;
-                    const size_t bRowPitch = srcb->rowPitch;
+            const size_t baseDepth = m_level[1].srcDepth;
+            for (size_t start = 0; start < baseDepth; start += m_slab)
+            {
+                const size_t end = std::min(start + m_slab, baseDepth);
 
-                    const size_t nwidth = (width > 1) ? (width >> 1) : 1;
-                    const size_t nheight = (height > 1) ? (height >> 1) : 1;
+                HRESULT hr = io.LoadBase(start, end);
+                if (FAILED(hr))
+                    return hr;
 
-                    for (size_t y = 0; y < nheight; ++y)
-                    {
-                        if (!LoadScanlineLinear(urow0, width, pSrc1, aRowPitch, srca->format, filter))
-                            return E_FAIL;
-                        pSrc1 += aRowPitch;
+                hr = Push(io, 1, start, end, nullptr);
+                if (FAILED(hr))
+                    return hr;
+            }
 
-                        if (urow0 != urow1)
-                        {
-                            if (!LoadScanlineLinear(urow1, width, pSrc1, aRowPitch, srca->format, filter))
-                                return E_FAIL;
-                            pSrc1 += aRowPitch;
-                        }
+        #ifdef _DEBUG
+            for (size_t level = 1; level < levels; ++level)
+            {
+                assert(m_level[level].nextOut == m_level[level].depth);
+            }
+        #endif
 
-                        if (!LoadScanlineLinear(vrow0, width, pSrc2, bRowPitch, srcb->format, filter))
-                            return E_FAIL;
-                        pSrc2 += bRowPitch;
+            return S_OK;
+        }
 
-                        if (vrow0 != vrow1)
-                        {
-                            if (!LoadScanlineLinear(vrow1, width, pSrc2, bRowPitch, srcb->format, filter))
-                                return E_FAIL;
-                            pSrc2 += bRowPitch;
-                        }
+    private:
+        struct Level
+        {
+            size_t                      width;
+            size_t                      height;
+            size_t                      depth;
+            size_t                      srcWidth;
+            size_t                      srcHeight;
+            size_t                      srcDepth;
+            size_t                      tapsX;      // Offsets of this level's taps
+            size_t                      tapsY;
+            size_t                      tapsZ;
+            size_t                      arrived;    // Parent slices seen so far
+            size_t                      nextOut;    // Next output slice waiting on parent slices
+            XMVECTOR*                   window;     // Parent slices filtered in X and Y, indexed by (slice % window slots)
+            XMVECTOR*                   batch;      // Output slices of the current batch
+            ScopedAlignedArrayXMVECTOR  memory;
+        };
+
+        // Taps span at most four slices, so three slices older than a slab are enough
+        size_t GetWindowSlots() const noexcept { return m_slab + 4; }
+
+        // Accepts parent slices [start, end) of 'level', taken from 'io' for the first level and
+        // from 'parent' (consecutive float slices) below it, then emits every output slice they complete
+        HRESULT Push(MipSliceIO& io, size_t level, size_t start, size_t end, const XMVECTOR* parent)
+        {
+            Level& lv = m_level[level];
+            assert(start == lv.arrived);
 
-                        for (size_t x = 0; x < nwidth; ++x)
-                        {
-                            const size_t x2 = x << 1;
+            const size_t count = end - start;
+            const size_t parentSize = lv.srcWidth * lv.srcHeight;
 
-                            AVERAGE8(target[x], urow0[x2], urow1[x2], urow2[x2], urow3[x2],
-                                vrow0[x2], vrow1[x2], vrow2[x2], vrow3[x2])
-                        }
+            HRESULT hr = S_OK;
 
-                        if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
-                            return E_FAIL;
-                        pDest += dest->rowPitch;
-                    }
-                }
-            }
-            else
+            // Filter the new slices in X and Y
+        #ifdef _OPENMP
+            if ((m_filter & TEX_FILTER_PARALLEL) && count > 1)
             {
-                // 2D box filter
-                const Image* src = mipChain.GetImage(level - 1, 0, 0);
-                const Image* dest = mipChain.GetImage(level, 0, 0);
-
-                if (!src || !dest)
-                    return E_POINTER;
-
-                const uint8_t* pSrc = src->pixels;
-                uint8_t* pDest = dest->pixels;
-
-                const size_t rowPitch = src->rowPitch;
+                bool fail = false;
 
-                const size_t nwidth = (width > 1) ? (width >> 1) : 1;
-                const size_t nheight = (height > 1) ? (height >> 1) : 1;
-
-                for (size_t y = 0; y < nheight; ++y)
+            #pragma omp parallel for shared(hr, fail)
+                for (int index = 0; index < static_cast<int>(count); ++index)
                 {
-                    if (!LoadScanlineLinear(urow0, width, pSrc, rowPitch, src->format, filter))
-                        return E_FAIL;
-                    pSrc += rowPitch;
-
-                    if (urow0 != urow1)
+                #pragma omp flush (fail)
+                    if (fail)
                     {
-                        if (!LoadScanlineLinear(urow1, width, pSrc, rowPitch, src->format, filter))
-                            return E_FAIL;
-                        pSrc += rowPitch;
+                        // Short circuit the loop body if a failure has occurred.
+                        // OpenMP 2.0 does not support cancellation of a 'parallel for' loop.
+                        continue;
                     }
 
-                    for (size_t x = 0; x < nwidth; ++x)
+                    const HRESULT hrSlice = ReduceSlice(io, lv, start + size_t(index), (parent) ? (parent + parentSize * size_t(index)) : nullptr);
+                    if (FAILED(hrSlice))
                     {
-                        const size_t x2 = x << 1;
-
-                        AVERAGE4(target[x], urow0[x2], urow1[x2], urow2[x2], urow3[x2])
+                    #pragma omp critical
+                        {
+                            if (SUCCEEDED(hr))
+                                hr = hrSlice;
+                        }
+                        fail = true;
+                    #pragma omp flush (fail)
                     }
-
-                    if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
-                        return E_FAIL;
-                    pDest += dest->rowPitch;
+                }
+            }
+            else
+        #endif
+            {
+                for (size_t index = 0; index < count && SUCCEEDED(hr); ++index)
+                {
+                    hr = ReduceSlice(io, lv, start + index, (parent) ? (parent + parentSize * index) : nullptr);
                 }
             }
 
-            if (height > 1)
-                height >>= 1;
-
-            if (width > 1)
-                width >>= 1;
-
-            if (depth > 1)
-                depth >>= 1;
-        }
-
-        return S_OK;
-    }
-
-
-    //--- 3D Linear Filter ---
-    HRESULT Generate3DMipsLinearFilter(size_t depth, size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain) noexcept
-    {
-        using namespace DirectX::Filters;
-
-        if (!depth || !mipChain.GetImages())
-            return E_INVALIDARG;
-
-        if (depth > INT16_MAX)
-            return E_INVALIDARG;
-
-        // This assumes that the base images are already placed into the mipChain at the top level... (see _Setup3DMips)
-
-        assert(levels > 1);
-
-        size_t width = mipChain.GetMetadata().width;
-        size_t height = mipChain.GetMetadata().height;
-
-        // Allocate temporary space (5 scanlines, plus X/Y/Z filters)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 5);
-        if (!scanline)
-            return E_OUTOFMEMORY;
-
-        std::unique_ptr<LinearFilter[]> lf(new (std::nothrow) LinearFilter[width + height + depth]);
-        if (!lf)
-            return E_OUTOFMEMORY;
-
-        LinearFilter* lfX = lf.get();
-        LinearFilter* lfY = lf.get() + width;
-        LinearFilter* lfZ = lf.get() + width + height;
-
-        XMVECTOR* target = scanline.get();
-
-        XMVECTOR* urow0 = target + width;
-        XMVECTOR* urow1 = target + width * 2;
-        XMVECTOR* vrow0 = target + width * 3;
-        XMVECTOR* vrow1 = target + width * 4;
-
-        // Resize base image to each target mip level
-        for (size_t level = 1; level < levels; ++level)
-        {
-            const size_t nwidth = (width > 1) ? (width >> 1) : 1;
-            CreateLinearFilter(width, nwidth, (filter & TEX_FILTER_WRAP_U) != 0, lfX);
-
-            const size_t nheight = (height > 1) ? (height >> 1) : 1;
-            CreateLinearFilter(height, nheight, (filter & TEX_FILTER_WRAP_V) != 0, lfY);
+            if (FAILED(hr))
+                return hr;
 
-        #ifdef _DEBUG
-            memset(urow0, 0xCD, sizeof(XMVECTOR)*width);
-            memset(urow1, 0xDD, sizeof(XMVECTOR)*width);
-            memset(vrow0, 0xED, sizeof(XMVECTOR)*width);
-            memset(vrow1, 0xFD, sizeof(XMVECTOR)*width);
-        #endif
+            lv.arrived = end;
 
-            if (depth > 1)
+            // Filter every output slice whose taps have all arrived in Z, a batch at a time
+            while (lv.nextOut < lv.depth)
             {
-                // 3D linear filter
-                const size_t ndepth = depth >> 1;
-                CreateLinearFilter(depth, ndepth, (filter & TEX_FILTER_WRAP_W) != 0, lfZ);
+                const size_t first = lv.nextOut;
 
-                for (size_t slice = 0; slice < ndepth; ++slice)
+                size_t last = first;
+                while (last < lv.depth && (last - first) < m_slab && GetLastTap(m_taps[lv.tapsZ + last]) < end)
                 {
-                    const auto& toZ = lfZ[slice];
-
-                    const Image* srca = mipChain.GetImage(level - 1, 0, toZ.u0);
-                    const Image* srcb = mipChain.GetImage(level - 1, 0, toZ.u1);
-                    if (!srca || !srcb)
-                        return E_POINTER;
-
-                    size_t u0 = size_t(-1);
-                    size_t u1 = size_t(-1);
+                    ++last;
+                }
 
-                    const Image* dest = mipChain.GetImage(level, 0, slice);
-                    if (!dest)
-                        return E_POINTER;
+                if (last == first)
+                    break;
 
-                    uint8_t* pDest = dest->pixels;
+            #ifdef _OPENMP
+                if ((m_filter & TEX_FILTER_PARALLEL) && (last - first) > 1)
+                {
+                    bool fail = false;
 
-                    for (size_t y = 0; y < nheight; ++y)
+                #pragma omp parallel for shared(hr, fail)
+                    for (int index = 0; index < static_cast<int>(last - first); ++index)
                     {
-                        const auto& toY = lfY[y];
-
-                        if (toY.u0 != u0)
+                    #pragma omp flush (fail)
+                        if (fail)
                         {
-                            if (toY.u0 != u1)
-                            {
-                                u0 = toY.u0;
-
-                                if (!LoadScanlineLinear(urow0, width, srca->pixels + (srca->rowPitch * u0), srca->rowPitch, srca->format, filter)
-                                    || !LoadScanlineLinear(vrow0, width, srcb->pixels + (srcb->rowPitch * u0), srcb->rowPitch, srcb->format, filter))
-                                    return E_FAIL;
-                            }
-                            else
-                            {
-                                u0 = u1;
-                                u1 = size_t(-1);
-
-                                std::swap(urow0, urow1);
-                                std::swap(vrow0, vrow1);
-                            }
+                            continue;
                         }
 
-                        if (toY.u1 != u1)
+                        const HRESULT hrSlice = CombineSlice(io, level, first + size_t(index), size_t(index));
+                        if (FAILED(hrSlice))
                         {
-                            u1 = toY.u1;
-
-                            if (!LoadScanlineLinear(urow1, width, srca->pixels + (srca->rowPitch * u1), srca->rowPitch, srca->format, filter)
-                                || !LoadScanlineLinear(vrow1, width, srcb->pixels + (srcb->rowPitch * u1), srcb->rowPitch, srcb->format, filter))
-                                return E_FAIL;
+                        #pragma omp critical
+                            {
+                                if (SUCCEEDED(hr))
+                                    hr = hrSlice;
+                            }
+                            fail = true;
+                        #pragma omp flush (fail)
                         }
+                    }
+                }
+                else
+            #endif
+                {
+                    for (size_t index = 0; index < (last - first) && SUCCEEDED(hr); ++index)
+                    {
+                        hr = CombineSlice(io, level, first + index, index);
+                    }
+                }
 
-                        for (size_t x = 0; x < nwidth; ++x)
-                        {
-                            const auto& toX = lfX[x];
+                if (FAILED(hr))
+                    return hr;
 
-                            TRILINEAR_INTERPOLATE(target[x], toX, toY, toZ, urow0, urow1, vrow0, vrow1)
-                        }
+                hr = io.Commit(level, first, last);
+                if (FAILED(hr))
+                    return hr;
 
-                        if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
-                            return E_FAIL;
-                        pDest += dest->rowPitch;
-                    }
+                if (level + 1 < m_count)
+                {
+                    hr = Push(io, level + 1, first, last, lv.batch);
+                    if (FAILED(hr))
+                        return hr;
                 }
+
+                lv.nextOut = last;
             }
-            else
-            {
-                // 2D linear filter
-                const Image* src = mipChain.GetImage(level - 1, 0, 0);
-                const Image* dest = mipChain.GetImage(level, 0, 0);
 
-                if (!src || !dest)
+            return S_OK;
+        }
+
+        // Filters parent slice 'slice' in X and Y into the window
+        HRESULT ReduceSlice(const MipSliceIO& io, const Level& lv, size_t slice, const XMVECTOR* parent) const noexcept
+        {
+            const Image* src = nullptr;
+            if (!parent)
+            {
+                src = io.GetBase(slice);
+                if (!src || !src->pixels)
                     return E_POINTER;
+            }
 
-                const uint8_t* pSrc = src->pixels;
-                uint8_t* pDest = dest->pixels;
+            // Loaded parent row, then a ring of the last four parent rows filtered in X
+            auto scanline = make_ScratchArrayXMVECTOR(uint64_t(lv.srcWidth) + uint64_t(lv.width) * 4);
+            if (!scanline)
+                return E_OUTOFMEMORY;
 
-                const size_t rowPitch = src->rowPitch;
+            XMVECTOR* row = scanline.get();
+            XMVECTOR* ring[4];
+            for (size_t j = 0; j < 4; ++j)
+            {
+                ring[j] = row + lv.srcWidth + lv.width * j;
+            }
 
-                size_t u0 = size_t(-1);
-                size_t u1 = size_t(-1);
+            const MipAxisTap* tapsX = &m_taps[lv.tapsX];
+            const MipAxisTap* tapsY = &m_taps[lv.tapsY];
 
-                for (size_t y = 0; y < nheight; ++y)
+            XMVECTOR* dest = lv.window + (slice % GetWindowSlots()) * lv.width * lv.height;
+
+            size_t y = 0;
+            for (size_t r = 0; r < lv.srcHeight && y < lv.height; ++r)
+            {
+                const XMVECTOR* pixels = row;
+                if (parent)
+                {
+                    pixels = parent + r * lv.srcWidth;
+                }
+                else if (!LoadScanlineLinear(row, lv.srcWidth, src->pixels + src->rowPitch * r, src->rowPitch, src->format, m_filter))
                 {
-                    const auto& toY = lfY[y];
+                    return E_FAIL;
+                }
 
-                    if (toY.u0 != u0)
+                XMVECTOR* hrow = ring[r & 3];
+                for (size_t x = 0; x < lv.width; ++x)
+                {
+                    const MipAxisTap& tap = tapsX[x];
+
+                    XMVECTOR v = XMVectorScale(pixels[tap.u[0]], tap.weight[0]);
+                    for (size_t k = 1; k < tap.count; ++k)
                     {
-                        if (toY.u0 != u1)
-                        {
-                            u0 = toY.u0;
+                        v = XMVectorMultiplyAdd(pixels[tap.u[k]], XMVectorReplicate(tap.weight[k]), v);
+                    }
+                    hrow[x] = v;
+                }
 
-                            if (!LoadScanlineLinear(urow0, width, pSrc + (rowPitch * u0), rowPitch, src->format, filter))
-                                return E_FAIL;
-                        }
-                        else
-                        {
-                            u0 = u1;
-                            u1 = size_t(-1);
+                for (; y < lv.height; ++y)
+                {
+                    const MipAxisTap& tap = tapsY[y];
+                    if (GetLastTap(tap) > r)
+                        break;
 
-                            std::swap(urow0, urow1);
-                        }
+                    const XMVECTOR* rows[4];
+                    XMVECTOR weights[4];
+                    for (size_t k = 0; k < tap.count; ++k)
+                    {
+                        rows[k] = ring[tap.u[k] & 3];
+                        weights[k] = XMVectorReplicate(tap.weight[k]);
                     }
 
-                    if (toY.u1 != u1)
+                    XMVECTOR* out = dest + y * lv.width;
+                    for (size_t x = 0; x < lv.width; ++x)
                     {
-                        u1 = toY.u1;
-
-                        if (!LoadScanlineLinear(urow1, width, pSrc + (rowPitch * u1), rowPitch, src->format, filter))
-                            return E_FAIL;
+                        out[x] = ApplyMipTaps(tap.count, rows, weights, x);
                     }
+                }
+            }
 
-                    for (size_t x = 0; x < nwidth; ++x)
-                    {
-                        const auto& toX = lfX[x];
+            return (y == lv.height) ? S_OK : E_UNEXPECTED;
+        }
 
-                        BILINEAR_INTERPOLATE(target[x], toX, toY, urow0, urow1)
-                    }
+        // Filters output slice 'slice' of 'level' in Z into the batch, and stores it
+        HRESULT CombineSlice(const MipSliceIO& io, size_t level, size_t slice, size_t index) const noexcept
+        {
+            const Level& lv = m_level[level];
 
-                    if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
-                        return E_FAIL;
-                    pDest += dest->rowPitch;
-                }
+            const Image* dest = io.GetDest(level, slice, index);
+            if (!dest || !dest->pixels)
+                return E_POINTER;
+
+            auto scanline = make_ScratchArrayXMVECTOR(lv.width);
+            if (!scanline)
+                return E_OUTOFMEMORY;
+
+            const size_t sliceSize = lv.width * lv.height;
+            const MipAxisTap& tap = m_taps[lv.tapsZ + slice];
+
+            const XMVECTOR* slices[4];
+            XMVECTOR weights[4];
+            for (size_t k = 0; k < tap.count; ++k)
+            {
+                assert(tap.u[k] < lv.arrived && tap.u[k] + GetWindowSlots() > lv.arrived);
+                slices[k] = lv.window + (tap.u[k] % GetWindowSlots()) * sliceSize;
+                weights[k] = XMVectorReplicate(tap.weight[k]);
             }
 
-            if (height > 1)
-                height >>= 1;
+            XMVECTOR* out = lv.batch + index * sliceSize;
+            for (size_t j = 0; j < sliceSize; ++j)
+            {
+                out[j] = ApplyMipTaps(tap.count, slices, weights, j);
+            }
 
-            if (width > 1)
-                width >>= 1;
+            // StoreScanlineLinear modifies its input, so each row is stored from a copy
+            uint8_t* pDest = dest->pixels;
+            for (size_t y = 0; y < lv.height; ++y, pDest += dest->rowPitch)
+            {
+                memcpy(scanline.get(), out + y * lv.width, sizeof(XMVECTOR) * lv.width);
 
-            if (depth > 1)
-                depth >>= 1;
+                if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, scanline.get(), lv.width, m_filter))
+                    return E_FAIL;
+            }
+
+            return S_OK;
         }
 
-        return S_OK;
-    }
+        uint32_t                        m_select;
+        TEX_FILTER_FLAGS                m_filter;
+        size_t                          m_count;
+        size_t                          m_slab;
+        std::unique_ptr<Level[]>        m_level;
+        std::unique_ptr<MipAxisTap[]>   m_taps;
+    };
+
+    // Slices of a mip chain already holding the base volume (see Setup3DMips)
+    class MipChainSliceIO : public MipSliceIO
+    {
+    public:
+        explicit MipChainSliceIO(const ScratchImage& mipChain) noexcept : m_mipChain(mipChain) {}
+
+        HRESULT LoadBase(size_t, size_t) noexcept override { return S_OK; }
+        const Image* GetBase(size_t slice) const noexcept override { return m_mipChain.GetImage(0, 0, slice); }
+        const Image* GetDest(size_t level, size_t slice, size_t) const noexcept override { return m_mipChain.GetImage(level, 0, slice); }
+        HRESULT Commit(size_t, size_t, size_t) noexcept override { return S_OK; }
 
+    private:
+        const ScratchImage& m_mipChain;
+    };
 
     //--- 3D Cubic Filter ---
     HRESULT Generate3DMipsCubicFilter(size_t depth, size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain) noexcept
@@ -2205,18 +3347,10 @@ namespace
         size_t height = mipChain.GetMetadata().height;
 
         // Allocate temporary space (17 scanlines, plus X/Y/Z filters)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 17);
+        auto scanline = make_ScratchArrayXMVECTOR(uint64_t(width) * 17);
         if (!scanline)
             return E_OUTOFMEMORY;
 
-        std::unique_ptr<CubicFilter[]> cf(new (std::nothrow) CubicFilter[width + height + depth]);
-        if (!cf)
-            return E_OUTOFMEMORY;
-
-        CubicFilter* cfX = cf.get();
-        CubicFilter* cfY = cf.get() + width;
-        CubicFilter* cfZ = cf.get() + width + height;
-
         XMVECTOR* target = scanline.get();
 
         XMVECTOR* urow[4];
@@ -2237,10 +3371,15 @@ namespace
         for (size_t level = 1; level < levels; ++level)
         {
             const size_t nwidth = (width > 1) ? (width >> 1) : 1;
-            CreateCubicFilter(width, nwidth, (filter & TEX_FILTER_WRAP_U) != 0, (filter & TEX_FILTER_MIRROR_U) != 0, cfX);
-
             const size_t nheight = (height > 1) ? (height >> 1) : 1;
-            CreateCubicFilter(height, nheight, (filter & TEX_FILTER_WRAP_V) != 0, (filter & TEX_FILTER_MIRROR_V) != 0, cfY);
+
+            const FilterTable tableX(FILTER_TABLE_CUBIC, width, nwidth, (filter & TEX_FILTER_WRAP_U) != 0, (filter & TEX_FILTER_MIRROR_U) != 0);
+            const FilterTable tableY(FILTER_TABLE_CUBIC, height, nheight, (filter & TEX_FILTER_WRAP_V) != 0, (filter & TEX_FILTER_MIRROR_V) != 0);
+            if (!tableX || !tableY)
+                return E_OUTOFMEMORY;
+
+            const CubicFilter* cfX = tableX.Cubic();
+            const CubicFilter* cfY = tableY.Cubic();
 
         #ifdef _DEBUG
             for (size_t j = 0; j < 4; ++j)
@@ -2256,7 +3395,12 @@ namespace
             {
                 // 3D cubic filter
                 const size_t ndepth = depth >> 1;
-                CreateCubicFilter(depth, ndepth, (filter & TEX_FILTER_WRAP_W) != 0, (filter & TEX_FILTER_MIRROR_W) != 0, cfZ);
+
+                const FilterTable tableZ(FILTER_TABLE_CUBIC, depth, ndepth, (filter & TEX_FILTER_WRAP_W) != 0, (filter & TEX_FILTER_MIRROR_W) != 0);
+                if (!tableZ)
+                    return E_OUTOFMEMORY;
+
+                const CubicFilter* cfZ = tableZ.Cubic();
 
                 for (size_t slice = 0; slice < ndepth; ++slice)
                 {
@@ -2570,6 +3714,29 @@ namespace
     }
 
 
+    HRESULT Generate3DMipsSweep(uint32_t filter_select, size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain) noexcept
+    {
+        if (!mipChain.GetImages())
+            return E_INVALIDARG;
+
+        // This assumes that the base images are already placed into the mipChain at the top level... (see _Setup3DMips)
+
+        assert(levels > 1);
+
+        const TexMetadata& metadata = mipChain.GetMetadata();
+        if (!IsMipSweep3DSupported(filter_select, filter))
+        {
+            // Cubic taps that wrap in Y or Z need the whole parent level
+            assert(filter_select == TEX_FILTER_CUBIC);
+            return Generate3DMipsCubicFilter(metadata.depth, levels, filter, mipChain);
+        }
+
+        MipChainSliceIO io(mipChain);
+        MipSweep3D sweep(filter_select, filter);
+        return sweep.Generate(io, metadata.width, metadata.height, metadata.depth, levels);
+    }
+
+
     //--- 3D Triangle Filter ---
     HRESULT Generate3DMipsTriangleFilter(size_t depth, size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain) noexcept
     {
@@ -2589,7 +3756,7 @@ namespace
         size_t height = mipChain.GetMetadata().height;
 
         // Allocate initial temporary space (1 scanline, accumulation rows, plus X/Y/Z filters)
-        auto scanline = make_AlignedArrayXMVECTOR(width);
+        auto scanline = make_ScratchArrayXMVECTOR(width);
         if (!scanline)
             return E_OUTOFMEMORY;
 
@@ -2599,38 +3766,35 @@ namespace
 
         TriangleRow * sliceFree = nullptr;
 
-        std::unique_ptr<Filter> tfX, tfY, tfZ;
-
         XMVECTOR* row = scanline.get();
 
         // Resize base image to each target mip level
         for (size_t level = 1; level < levels; ++level)
         {
             const size_t nwidth = (width > 1) ? (width >> 1) : 1;
-            HRESULT hr = CreateTriangleFilter(width, nwidth, (filter & TEX_FILTER_WRAP_U) != 0, tfX);
-            if (FAILED(hr))
-                return hr;
-
             const size_t nheight = (height > 1) ? (height >> 1) : 1;
-            hr = CreateTriangleFilter(height, nheight, (filter & TEX_FILTER_WRAP_V) != 0, tfY);
-            if (FAILED(hr))
-                return hr;
-
             const size_t ndepth = (depth > 1) ? (depth >> 1) : 1;
-            hr = CreateTriangleFilter(depth, ndepth, (filter & TEX_FILTER_WRAP_W) != 0, tfZ);
-            if (FAILED(hr))
-                return hr;
+
+            const FilterTable tableX(FILTER_TABLE_TRIANGLE, width, nwidth, (filter & TEX_FILTER_WRAP_U) != 0);
+            const FilterTable tableY(FILTER_TABLE_TRIANGLE, height, nheight, (filter & TEX_FILTER_WRAP_V) != 0);
+            const FilterTable tableZ(FILTER_TABLE_TRIANGLE, depth, ndepth, (filter & TEX_FILTER_WRAP_W) != 0);
+            if (!tableX || !tableY || !tableZ)
+                return E_OUTOFMEMORY;
+
+            const Filter* tfX = tableX.Triangle();
+            const Filter* tfY = tableY.Triangle();
+            const Filter* tfZ = tableZ.Triangle();
 
         #ifdef _DEBUG
             memset(row, 0xCD, sizeof(XMVECTOR)*width);
         #endif
 
-            auto xFromEnd = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(tfX.get()) + tfX->sizeInBytes);
-            auto yFromEnd = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(tfY.get()) + tfY->sizeInBytes);
-            auto zFromEnd = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(tfZ.get()) + tfZ->sizeInBytes);
+            auto xFromEnd = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(tfX) + tfX->sizeInBytes);
+            auto yFromEnd = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(tfY) + tfY->sizeInBytes);
+            auto zFromEnd = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(tfZ) + tfZ->sizeInBytes);
 
             // Count times slices get written (and clear out any leftover accumulation slices from last miplevel)
-            for (FilterFrom* zFrom = tfZ->from; zFrom < zFromEnd; )
+            for (auto zFrom = tfZ->from; zFrom < zFromEnd; )
             {
                 for (size_t j = 0; j < zFrom->count; ++j)
                 {
@@ -2646,12 +3810,12 @@ namespace
                     }
                 }
 
-                zFrom = reinterpret_cast<FilterFrom*>(reinterpret_cast<uint8_t*>(zFrom) + zFrom->sizeInBytes);
+                zFrom = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(zFrom) + zFrom->sizeInBytes);
             }
 
             // Filter image
             size_t z = 0;
-            for (FilterFrom* zFrom = tfZ->from; zFrom < zFromEnd; ++z)
+            for (auto zFrom = tfZ->from; zFrom < zFromEnd; ++z)
             {
                 // Create accumulation slices as needed
                 for (size_t j = 0; j < zFrom->count; ++j)
@@ -2691,7 +3855,7 @@ namespace
                 const size_t rowPitch = src->rowPitch;
                 const uint8_t* pEndSrc = pSrc + rowPitch * height;
 
-                for (FilterFrom* yFrom = tfY->from; yFrom < yFromEnd; )
+                for (auto yFrom = tfY->from; yFrom < yFromEnd; )
                 {
                     // Load source scanline
                     if ((pSrc + rowPitch) > pEndSrc)
@@ -2704,7 +3868,7 @@ namespace
 
                     // Process row
                     size_t x = 0;
-                    for (FilterFrom* xFrom = tfX->from; xFrom < xFromEnd; ++x)
+                    for (auto xFrom = tfX->from; xFrom < xFromEnd; ++x)
                     {
                         for (size_t j = 0; j < zFrom->count; ++j)
                         {
@@ -2737,10 +3901,10 @@ namespace
                             }
                         }
 
-                        xFrom = reinterpret_cast<FilterFrom*>(reinterpret_cast<uint8_t*>(xFrom) + xFrom->sizeInBytes);
+                        xFrom = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(xFrom) + xFrom->sizeInBytes);
                     }
 
-                    yFrom = reinterpret_cast<FilterFrom*>(reinterpret_cast<uint8_t*>(yFrom) + yFrom->sizeInBytes);
+                    yFrom = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(yFrom) + yFrom->sizeInBytes);
                 }
 
                 // Write completed accumulation slices
@@ -2799,7 +3963,7 @@ namespace
                     }
                 }
 
-                zFrom = reinterpret_cast<FilterFrom*>(reinterpret_cast<uint8_t*>(zFrom) + zFrom->sizeInBytes);
+                zFrom = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(zFrom) + zFrom->sizeInBytes);
             }
 
             if (height > 1)
@@ -2861,9 +4025,11 @@ HRESULT DirectX::GenerateMipMaps(
 
     if (usewic && !wicpf)
     {
-        // Check to see if the source and/or result size is too big for WIC
-        const uint64_t expandedSize = uint64_t(std::max<size_t>(1, baseImage.width >> 1)) * uint64_t(std::max<size_t>(1, baseImage.height >> 1)) * sizeof(float) * 4;
-        const uint64_t expandedSize2 = uint64_t(baseImage.width) * uint64_t(baseImage.height) * sizeof(float) * 4;
+        // Check to see if the source and/or result size is too big for WIC. Rows are streamed through
+        // float as WIC reads them, so only separate color/alpha resizing needs whole float images.
+        const bool wholeImage = (filter & TEX_FILTER_SEPARATE_ALPHA) != 0;
+        const uint64_t expandedSize = uint64_t(std::max<size_t>(1, baseImage.width >> 1)) * (wholeImage ? uint64_t(std::max<size_t>(1, baseImage.height >> 1)) : 1u) * sizeof(float) * 4;
+        const uint64_t expandedSize2 = uint64_t(baseImage.width) * (wholeImage ? uint64_t(baseImage.height) : 1u) * sizeof(float) * 4;
         if (expandedSize > UINT32_MAX || expandedSize2 > UINT32_MAX)
         {
             if (filter & TEX_FILTER_FORCE_WIC)
@@ -2886,45 +4052,26 @@ HRESULT DirectX::GenerateMipMaps(
             {
                 static_assert(TEX_FILTER_FANT == TEX_FILTER_BOX, "TEX_FILTER_ flag alias mismatch");
 
+                hr = (baseImage.height > 1 || !allow1D)
+                    ? mipChain.Initialize2D(baseImage.format, baseImage.width, baseImage.height, 1, levels)
+                    : mipChain.Initialize1D(baseImage.format, baseImage.width, 1, levels);
+                if (FAILED(hr))
+                    return hr;
+
                 if (wicpf)
                 {
                     // Case 1: Base image format is supported by Windows Imaging Component
-                    hr = (baseImage.height > 1 || !allow1D)
-                        ? mipChain.Initialize2D(baseImage.format, baseImage.width, baseImage.height, 1, levels)
-                        : mipChain.Initialize1D(baseImage.format, baseImage.width, 1, levels);
-                    if (FAILED(hr))
-                        return hr;
-
-                    return GenerateMipMapsUsingWIC(baseImage, filter, levels, pfGUID, mipChain, 0);
+                    hr = GenerateMipMapsUsingWIC(baseImage, filter, levels, pfGUID, mipChain, 0);
                 }
                 else
                 {
-                    // Case 2: Base image format is not supported by WIC, so we have to convert, generate, and convert back
-                    assert(baseImage.format != DXGI_FORMAT_R32G32B32A32_FLOAT);
-                    ScratchImage temp;
-                    hr = ConvertToR32G32B32A32(baseImage, temp);
-                    if (FAILED(hr))
-                        return hr;
-
-                    const Image *timg = temp.GetImage(0, 0, 0);
-                    if (!timg)
-                        return E_POINTER;
-
-                    ScratchImage tMipChain;
-                    hr = (baseImage.height > 1 || !allow1D)
-                        ? tMipChain.Initialize2D(DXGI_FORMAT_R32G32B32A32_FLOAT, baseImage.width, baseImage.height, 1, levels)
-                        : tMipChain.Initialize1D(DXGI_FORMAT_R32G32B32A32_FLOAT, baseImage.width, 1, levels);
-                    if (FAILED(hr))
-                        return hr;
-
-                    hr = GenerateMipMapsUsingWIC(*timg, filter, levels, GUID_WICPixelFormat128bppRGBAFloat, tMipChain, 0);
-                    if (FAILED(hr))
-                        return hr;
-
-                    temp.Release();
-
-                    return ConvertFromR32G32B32A32(tMipChain.GetImages(), tMipChain.GetImageCount(), tMipChain.GetMetadata(), baseImage.format, mipChain);
+                    // Case 2: Base image format is not supported by WIC, so rows are converted through float as WIC reads them
+                    hr = GenerateMipMapsViaR32G32B32A32UsingWIC(baseImage, filter, levels, mipChain, 0);
                 }
+
+                if (FAILED(hr))
+                    mipChain.Release();
+                return hr;
             }
 
         default:
@@ -2961,51 +4108,15 @@ HRESULT DirectX::GenerateMipMaps(
         switch (filter_select)
         {
         case TEX_FILTER_BOX:
-            hr = Setup2DMips(&baseImage, 1, mdata, mipChain);
-            if (FAILED(hr))
-                return hr;
-
-            hr = Generate2DMipsBoxFilter(levels, filter, mipChain, 0);
-            if (FAILED(hr))
-                mipChain.Release();
-            return hr;
-
         case TEX_FILTER_POINT:
-            hr = Setup2DMips(&baseImage, 1, mdata, mipChain);
-            if (FAILED(hr))
-                return hr;
-
-            hr = Generate2DMipsPointFilter(levels, mipChain, 0);
-            if (FAILED(hr))
-                mipChain.Release();
-            return hr;
-
         case TEX_FILTER_LINEAR:
-            hr = Setup2DMips(&baseImage, 1, mdata, mipChain);
-            if (FAILED(hr))
-                return hr;
-
-            hr = Generate2DMipsLinearFilter(levels, filter, mipChain, 0);
-            if (FAILED(hr))
-                mipChain.Release();
-            return hr;
-
         case TEX_FILTER_CUBIC:
-            hr = Setup2DMips(&baseImage, 1, mdata, mipChain);
-            if (FAILED(hr))
-                return hr;
-
-            hr = Generate2DMipsCubicFilter(levels, filter, mipChain, 0);
-            if (FAILED(hr))
-                mipChain.Release();
-            return hr;
-
         case TEX_FILTER_TRIANGLE:
             hr = Setup2DMips(&baseImage, 1, mdata, mipChain);
             if (FAILED(hr))
                 return hr;
 
-            hr = Generate2DMipsTriangleFilter(levels, filter, mipChain, 0);
+            hr = Generate2DMipsItems(filter_select, levels, filter, mipChain, 1);
             if (FAILED(hr))
                 mipChain.Release();
             return hr;
@@ -3076,9 +4187,11 @@ HRESULT DirectX::GenerateMipMaps(
 
     if (usewic && !wicpf)
     {
-        // Check to see if the source and/or result size is too big for WIC
-        const uint64_t expandedSize = uint64_t(std::max<size_t>(1, metadata.width >> 1)) * uint64_t(std::max<size_t>(1, metadata.height >> 1)) * sizeof(float) * 4;
-        const uint64_t expandedSize2 = uint64_t(metadata.width) * uint64_t(metadata.height) * sizeof(float) * 4;
+        // Check to see if the source and/or result size is too big for WIC. Rows are streamed through
+        // float as WIC reads them, so only separate color/alpha resizing needs whole float images.
+        const bool wholeImage = (filter & TEX_FILTER_SEPARATE_ALPHA) != 0;
+        const uint64_t expandedSize = uint64_t(std::max<size_t>(1, metadata.width >> 1)) * (wholeImage ? uint64_t(std::max<size_t>(1, metadata.height >> 1)) : 1u) * sizeof(float) * 4;
+        const uint64_t expandedSize2 = uint64_t(metadata.width) * (wholeImage ? uint64_t(metadata.height) : 1u) * sizeof(float) * 4;
         if (expandedSize > UINT32_MAX || expandedSize2 > UINT32_MAX)
         {
             if (filter & TEX_FILTER_FORCE_WIC)
@@ -3101,58 +4214,27 @@ HRESULT DirectX::GenerateMipMaps(
             {
                 static_assert(TEX_FILTER_FANT == TEX_FILTER_BOX, "TEX_FILTER_ flag alias mismatch");
 
-                if (wicpf)
-                {
-                    // Case 1: Base image format is supported by Windows Imaging Component
-                    TexMetadata mdata2 = metadata;
-                    mdata2.mipLevels = levels;
-                    hr = mipChain.Initialize(mdata2);
-                    if (FAILED(hr))
-                        return hr;
-
-                    for (size_t item = 0; item < metadata.arraySize; ++item)
-                    {
-                        hr = GenerateMipMapsUsingWIC(baseImages[item], filter, levels, pfGUID, mipChain, item);
-                        if (FAILED(hr))
-                        {
-                            mipChain.Release();
-                            return hr;
-                        }
-                    }
+                TexMetadata mdata2 = metadata;
+                mdata2.mipLevels = levels;
+                hr = mipChain.Initialize(mdata2);
+                if (FAILED(hr))
+                    return hr;
 
-                    return S_OK;
-                }
-                else
+                for (size_t item = 0; item < metadata.arraySize; ++item)
                 {
-                    // Case 2: Base image format is not supported by WIC, so we have to convert, generate, and convert back
-                    assert(metadata.format != DXGI_FORMAT_R32G32B32A32_FLOAT);
-
-                    TexMetadata mdata2 = metadata;
-                    mdata2.mipLevels = levels;
-                    mdata2.format = DXGI_FORMAT_R32G32B32A32_FLOAT;
-                    ScratchImage tMipChain;
-                    hr = tMipChain.Initialize(mdata2);
+                    hr = (wicpf)
+                        // Case 1: Base image format is supported by Windows Imaging Component
+                        ? GenerateMipMapsUsingWIC(baseImages[item], filter, levels, pfGUID, mipChain, item)
+                        // Case 2: Base image format is not supported by WIC, so rows are converted through float as WIC reads them
+                        : GenerateMipMapsViaR32G32B32A32UsingWIC(baseImages[item], filter, levels, mipChain, item);
                     if (FAILED(hr))
-                        return hr;
-
-                    for (size_t item = 0; item < metadata.arraySize; ++item)
                     {
-                        ScratchImage temp;
-                        hr = ConvertToR32G32B32A32(baseImages[item], temp);
-                        if (FAILED(hr))
-                            return hr;
-
-                        const Image *timg = temp.GetImage(0, 0, 0);
-                        if (!timg)
-                            return E_POINTER;
-
-                        hr = GenerateMipMapsUsingWIC(*timg, filter, levels, GUID_WICPixelFormat128bppRGBAFloat, tMipChain, item);
-                        if (FAILED(hr))
-                            return hr;
+                        mipChain.Release();
+                        return hr;
                     }
-
-                    return ConvertFromR32G32B32A32(tMipChain.GetImages(), tMipChain.GetImageCount(), tMipChain.GetMetadata(), metadata.format, mipChain);
                 }
+
+                return S_OK;
             }
 
         default:
@@ -3169,83 +4251,189 @@ HRESULT DirectX::GenerateMipMaps(
         uint32_t filter_select = (filter & TEX_FILTER_MODE_MASK);
         if (!filter_select)
         {
-            // Default filter choice
+            // Default filter choice
+            filter_select = (ispow2(metadata.width) && ispow2(metadata.height)) ? TEX_FILTER_BOX : TEX_FILTER_LINEAR;
+        }
+
+        switch (filter_select)
+        {
+        case TEX_FILTER_BOX:
+        case TEX_FILTER_POINT:
+        case TEX_FILTER_LINEAR:
+        case TEX_FILTER_CUBIC:
+        case TEX_FILTER_TRIANGLE:
+            hr = Setup2DMips(&baseImages[0], metadata.arraySize, mdata2, mipChain);
+            if (FAILED(hr))
+                return hr;
+
+            hr = Generate2DMipsItems(filter_select, levels, filter, mipChain, metadata.arraySize);
+            if (FAILED(hr))
+                mipChain.Release();
+            return hr;
+
+        default:
+            return HRESULT_E_NOT_SUPPORTED;
+        }
+    }
+}
+
+
+//-------------------------------------------------------------------------------------
+// Update the parts of a mipmap chain that depend on a dirty rectangle of the top level
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT DirectX::UpdateMipMaps(
+    ScratchImage& mipChain,
+    size_t item,
+    const Rect& dirtyRect,
+    TEX_FILTER_FLAGS filter,
+    Rect* dirtyRects,
+    size_t nLevels,
+    DXGI_FORMAT compressFormat) noexcept
+{
+    // Only pixels are written; the helpers below take the chain as const so it is never reallocated
+    const TexMetadata& metadata = mipChain.GetMetadata();
+    if (!mipChain.GetImages() || item >= metadata.arraySize)
+        return E_INVALIDARG;
+
+    if (metadata.IsVolumemap()
+        || IsCompressed(metadata.format) || IsTypeless(metadata.format) || IsPlanar(metadata.format) || IsPalettized(metadata.format))
+        return HRESULT_E_NOT_SUPPORTED;
+
+    if (compressFormat != DXGI_FORMAT_UNKNOWN && !IsCompressed(compressFormat))
+        return E_INVALIDARG;
+
+#ifdef _WIN32
+    if (UseWICFiltering(metadata.format, filter))
+    {
+        // GenerateMipMaps would have used WIC, whose filtering the custom code doesn't reproduce,
+        // so patching the chain here would leave seams around the dirty rectangle
+        return E_INVALIDARG;
+    }
+#endif
+
+    if (dirtyRect.x > metadata.width || dirtyRect.w > (metadata.width - dirtyRect.x)
+        || dirtyRect.y > metadata.height || dirtyRect.h > (metadata.height - dirtyRect.y))
+        return E_INVALIDARG;
+
+    const size_t levels = metadata.mipLevels;
+
+    std::unique_ptr<Rect[]> levelRects(new (std::nothrow) Rect[levels]);
+    if (!levelRects)
+        return E_OUTOFMEMORY;
+
+    HRESULT hr = S_OK;
+    if (!dirtyRect.w || !dirtyRect.h)
+    {
+        for (size_t level = 0; level < levels; ++level)
+        {
+            levelRects[level] = Rect(0, 0, 0, 0);
+        }
+    }
+    else if (levels < 2)
+    {
+        levelRects[0] = dirtyRect;
+    }
+    else
+    {
+        static_assert(TEX_FILTER_POINT == 0x100000, "TEX_FILTER_ flag values don't match TEX_FILTER_MODE_MASK");
+
+        uint32_t filter_select = (filter & TEX_FILTER_MODE_MASK);
+        if (!filter_select)
+        {
+            // Default filter choice (matches GenerateMipMaps with the custom filters)
             filter_select = (ispow2(metadata.width) && ispow2(metadata.height)) ? TEX_FILTER_BOX : TEX_FILTER_LINEAR;
         }
 
+        bool regenerate = false;
         switch (filter_select)
         {
         case TEX_FILTER_BOX:
-            hr = Setup2DMips(&baseImages[0], metadata.arraySize, mdata2, mipChain);
-            if (FAILED(hr))
-                return hr;
+        case TEX_FILTER_LINEAR:
+            {
+                MipSweep2D sweep((filter_select == TEX_FILTER_BOX) ? MIP_SWEEP_BOX : MIP_SWEEP_LINEAR, filter);
+                hr = sweep.Update(levels, mipChain, item, dirtyRect, levelRects.get());
+            }
+            break;
 
-            for (size_t item = 0; item < metadata.arraySize; ++item)
+        case TEX_FILTER_CUBIC:
+            if (filter & TEX_FILTER_WRAP_V)
             {
-                hr = Generate2DMipsBoxFilter(levels, filter, mipChain, item);
-                if (FAILED(hr))
-                    mipChain.Release();
+                // The first rows depend on the last ones, so this has no streaming form
+                regenerate = true;
             }
-            return hr;
+            else
+            {
+                MipSweep2D sweep(MIP_SWEEP_CUBIC, filter);
+                hr = sweep.Update(levels, mipChain, item, dirtyRect, levelRects.get());
+            }
+            break;
 
         case TEX_FILTER_POINT:
-            hr = Setup2DMips(&baseImages[0], metadata.arraySize, mdata2, mipChain);
-            if (FAILED(hr))
-                return hr;
+            hr = UpdatePointMips(levels, mipChain, item, dirtyRect, levelRects.get());
+            break;
 
-            for (size_t item = 0; item < metadata.arraySize; ++item)
-            {
-                hr = Generate2DMipsPointFilter(levels, mipChain, item);
-                if (FAILED(hr))
-                    mipChain.Release();
-            }
-            return hr;
+        case TEX_FILTER_TRIANGLE:
+            // Triangle weights spread over the whole parent level, so the item is regenerated
+            regenerate = true;
+            break;
 
-        case TEX_FILTER_LINEAR:
-            hr = Setup2DMips(&baseImages[0], metadata.arraySize, mdata2, mipChain);
-            if (FAILED(hr))
-                return hr;
+        default:
+            return HRESULT_E_NOT_SUPPORTED;
+        }
 
-            for (size_t item = 0; item < metadata.arraySize; ++item)
+        if (regenerate)
+        {
+            hr = Generate2DMipsItem(filter_select, levels, filter, mipChain, item);
+            if (SUCCEEDED(hr))
             {
-                hr = Generate2DMipsLinearFilter(levels, filter, mipChain, item);
-                if (FAILED(hr))
-                    mipChain.Release();
+                for (size_t level = 0; level < levels; ++level)
+                {
+                    const Image* img = mipChain.GetImage(level, item, 0);
+                    if (!img)
+                        return E_POINTER;
+
+                    levelRects[level] = Rect(0, 0, img->width, img->height);
+                }
             }
-            return hr;
+        }
+    }
 
-        case TEX_FILTER_CUBIC:
-            hr = Setup2DMips(&baseImages[0], metadata.arraySize, mdata2, mipChain);
-            if (FAILED(hr))
-                return hr;
+    if (FAILED(hr))
+        return hr;
 
-            for (size_t item = 0; item < metadata.arraySize; ++item)
+    if (dirtyRects)
+    {
+        const bool blocks = IsCompressed(compressFormat);
+
+        for (size_t level = 0; level < nLevels; ++level)
+        {
+            Rect& rct = dirtyRects[level];
+            if (level >= levels)
             {
-                hr = Generate2DMipsCubicFilter(levels, filter, mipChain, item);
-                if (FAILED(hr))
-                    mipChain.Release();
+                rct = Rect(0, 0, 0, 0);
+                continue;
             }
-            return hr;
-
-        case TEX_FILTER_TRIANGLE:
-            hr = Setup2DMips(&baseImages[0], metadata.arraySize, mdata2, mipChain);
-            if (FAILED(hr))
-                return hr;
 
-            for (size_t item = 0; item < metadata.arraySize; ++item)
+            rct = levelRects[level];
+            if (blocks && rct.w > 0 && rct.h > 0)
             {
-                hr = Generate2DMipsTriangleFilter(levels, filter, mipChain, item);
-                if (FAILED(hr))
-                    mipChain.Release();
-            }
-            return hr;
+                // Expand to whole 4x4 blocks, clamped to the level
+                const Image* img = mipChain.GetImage(level, item, 0);
+                if (!img)
+                    return E_POINTER;
 
-        default:
-            return HRESULT_E_NOT_SUPPORTED;
+                const size_t x0 = rct.x & ~size_t(3);
+                const size_t y0 = rct.y & ~size_t(3);
+                const size_t x1 = std::min((rct.x + rct.w + 3) & ~size_t(3), img->width);
+                const size_t y1 = std::min((rct.y + rct.h + 3) & ~size_t(3), img->height);
+                rct = Rect(x0, y0, x1 - x0, y1 - y0);
+            }
         }
     }
-}
 
+    return S_OK;
+}
 
 //-------------------------------------------------------------------------------------
 // Generate mipmap chain for volume texture
@@ -3306,41 +4494,14 @@ HRESULT DirectX::GenerateMipMaps3D(
     switch (filter_select)
     {
     case TEX_FILTER_BOX:
-        hr = Setup3DMips(baseImages, depth, levels, mipChain);
-        if (FAILED(hr))
-            return hr;
-
-        hr = Generate3DMipsBoxFilter(depth, levels, filter, mipChain);
-        if (FAILED(hr))
-            mipChain.Release();
-        return hr;
-
     case TEX_FILTER_POINT:
-        hr = Setup3DMips(baseImages, depth, levels, mipChain);
-        if (FAILED(hr))
-            return hr;
-
-        hr = Generate3DMipsPointFilter(depth, levels, mipChain);
-        if (FAILED(hr))
-            mipChain.Release();
-        return hr;
-
     case TEX_FILTER_LINEAR:
-        hr = Setup3DMips(baseImages, depth, levels, mipChain);
-        if (FAILED(hr))
-            return hr;
-
-        hr = Generate3DMipsLinearFilter(depth, levels, filter, mipChain);
-        if (FAILED(hr))
-            mipChain.Release();
-        return hr;
-
     case TEX_FILTER_CUBIC:
         hr = Setup3DMips(baseImages, depth, levels, mipChain);
         if (FAILED(hr))
             return hr;
 
-        hr = Generate3DMipsCubicFilter(depth, levels, filter, mipChain);
+        hr = Generate3DMipsSweep(filter_select, levels, filter, mipChain);
         if (FAILED(hr))
             mipChain.Release();
         return hr;
@@ -3425,41 +4586,14 @@ HRESULT DirectX::GenerateMipMaps3D(
     switch (filter_select)
     {
     case TEX_FILTER_BOX:
-        hr = Setup3DMips(&baseImages[0], metadata.depth, levels, mipChain);
-        if (FAILED(hr))
-            return hr;
-
-        hr = Generate3DMipsBoxFilter(metadata.depth, levels, filter, mipChain);
-        if (FAILED(hr))
-            mipChain.Release();
-        return hr;
-
     case TEX_FILTER_POINT:
-        hr = Setup3DMips(&baseImages[0], metadata.depth, levels, mipChain);
-        if (FAILED(hr))
-            return hr;
-
-        hr = Generate3DMipsPointFilter(metadata.depth, levels, mipChain);
-        if (FAILED(hr))
-            mipChain.Release();
-        return hr;
-
     case TEX_FILTER_LINEAR:
-        hr = Setup3DMips(&baseImages[0], metadata.depth, levels, mipChain);
-        if (FAILED(hr))
-            return hr;
-
-        hr = Generate3DMipsLinearFilter(metadata.depth, levels, filter, mipChain);
-        if (FAILED(hr))
-            mipChain.Release();
-        return hr;
-
     case TEX_FILTER_CUBIC:
         hr = Setup3DMips(&baseImages[0], metadata.depth, levels, mipChain);
         if (FAILED(hr))
             return hr;
 
-        hr = Generate3DMipsCubicFilter(metadata.depth, levels, filter, mipChain);
+        hr = Generate3DMipsSweep(filter_select, levels, filter, mipChain);
         if (FAILED(hr))
             mipChain.Release();
         return hr;
@@ -3479,6 +4613,154 @@ HRESULT DirectX::GenerateMipMaps3D(
     }
 }
 
+
+//-------------------------------------------------------------------------------------
+// Generate mipmap chain for a volume texture streamed one slab of slices at a time
+//-------------------------------------------------------------------------------------
+namespace
+{
+    // Base slices loaded from, and generated slices handed to, the caller
+    class CallbackSliceIO : public MipSliceIO
+    {
+    public:
+        CallbackSliceIO(
+            const std::function<HRESULT __cdecl(size_t, const Image&)>& loadSlice,
+            const std::function<HRESULT __cdecl(size_t, size_t, const Image&)>& storeSlice) noexcept :
+            m_loadSlice(loadSlice),
+            m_storeSlice(storeSlice),
+            m_start(0)
+        {
+        }
+
+        HRESULT Initialize(const TexMetadata& metadata, size_t levels, size_t slab) noexcept
+        {
+            HRESULT hr = m_base.Initialize2D(metadata.format, metadata.width, metadata.height, slab, 1);
+            if (FAILED(hr))
+                return hr;
+
+            m_levels.reset(new (std::nothrow) ScratchImage[levels]);
+            if (!m_levels)
+                return E_OUTOFMEMORY;
+
+            size_t width = metadata.width;
+            size_t height = metadata.height;
+            for (size_t level = 1; level < levels; ++level)
+            {
+                width = std::max<size_t>(1, width >> 1);
+                height = std::max<size_t>(1, height >> 1);
+
+                hr = m_levels[level].Initialize2D(metadata.format, width, height, slab, 1);
+                if (FAILED(hr))
+                    return hr;
+            }
+
+            return S_OK;
+        }
+
+        HRESULT LoadBase(size_t start, size_t end) override
+        {
+            m_start = start;
+            for (size_t slice = start; slice < end; ++slice)
+            {
+                const Image* img = m_base.GetImage(0, slice - start, 0);
+                if (!img)
+                    return E_POINTER;
+
+                const HRESULT hr = m_loadSlice(slice, *img);
+                if (FAILED(hr))
+                    return hr;
+            }
+
+            return S_OK;
+        }
+
+        const Image* GetBase(size_t slice) const noexcept override
+        {
+            return (slice >= m_start) ? m_base.GetImage(0, slice - m_start, 0) : nullptr;
+        }
+
+        const Image* GetDest(size_t level, size_t, size_t index) const noexcept override
+        {
+            return m_levels[level].GetImage(0, index, 0);
+        }
+
+        HRESULT Commit(size_t level, size_t start, size_t end) override
+        {
+            for (size_t slice = start; slice < end; ++slice)
+            {
+                const Image* img = m_levels[level].GetImage(0, slice - start, 0);
+                if (!img)
+                    return E_POINTER;
+
+                const HRESULT hr = m_storeSlice(level, slice, *img);
+                if (FAILED(hr))
+                    return hr;
+            }
+
+            return S_OK;
+        }
+
+    private:
+        const std::function<HRESULT __cdecl(size_t, const Image&)>&             m_loadSlice;
+        const std::function<HRESULT __cdecl(size_t, size_t, const Image&)>&     m_storeSlice;
+        size_t                                                                  m_start;
+        ScratchImage                                                            m_base;
+        std::unique_ptr<ScratchImage[]>                                         m_levels;
+    };
+}
+
+_Use_decl_annotations_
+HRESULT DirectX::GenerateMipMaps3DStreamed(
+    const TexMetadata& metadata,
+    TEX_FILTER_FLAGS filter,
+    size_t levels,
+    std::function<HRESULT __cdecl(size_t slice, const Image& image)> loadSlice,
+    std::function<HRESULT __cdecl(size_t level, size_t slice, const Image& image)> storeSlice)
+{
+    if (!loadSlice || !storeSlice || !IsValid(metadata.format))
+        return E_INVALIDARG;
+
+    if (filter & TEX_FILTER_FORCE_WIC)
+        return HRESULT_E_NOT_SUPPORTED;
+
+    if (!metadata.IsVolumemap()
+        || IsCompressed(metadata.format) || IsTypeless(metadata.format) || IsPlanar(metadata.format) || IsPalettized(metadata.format))
+        return HRESULT_E_NOT_SUPPORTED;
+
+    if (!metadata.width || !metadata.height || !metadata.depth)
+        return E_INVALIDARG;
+
+    if (!CalculateMipLevels3D(metadata.width, metadata.height, metadata.depth, levels))
+        return E_INVALIDARG;
+
+    if (levels <= 1)
+        return E_INVALIDARG;
+
+    static_assert(TEX_FILTER_POINT == 0x100000, "TEX_FILTER_ flag values don't match TEX_FILTER_MODE_MASK");
+
+    uint32_t filter_select = (filter & TEX_FILTER_MODE_MASK);
+    if (!filter_select)
+    {
+        // Default filter choice (triangle needs the whole parent level, so use linear in its place)
+        filter_select = (ispow2(metadata.width) && ispow2(metadata.height) && ispow2(metadata.depth)) ? TEX_FILTER_BOX : TEX_FILTER_LINEAR;
+    }
+
+    if (!IsMipSweep3DSupported(filter_select, filter))
+    {
+        // Triangle filtering, and cubic taps that wrap in Y or Z, need the whole parent level
+        return HRESULT_E_NOT_SUPPORTED;
+    }
+
+    CallbackSliceIO io(loadSlice, storeSlice);
+    HRESULT hr = io.Initialize(metadata, levels, MipSweep3D::GetSlabSize(filter));
+    if (FAILED(hr))
+        return hr;
+
+    MipSweep3D sweep(filter_select, filter);
+    return sweep.Generate(io, metadata.width, metadata.height, metadata.depth, levels);
+}
+
+
 _Use_decl_annotations_
 HRESULT DirectX::ScaleMipMapsAlphaForCoverage(
     const Image* srcImages,
@@ -3486,7 +4768,8 @@ HRESULT DirectX::ScaleMipMapsAlphaForCoverage(
     const TexMetadata& metadata,
     size_t item,
     float alphaReference,
-    ScratchImage& mipChain) noexcept
+    ScratchImage& mipChain,
+    TEX_FILTER_FLAGS filter) noexcept
 {
     if (!srcImages || !nimages || !IsValid(metadata.format) || nimages > metadata.mipLevels || !mipChain.GetImages())
         return E_INVALIDARG;
@@ -3501,10 +4784,9 @@ HRESULT DirectX::ScaleMipMapsAlphaForCoverage(
         return E_FAIL;
     }
 
-    float targetCoverage = 0.0f;
-    HRESULT hr = CalculateAlphaCoverage(srcImages[0], alphaReference, 1.0f, targetCoverage);
-    if (FAILED(hr))
-        return hr;
+    const size_t levels = metadata.mipLevels;
+    if (nimages < levels)
+        return E_FAIL;
 
     // Copy base image
     {
@@ -3529,21 +4811,101 @@ HRESULT DirectX::ScaleMipMapsAlphaForCoverage(
         }
     }
 
-    for (size_t level = 1; level < metadata.mipLevels; ++level)
+    if (levels < 2)
+        return S_OK;
+
+    // Each level (the base included) is read once into a coverage histogram
+    std::unique_ptr<AlphaCoverageHistogram[]> hist(new (std::nothrow) AlphaCoverageHistogram[levels]);
+    if (!hist)
+        return E_OUTOFMEMORY;
+
+#ifdef _OPENMP
+    if (filter & TEX_FILTER_PARALLEL)
     {
-        if (level >= nimages)
-            return E_FAIL;
+        if (levels > INT32_MAX)
+            return HRESULT_E_ARITHMETIC_OVERFLOW;
+
+        HRESULT result = S_OK;
+        bool fail = false;
+        float targetCoverage = 0.0f;
+
+    #pragma omp parallel shared(result, fail, targetCoverage)
+        {
+        #pragma omp for schedule(dynamic)
+            for (int level = 0; level < static_cast<int>(levels); ++level)
+            {
+            #pragma omp flush (fail)
+                if (fail)
+                {
+                    // Short circuit the loop body if a failure has occurred.
+                    // OpenMP 2.0 does not support cancellation of a 'parallel for' loop.
+                    continue;
+                }
+
+                const HRESULT hr = BuildAlphaCoverageHistogram(srcImages[level], alphaReference, hist[size_t(level)]);
+                if (FAILED(hr))
+                {
+                #pragma omp critical
+                    {
+                        if (SUCCEEDED(result))
+                            result = hr;
+                    }
+                    fail = true;
+                #pragma omp flush (fail)
+                }
+            }
+
+        #pragma omp single
+            targetCoverage = GetAlphaCoverage(hist[0], 1.0f);
+
+        #pragma omp for schedule(dynamic)
+            for (int level = 1; level < static_cast<int>(levels); ++level)
+            {
+            #pragma omp flush (fail)
+                if (fail)
+                {
+                    continue;
+                }
+
+                const float alphaScale = EstimateAlphaScaleForCoverage(hist[size_t(level)], targetCoverage);
 
-        float alphaScale = 0.0f;
-        hr = EstimateAlphaScaleForCoverage(srcImages[level], alphaReference, targetCoverage, alphaScale);
+                const Image* mipImage = mipChain.GetImage(size_t(level), item, 0);
+                const HRESULT hr = (mipImage) ? ScaleAlpha(srcImages[level], alphaScale, *mipImage) : E_POINTER;
+                if (FAILED(hr))
+                {
+                #pragma omp critical
+                    {
+                        if (SUCCEEDED(result))
+                            result = hr;
+                    }
+                    fail = true;
+                #pragma omp flush (fail)
+                }
+            }
+        }
+
+        return result;
+    }
+#endif
+
+    for (size_t level = 0; level < levels; ++level)
+    {
+        const HRESULT hr = BuildAlphaCoverageHistogram(srcImages[level], alphaReference, hist[level]);
         if (FAILED(hr))
             return hr;
+    }
+
+    const float targetCoverage = GetAlphaCoverage(hist[0], 1.0f);
+
+    for (size_t level = 1; level < levels; ++level)
+    {
+        const float alphaScale = EstimateAlphaScaleForCoverage(hist[level], targetCoverage);
 
         const Image* mipImage = mipChain.GetImage(level, item, 0);
         if (!mipImage)
             return E_POINTER;
 
-        hr = ScaleAlpha(srcImages[level], alphaScale, *mipImage);
+        const HRESULT hr = ScaleAlpha(srcImages[level], alphaScale, *mipImage);
         if (FAILED(hr))
             return hr;
     }
@@ -11,6 +11,8 @@
 
 #include "DirectXTexP.h"
 
+#include "BC.h"
+
 using namespace DirectX;
 using namespace DirectX::Internal;
 
@@ -24,35 +26,17 @@ namespace
     const XMVECTORF32 g_Gamma22 = { { { 2.2f, 2.2f, 2.2f, 1.f } } };
 
     //-------------------------------------------------------------------------------------
-    HRESULT ComputeMSE_(
-        const Image& image1,
-        const Image& image2,
-        float& mse,
-        _Out_writes_opt_(4) float* mseV,
-        CMSE_FLAGS flags) noexcept
+    // Flags implied from image formats
+    //-------------------------------------------------------------------------------------
+    CMSE_FLAGS GetImpliedMSEFlags(DXGI_FORMAT format, CMSE_FLAGS srgbFlag) noexcept
     {
-        if (!image1.pixels || !image2.pixels)
-            return E_POINTER;
-
-        assert(image1.width == image2.width && image1.height == image2.height);
-        assert(!IsCompressed(image1.format) && !IsCompressed(image2.format));
-
-        const size_t width = image1.width;
-
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 2);
-        if (!scanline)
-            return E_OUTOFMEMORY;
-
-        // Flags implied from image formats
-        switch (image1.format)
+        switch (format)
         {
         case DXGI_FORMAT_B8G8R8X8_UNORM:
-            flags |= CMSE_IGNORE_ALPHA;
-            break;
+            return CMSE_IGNORE_ALPHA;
 
         case DXGI_FORMAT_B8G8R8X8_UNORM_SRGB:
-            flags |= CMSE_IMAGE1_SRGB | CMSE_IGNORE_ALPHA;
-            break;
+            return srgbFlag | CMSE_IGNORE_ALPHA;
 
         case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
         case DXGI_FORMAT_BC1_UNORM_SRGB:
@@ -60,203 +44,920 @@ namespace
         case DXGI_FORMAT_BC3_UNORM_SRGB:
         case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
         case DXGI_FORMAT_BC7_UNORM_SRGB:
-            flags |= CMSE_IMAGE1_SRGB;
-            break;
+            return srgbFlag;
 
         default:
-            break;
+            return CMSE_DEFAULT;
         }
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Single-pass image metrics
+    //
+    // The images are walked in bands of rows, in parallel when OpenMP is available. Each
+    // band accumulates squared error, the largest error, and the sums needed for SSIM
+    // over 8x8 blocks; the bands are then combined in order so results don't depend on
+    // the thread count.
+    //-------------------------------------------------------------------------------------
+    constexpr size_t c_SSIMBlockSize = 8;
+    constexpr size_t c_MetricsBandPixels = 256 * 1024;
+    constexpr float c_SSIM_C1 = 0.01f * 0.01f;
+    constexpr float c_SSIM_C2 = 0.03f * 0.03f;
+
+    struct MetricsBand
+    {
+        double  sqError[4];
+        double  ssim[4];
+        size_t  ssimBlocks;
+        float   maxError[4];
+        float   maxWeighted;
+        size_t  maxX;
+        size_t  maxY;
+    };
+
+    struct MetricsSetup
+    {
+        CMETRICS_FLAGS  metrics;
+        CMSE_FLAGS      flags;
+        XMVECTOR        weights;
+        XMVECTOR        ignore;     // Channels compared as zero
+    };
 
-        switch (image2.format)
+    inline size_t GetMetricsBandHeight(size_t width) noexcept
+    {
+        const size_t rows = c_MetricsBandPixels / std::max<size_t>(1, width);
+        return std::max(c_SSIMBlockSize, rows - (rows % c_SSIMBlockSize));
+    }
+
+    inline XMVECTOR XM_CALLCONV PrepareMetricsPixel(FXMVECTOR pixel, bool srgb, bool bias, FXMVECTOR ignore) noexcept
+    {
+        static const XMVECTORF32 s_Two = { { { 2.0f, 2.0f, 2.0f, 2.0f } } };
+
+        XMVECTOR v = pixel;
+        if (srgb)
         {
-        case DXGI_FORMAT_B8G8R8X8_UNORM:
-            flags |= CMSE_IGNORE_ALPHA;
-            break;
+            v = XMVectorPow(v, g_Gamma22);
+        }
+        if (bias)
+        {
+            v = XMVectorMultiplyAdd(v, s_Two, g_XMNegativeOne);
+        }
 
-        case DXGI_FORMAT_B8G8R8X8_UNORM_SRGB:
-            flags |= CMSE_IMAGE2_SRGB | CMSE_IGNORE_ALPHA;
-            break;
+        return XMVectorSelect(v, g_XMZero, ignore);
+    }
 
-        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
-        case DXGI_FORMAT_BC1_UNORM_SRGB:
-        case DXGI_FORMAT_BC2_UNORM_SRGB:
-        case DXGI_FORMAT_BC3_UNORM_SRGB:
-        case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
-        case DXGI_FORMAT_BC7_UNORM_SRGB:
-            flags |= CMSE_IMAGE2_SRGB;
-            break;
+    // SSIM of every block in a row of 8x8 blocks, from the accumulated sums
+    void AccumulateSSIM(
+        _Inout_updates_(blocks * 5) XMVECTOR* sums,
+        size_t blocks,
+        size_t width,
+        size_t blockHeight,
+        MetricsBand& band) noexcept
+    {
+        const XMVECTOR c1 = XMVectorReplicate(c_SSIM_C1);
+        const XMVECTOR c2 = XMVectorReplicate(c_SSIM_C2);
+
+        XMVECTOR acc = g_XMZero;
+        for (size_t bx = 0; bx < blocks; ++bx)
+        {
+            XMVECTOR* s = sums + bx * 5;
+
+            const size_t blockWidth = std::min(c_SSIMBlockSize, width - bx * c_SSIMBlockSize);
+            const XMVECTOR scale = XMVectorReplicate(1.f / float(blockWidth * blockHeight));
 
+            const XMVECTOR mean1 = XMVectorMultiply(s[0], scale);
+            const XMVECTOR mean2 = XMVectorMultiply(s[1], scale);
+            const XMVECTOR var1 = XMVectorNegativeMultiplySubtract(mean1, mean1, XMVectorMultiply(s[2], scale));
+            const XMVECTOR var2 = XMVectorNegativeMultiplySubtract(mean2, mean2, XMVectorMultiply(s[3], scale));
+            const XMVECTOR covar = XMVectorNegativeMultiplySubtract(mean1, mean2, XMVectorMultiply(s[4], scale));
+
+            // ((2 u1 u2 + C1)(2 cov + C2)) / ((u1^2 + u2^2 + C1)(var1 + var2 + C2))
+            const XMVECTOR num = XMVectorMultiply(
+                XMVectorAdd(XMVectorScale(XMVectorMultiply(mean1, mean2), 2.f), c1),
+                XMVectorAdd(XMVectorScale(covar, 2.f), c2));
+            const XMVECTOR den = XMVectorMultiply(
+                XMVectorAdd(XMVectorMultiplyAdd(mean1, mean1, XMVectorMultiply(mean2, mean2)), c1),
+                XMVectorAdd(XMVectorAdd(var1, var2), c2));
+
+            acc = XMVectorAdd(acc, XMVectorDivide(num, den));
+
+            s[0] = s[1] = s[2] = s[3] = s[4] = g_XMZero;
+        }
+
+        XMFLOAT4A total;
+        XMStoreFloat4A(&total, acc);
+        band.ssim[0] += double(total.x);
+        band.ssim[1] += double(total.y);
+        band.ssim[2] += double(total.z);
+        band.ssim[3] += double(total.w);
+        band.ssimBlocks += blocks;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Row source for the metrics engine
+    //
+    // Block-compressed images are decoded a 4-row stripe of blocks at a time into the
+    // band's scratch memory rather than being expanded to a full RGBA32F copy up front.
+    //-------------------------------------------------------------------------------------
+    struct MetricsSource
+    {
+        const Image*    image;
+        BC_DECODE       pfDecode;   // nullptr if not block-compressed
+        DXGI_FORMAT     cformat;    // Decoded format for BC conversion
+        size_t          blockSize;
+        size_t          stride;     // Pixels per row of a decoded stripe
+    };
+
+    HRESULT InitMetricsSource(const Image& image, MetricsSource& src) noexcept
+    {
+        src = {};
+        src.image = &image;
+        src.stride = image.width;
+
+        if (!IsCompressed(image.format))
+            return S_OK;
+
+        src.cformat = image.format;
+        switch (src.cformat)
+        {
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:    src.pfDecode = D3DXDecodeBC1;   src.blockSize = 8;   break;
+        case DXGI_FORMAT_BC2_UNORM:
+        case DXGI_FORMAT_BC2_UNORM_SRGB:    src.pfDecode = D3DXDecodeBC2;   src.blockSize = 16;  break;
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:    src.pfDecode = D3DXDecodeBC3;   src.blockSize = 16;  break;
+        case DXGI_FORMAT_BC4_UNORM:         src.pfDecode = D3DXDecodeBC4U;  src.blockSize = 8;   break;
+        case DXGI_FORMAT_BC4_SNORM:         src.pfDecode = D3DXDecodeBC4S;  src.blockSize = 8;   break;
+        case DXGI_FORMAT_BC5_UNORM:         src.pfDecode = D3DXDecodeBC5U;  src.blockSize = 16;  break;
+        case DXGI_FORMAT_BC5_SNORM:         src.pfDecode = D3DXDecodeBC5S;  src.blockSize = 16;  break;
+        case DXGI_FORMAT_BC6H_UF16:         src.pfDecode = D3DXDecodeBC6HU; src.blockSize = 16;  break;
+        case DXGI_FORMAT_BC6H_SF16:         src.pfDecode = D3DXDecodeBC6HS; src.blockSize = 16;  break;
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:    src.pfDecode = D3DXDecodeBC7;   src.blockSize = 16;  break;
         default:
-            break;
+            return HRESULT_E_NOT_SUPPORTED;
         }
 
-        const uint8_t *pSrc1 = image1.pixels;
-        const size_t rowPitch1 = image1.rowPitch;
+        src.stride = (image.width + 3u) & ~size_t(3);
+        return S_OK;
+    }
 
-        const uint8_t *pSrc2 = image2.pixels;
-        const size_t rowPitch2 = image2.rowPitch;
+    inline size_t GetMetricsRowBuffer(const MetricsSource& src) noexcept
+    {
+        return (src.pfDecode) ? src.stride * 4 : src.stride;
+    }
 
-        XMVECTOR acc = g_XMZero;
-        static XMVECTORF32 two = { { { 2.0f, 2.0f, 2.0f, 2.0f } } };
+    // Returns row y of the source; for BC images, rows must be requested in order from a multiple of 4
+    const XMVECTOR* LoadMetricsRow(const MetricsSource& src, size_t y, _Inout_ XMVECTOR* buffer) noexcept
+    {
+        const Image& image = *src.image;
 
-        for (size_t h = 0; h < image1.height; ++h)
+        if (!src.pfDecode)
         {
-            XMVECTOR* ptr1 = scanline.get();
-            if (!LoadScanline(ptr1, width, pSrc1, rowPitch1, image1.format))
-                return E_FAIL;
+            if (!LoadScanline(buffer, image.width, image.pixels + y * image.rowPitch, image.rowPitch, image.format))
+                return nullptr;
 
-            XMVECTOR* ptr2 = scanline.get() + width;
-            if (!LoadScanline(ptr2, width, pSrc2, rowPitch2, image2.format))
-                return E_FAIL;
+            return buffer;
+        }
 
-            for (size_t i = 0; i < width; ++i)
+        if (!(y & 3))
+        {
+            XM_ALIGNED_DATA(16) XMVECTOR temp[16];
+
+            const uint8_t* sptr = image.pixels + (y >> 2) * image.rowPitch;
+            for (size_t x = 0; x < image.width; x += 4)
             {
-                XMVECTOR v1 = *(ptr1++);
-                if (flags & CMSE_IMAGE1_SRGB)
-                {
-                    v1 = XMVectorPow(v1, g_Gamma22);
-                }
-                if (flags & CMSE_IMAGE1_X2_BIAS)
-                {
-                    v1 = XMVectorMultiplyAdd(v1, two, g_XMNegativeOne);
-                }
+                src.pfDecode(temp, sptr);
+                ConvertScanline(temp, 16, DXGI_FORMAT_R32G32B32A32_FLOAT, src.cformat, TEX_FILTER_DEFAULT);
 
-                XMVECTOR v2 = *(ptr2++);
-                if (flags & CMSE_IMAGE2_SRGB)
-                {
-                    v2 = XMVectorPow(v2, g_Gamma22);
-                }
-                if (flags & CMSE_IMAGE2_X2_BIAS)
+                for (size_t row = 0; row < 4; ++row)
                 {
-                    v2 = XMVectorMultiplyAdd(v2, two, g_XMNegativeOne);
+                    XMVECTOR* dptr = buffer + row * src.stride + x;
+                    dptr[0] = temp[row * 4];
+                    dptr[1] = temp[row * 4 + 1];
+                    dptr[2] = temp[row * 4 + 2];
+                    dptr[3] = temp[row * 4 + 3];
                 }
 
+                sptr += src.blockSize;
+            }
+        }
+
+        return buffer + (y & 3) * src.stride;
+    }
+
+    HRESULT ComputeMetricsBand(
+        const MetricsSource& src1,
+        const MetricsSource& src2,
+        const MetricsSetup& setup,
+        size_t startRow,
+        size_t endRow,
+        MetricsBand& band) noexcept
+    {
+        const size_t width = src1.image->width;
+        const size_t blocks = (width + c_SSIMBlockSize - 1) / c_SSIMBlockSize;
+        const bool ssim = (setup.metrics & CMETRICS_SSIM) != 0;
+        const bool maxError = (setup.metrics & CMETRICS_MAX_ERROR) != 0;
+
+        const size_t rowBuffer1 = GetMetricsRowBuffer(src1);
+        const size_t rowBuffer2 = GetMetricsRowBuffer(src2);
+
+        auto scanline = make_ScratchArrayXMVECTOR(uint64_t(rowBuffer1) + uint64_t(rowBuffer2) + (ssim ? uint64_t(blocks) * 5 : 0));
+        if (!scanline)
+            return E_OUTOFMEMORY;
+
+        XMVECTOR* buffer1 = scanline.get();
+        XMVECTOR* buffer2 = buffer1 + rowBuffer1;
+        XMVECTOR* sums = buffer2 + rowBuffer2;
+
+        if (ssim)
+        {
+            std::fill(sums, sums + blocks * 5, g_XMZero);
+        }
+
+        const bool srgb1 = (setup.flags & CMSE_IMAGE1_SRGB) != 0;
+        const bool srgb2 = (setup.flags & CMSE_IMAGE2_SRGB) != 0;
+        const bool bias1 = (setup.flags & CMSE_IMAGE1_X2_BIAS) != 0;
+        const bool bias2 = (setup.flags & CMSE_IMAGE2_X2_BIAS) != 0;
+
+        XMVECTOR sqError = g_XMZero;
+        XMVECTOR maxV = g_XMZero;
+        XMVECTOR maxWeighted = g_XMZero;
+
+        size_t blockStart = startRow;
+        for (size_t y = startRow; y < endRow; ++y)
+        {
+            const XMVECTOR* row1 = LoadMetricsRow(src1, y, buffer1);
+            if (!row1)
+                return E_FAIL;
+
+            const XMVECTOR* row2 = LoadMetricsRow(src2, y, buffer2);
+            if (!row2)
+                return E_FAIL;
+
+            for (size_t x = 0; x < width; ++x)
+            {
+                const XMVECTOR v1 = PrepareMetricsPixel(row1[x], srgb1, bias1, setup.ignore);
+                const XMVECTOR v2 = PrepareMetricsPixel(row2[x], srgb2, bias2, setup.ignore);
+
                 // sum[ (I1 - I2)^2 ]
-                XMVECTOR v = XMVectorSubtract(v1, v2);
-                if (flags & CMSE_IGNORE_RED)
-                {
-                    v = XMVectorSelect(v, g_XMZero, g_XMMaskX);
-                }
-                if (flags & CMSE_IGNORE_GREEN)
-                {
-                    v = XMVectorSelect(v, g_XMZero, g_XMMaskY);
-                }
-                if (flags & CMSE_IGNORE_BLUE)
+                const XMVECTOR d = XMVectorSubtract(v1, v2);
+                sqError = XMVectorMultiplyAdd(d, d, sqError);
+
+                if (maxError)
                 {
-                    v = XMVectorSelect(v, g_XMZero, g_XMMaskZ);
+                    const XMVECTOR ad = XMVectorAbs(d);
+                    maxV = XMVectorMax(maxV, ad);
+
+                    const XMVECTOR wd = XMVectorMultiply(ad, setup.weights);
+                    if (XMComparisonAnyTrue(XMVector4GreaterR(wd, maxWeighted)))
+                    {
+                        XMFLOAT4A f;
+                        XMStoreFloat4A(&f, wd);
+
+                        const float m = std::max(std::max(f.x, f.y), std::max(f.z, f.w));
+                        if (m > band.maxWeighted)
+                        {
+                            band.maxWeighted = m;
+                            band.maxX = x;
+                            band.maxY = y;
+                        }
+                        maxWeighted = XMVectorReplicate(band.maxWeighted);
+                    }
                 }
-                if (flags & CMSE_IGNORE_ALPHA)
+
+                if (ssim)
                 {
-                    v = XMVectorSelect(v, g_XMZero, g_XMMaskW);
+                    XMVECTOR* s = sums + (x / c_SSIMBlockSize) * 5;
+                    s[0] = XMVectorAdd(s[0], v1);
+                    s[1] = XMVectorAdd(s[1], v2);
+                    s[2] = XMVectorMultiplyAdd(v1, v1, s[2]);
+                    s[3] = XMVectorMultiplyAdd(v2, v2, s[3]);
+                    s[4] = XMVectorMultiplyAdd(v1, v2, s[4]);
                 }
+            }
 
-                acc = XMVectorMultiplyAdd(v, v, acc);
+            if (ssim && ((y + 1 - blockStart) == c_SSIMBlockSize || (y + 1) == endRow))
+            {
+                AccumulateSSIM(sums, blocks, width, y + 1 - blockStart, band);
+                blockStart = y + 1;
             }
+        }
 
-            pSrc1 += rowPitch1;
-            pSrc2 += rowPitch2;
+        XMFLOAT4A f;
+        XMStoreFloat4A(&f, sqError);
+        band.sqError[0] = double(f.x);
+        band.sqError[1] = double(f.y);
+        band.sqError[2] = double(f.z);
+        band.sqError[3] = double(f.w);
+
+        XMStoreFloat4A(&f, maxV);
+        band.maxError[0] = f.x;
+        band.maxError[1] = f.y;
+        band.maxError[2] = f.z;
+        band.maxError[3] = f.w;
+
+        return S_OK;
+    }
+
+    HRESULT ComputeMetrics_(
+        const Image& image1,
+        const Image& image2,
+        CMETRICS_FLAGS metrics,
+        CMSE_FLAGS flags,
+        _In_reads_opt_(4) const float* weights,
+        ImageMetrics& result) noexcept
+    {
+        if (!image1.pixels || !image2.pixels)
+            return E_POINTER;
+
+        assert(image1.width == image2.width && image1.height == image2.height);
+
+        MetricsSource src1, src2;
+        HRESULT hr = InitMetricsSource(image1, src1);
+        if (FAILED(hr))
+            return hr;
+
+        hr = InitMetricsSource(image2, src2);
+        if (FAILED(hr))
+            return hr;
+
+        // Block-compressed images are compared as their decoded RGBA32F data
+        if (!src1.pfDecode)
+        {
+            flags |= GetImpliedMSEFlags(image1.format, CMSE_IMAGE1_SRGB);
+        }
+        if (!src2.pfDecode)
+        {
+            flags |= GetImpliedMSEFlags(image2.format, CMSE_IMAGE2_SRGB);
         }
 
-        // MSE = sum[ (I1 - I2)^2 ] / w*h
-        const XMVECTOR d = XMVectorReplicate(float(image1.width * image1.height));
-        const XMVECTOR v = XMVectorDivide(acc, d);
-        if (mseV)
+        MetricsSetup setup = {};
+        setup.metrics = metrics;
+        setup.flags = flags;
+        setup.weights = (weights) ? XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(weights)) : g_XMOne;
+
+        setup.ignore = XMVectorSelectControl(
+            (flags & CMSE_IGNORE_RED) ? 1u : 0u,
+            (flags & CMSE_IGNORE_GREEN) ? 1u : 0u,
+            (flags & CMSE_IGNORE_BLUE) ? 1u : 0u,
+            (flags & CMSE_IGNORE_ALPHA) ? 1u : 0u);
+        setup.weights = XMVectorSelect(setup.weights, g_XMZero, setup.ignore);
+
+        const size_t height = image1.height;
+        const size_t bandHeight = GetMetricsBandHeight(image1.width);
+        const size_t nbands = (height + bandHeight - 1) / bandHeight;
+
+        std::unique_ptr<MetricsBand[]> bands(new (std::nothrow) MetricsBand[nbands]);
+        if (!bands)
+            return E_OUTOFMEMORY;
+
+        memset(bands.get(), 0, sizeof(MetricsBand) * nbands);
+
+        // Each band fills in its own MetricsBand, so the merge below is the same however the bands ran
+        hr = ProcessBands(1,
+            [&](size_t) -> BandLayout
+            {
+                return { height, bandHeight };
+            },
+            [&](size_t band, size_t, size_t startRow, size_t endRow) -> HRESULT
+            {
+                return ComputeMetricsBand(src1, src2, setup, startRow, endRow, bands[band]);
+            },
+            (metrics & CMETRICS_PARALLEL) != 0);
+        if (FAILED(hr))
+            return hr;
+
+        // Combine the bands in order
+        double sqError[4] = {};
+        double ssim[4] = {};
+        size_t ssimBlocks = 0;
+
+        result = {};
+        for (size_t band = 0; band < nbands; ++band)
         {
-            XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(mseV), v);
-            mse = mseV[0] + mseV[1] + mseV[2] + mseV[3];
+            const MetricsBand& b = bands[band];
+            for (size_t j = 0; j < 4; ++j)
+            {
+                sqError[j] += b.sqError[j];
+                ssim[j] += b.ssim[j];
+                result.maxErrorV[j] = std::max(result.maxErrorV[j], b.maxError[j]);
+            }
+            ssimBlocks += b.ssimBlocks;
+
+            if (b.maxWeighted > result.maxError)
+            {
+                result.maxError = b.maxWeighted;
+                result.maxErrorX = b.maxX;
+                result.maxErrorY = b.maxY;
+            }
         }
-        else
+
+        XMFLOAT4A w;
+        XMStoreFloat4A(&w, setup.weights);
+        const float weight[4] = { w.x, w.y, w.z, w.w };
+        const float totalWeight = weight[0] + weight[1] + weight[2] + weight[3];
+
+        // MSE = sum[ (I1 - I2)^2 ] / w*h
+        const double pixels = double(image1.width) * double(height);
+        float ssimSum = 0.f;
+        for (size_t j = 0; j < 4; ++j)
         {
-            XMFLOAT4 _mseV;
-            XMStoreFloat4(&_mseV, v);
-            mse = _mseV.x + _mseV.y + _mseV.z + _mseV.w;
+            result.mseV[j] = static_cast<float>(sqError[j] / pixels);
+            result.mse += weight[j] * result.mseV[j];
+
+            result.psnrV[j] = (result.mseV[j] > 0.f)
+                ? 10.f * log10f(1.f / result.mseV[j])
+                : std::numeric_limits<float>::infinity();
+
+            result.ssimV[j] = (ssimBlocks > 0) ? static_cast<float>(ssim[j] / double(ssimBlocks)) : 1.f;
+            ssimSum += weight[j] * result.ssimV[j];
         }
 
+        result.psnr = (result.mse > 0.f && totalWeight > 0.f)
+            ? 10.f * log10f(totalWeight / result.mse)
+            : std::numeric_limits<float>::infinity();
+        result.ssim = (totalWeight > 0.f) ? (ssimSum / totalWeight) : 1.f;
+
         return S_OK;
     }
 
     //-------------------------------------------------------------------------------------
+    HRESULT ComputeMetrics(
+        const Image& image1,
+        const Image& image2,
+        CMETRICS_FLAGS metrics,
+        CMSE_FLAGS flags,
+        _In_reads_opt_(4) const float* weights,
+        ImageMetrics& result) noexcept
+    {
+        if (!image1.pixels || !image2.pixels)
+            return E_POINTER;
+
+        if (image1.width != image2.width || image1.height != image2.height)
+            return E_INVALIDARG;
+
+        if (!IsValid(image1.format) || !IsValid(image2.format))
+            return E_INVALIDARG;
+
+        if (IsPlanar(image1.format) || IsPlanar(image2.format)
+            || IsPalettized(image1.format) || IsPalettized(image2.format)
+            || IsTypeless(image1.format) || IsTypeless(image2.format))
+            return HRESULT_E_NOT_SUPPORTED;
+
+        return ComputeMetrics_(image1, image2, metrics, flags, weights, result);
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Scanline callbacks
+    //
+    // With TEX_PIXELFUNC_PARALLEL (or the slot form of EvaluateImage), the images are cut
+    // into bands of rows and the bands handed to OpenMP threads; otherwise every scanline
+    // is visited in order on the calling thread. The slot is the band index, so what lands
+    // in each slot does not depend on which thread ran the band.
+    //-------------------------------------------------------------------------------------
+    using EvaluateSlotFunc = std::function<void __cdecl(_In_reads_(width) const XMVECTOR* pixels, size_t width, size_t y, size_t slot)>;
+    using TransformFunc = std::function<void __cdecl(_Out_writes_(width) XMVECTOR* outPixels, _In_reads_(width) const XMVECTOR* inPixels, size_t width, size_t y)>;
+
+    constexpr size_t c_PixelFuncBandPixels = 64 * 1024;
+
+    inline BandLayout GetPixelFuncBandLayout(const Image& image) noexcept
+    {
+        return { image.height, std::max<size_t>(1, c_PixelFuncBandPixels / std::max<size_t>(1, image.width)) };
+    }
+
     HRESULT EvaluateImage_(
         const Image& image,
-        const std::function<void __cdecl(_In_reads_(width) const XMVECTOR* pixels, size_t width, size_t y)>& pixelFunc)
+        size_t startRow,
+        size_t endRow,
+        size_t slot,
+        const EvaluateSlotFunc& pixelFunc)
     {
+        if (!image.pixels)
+            return E_POINTER;
+
+        assert(!IsCompressed(image.format));
+        assert(startRow <= endRow && endRow <= image.height);
+
+        const size_t width = image.width;
+
+        auto scanline = make_ScratchArrayXMVECTOR(width);
+        if (!scanline)
+            return E_OUTOFMEMORY;
+
+        const size_t rowPitch = image.rowPitch;
+        const uint8_t *pSrc = image.pixels + startRow * rowPitch;
+
+        for (size_t h = startRow; h < endRow; ++h)
+        {
+            if (!LoadScanline(scanline.get(), width, pSrc, rowPitch, image.format))
+                return E_FAIL;
+
+            pixelFunc(scanline.get(), width, h, slot);
+
+            pSrc += rowPitch;
+        }
+
+        return S_OK;
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    HRESULT TransformImage_(
+        const Image& srcImage,
+        size_t startRow,
+        size_t endRow,
+        const TransformFunc& pixelFunc,
+        const Image& destImage)
+    {
+        if (!srcImage.pixels || !destImage.pixels)
+            return E_POINTER;
+
+        if (srcImage.width != destImage.width || srcImage.height != destImage.height || srcImage.format != destImage.format)
+            return E_FAIL;
+
+        assert(startRow <= endRow && endRow <= srcImage.height);
+
+        const size_t width = srcImage.width;
+
+        auto scanlines = make_ScratchArrayXMVECTOR(uint64_t(width) * 2);
+        if (!scanlines)
+            return E_OUTOFMEMORY;
+
+        XMVECTOR* sScanline = scanlines.get();
+        XMVECTOR* dScanline = scanlines.get() + width;
+
+        const size_t spitch = srcImage.rowPitch;
+        const uint8_t *pSrc = srcImage.pixels + startRow * spitch;
+
+        const size_t dpitch = destImage.rowPitch;
+        uint8_t *pDest = destImage.pixels + startRow * dpitch;
+
+        for (size_t h = startRow; h < endRow; ++h)
+        {
+            if (!LoadScanline(sScanline, width, pSrc, spitch, srcImage.format))
+                return E_FAIL;
+
+        #ifdef _DEBUG
+            memset(dScanline, 0xCD, sizeof(XMVECTOR)*width);
+        #endif
+
+            pixelFunc(dScanline, sScanline, width, h);
+
+            if (!StoreScanline(pDest, destImage.rowPitch, destImage.format, dScanline, width))
+                return E_FAIL;
+
+            pSrc += spitch;
+            pDest += dpitch;
+        }
+
+        return S_OK;
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    // Number of images visited for the given metadata, after validating them
+    //-------------------------------------------------------------------------------------
+    HRESULT GetPixelFuncImageCount(
+        _In_reads_(nimages) const Image* images,
+        size_t nimages,
+        const TexMetadata& metadata,
+        DXGI_FORMAT format,
+        _In_reads_opt_(nimages) const Image* destImages,
+        size_t& count) noexcept
+    {
+        count = 0;
+
+        switch (metadata.dimension)
+        {
+        case TEX_DIMENSION_TEXTURE1D:
+        case TEX_DIMENSION_TEXTURE2D:
+            count = nimages;
+            break;
+
+        case TEX_DIMENSION_TEXTURE3D:
+            {
+                size_t d = metadata.depth;
+                for (size_t level = 0; level < metadata.mipLevels; ++level)
+                {
+                    count += d;
+
+                    if (d > 1)
+                        d >>= 1;
+                }
+
+                if (count > nimages)
+                    return E_FAIL;
+            }
+            break;
+
+        default:
+            return E_FAIL;
+        }
+
+        for (size_t index = 0; index < count; ++index)
+        {
+            const Image& img = images[index];
+            if (img.format != format)
+                return E_FAIL;
+
+            if ((img.width > UINT32_MAX) || (img.height > UINT32_MAX))
+                return E_FAIL;
+
+            if (destImages && (img.width != destImages[index].width || img.height != destImages[index].height))
+                return E_FAIL;
+        }
+
+        return S_OK;
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    // Runs bandFunc(image index, startRow, endRow, slot) for each band, concurrently when OpenMP is available
+    //-------------------------------------------------------------------------------------
+    template<typename TBandFunc>
+    HRESULT ProcessPixelFuncBands(
+        _In_reads_(nimages) const Image* images,
+        size_t nimages,
+        TBandFunc bandFunc)
+    {
+        return ProcessBands(nimages,
+            [&](size_t index) -> BandLayout
+            {
+                return GetPixelFuncBandLayout(images[index]);
+            },
+            [&](size_t band, size_t index, size_t startRow, size_t endRow) -> HRESULT
+            {
+                return bandFunc(index, startRow, endRow, band);
+            },
+            true);
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    TexMetadata GetPixelFuncMetadata(const Image& image) noexcept
+    {
+        TexMetadata mdata = {};
+        mdata.width = image.width;
+        mdata.height = image.height;
+        mdata.depth = mdata.arraySize = mdata.mipLevels = 1;
+        mdata.format = image.format;
+        mdata.dimension = TEX_DIMENSION_TEXTURE2D;
+        return mdata;
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    HRESULT EvaluateImages(
+        _In_reads_(nimages) const Image* images,
+        size_t nimages,
+        const TexMetadata& metadata,
+        const std::function<void __cdecl(size_t slots)>* initFunc,
+        const EvaluateSlotFunc& pixelFunc,
+        bool parallel)
+    {
+        if (!images || !nimages)
+            return E_INVALIDARG;
+
         if (!pixelFunc)
             return E_INVALIDARG;
 
-        if (!image.pixels)
+        if (!IsValid(metadata.format))
+            return E_INVALIDARG;
+
+        if (IsPlanar(metadata.format) || IsPalettized(metadata.format) || IsTypeless(metadata.format))
+            return HRESULT_E_NOT_SUPPORTED;
+
+        if (metadata.width > UINT32_MAX
+            || metadata.height > UINT32_MAX)
+            return E_INVALIDARG;
+
+        if (metadata.IsVolumemap() && metadata.depth > UINT16_MAX)
+            return E_INVALIDARG;
+
+        ScratchImage temp;
+        DXGI_FORMAT format = metadata.format;
+        if (IsCompressed(format))
+        {
+            HRESULT hr = Decompress(images, nimages, metadata, DXGI_FORMAT_R32G32B32A32_FLOAT, temp);
+            if (FAILED(hr))
+                return hr;
+
+            if (nimages != temp.GetImageCount())
+                return E_UNEXPECTED;
+
+            images = temp.GetImages();
+            format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+        }
+
+        size_t count = 0;
+        HRESULT hr = GetPixelFuncImageCount(images, nimages, metadata, format, nullptr, count);
+        if (FAILED(hr))
+            return hr;
+
+        if (!parallel)
+        {
+            for (size_t index = 0; index < count; ++index)
+            {
+                hr = EvaluateImage_(images[index], 0, images[index].height, 0, pixelFunc);
+                if (FAILED(hr))
+                    return hr;
+            }
+
+            return S_OK;
+        }
+
+        if (initFunc && *initFunc)
+        {
+            // One slot per band
+            (*initFunc)(CountBands(count,
+                [&](size_t index) -> BandLayout
+                {
+                    return GetPixelFuncBandLayout(images[index]);
+                }));
+        }
+
+        return ProcessPixelFuncBands(images, count,
+            [&](size_t index, size_t startRow, size_t endRow, size_t slot) -> HRESULT
+            {
+                return EvaluateImage_(images[index], startRow, endRow, slot, pixelFunc);
+            });
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    HRESULT TransformImages(
+        _In_reads_(nimages) const Image* srcImages,
+        size_t nimages,
+        const TexMetadata& metadata,
+        const TransformFunc& pixelFunc,
+        ScratchImage& result,
+        TEX_PIXELFUNC_FLAGS flags)
+    {
+        if (!srcImages || !nimages)
+            return E_INVALIDARG;
+
+        if (!pixelFunc)
+            return E_INVALIDARG;
+
+        if (IsPlanar(metadata.format) || IsPalettized(metadata.format) || IsCompressed(metadata.format) || IsTypeless(metadata.format))
+            return HRESULT_E_NOT_SUPPORTED;
+
+        if (metadata.width > UINT32_MAX
+            || metadata.height > UINT32_MAX)
+            return E_INVALIDARG;
+
+        if (metadata.IsVolumemap() && metadata.depth > UINT16_MAX)
+            return E_INVALIDARG;
+
+        HRESULT hr = result.Initialize(metadata);
+        if (FAILED(hr))
+            return hr;
+
+        if (nimages != result.GetImageCount())
+        {
+            result.Release();
+            return E_FAIL;
+        }
+
+        const Image* dest = result.GetImages();
+        if (!dest)
+        {
+            result.Release();
             return E_POINTER;
+        }
+
+        size_t count = 0;
+        hr = GetPixelFuncImageCount(srcImages, nimages, metadata, metadata.format, dest, count);
+        if (FAILED(hr))
+        {
+            result.Release();
+            return hr;
+        }
+
+        if (flags & TEX_PIXELFUNC_PARALLEL)
+        {
+            hr = ProcessPixelFuncBands(srcImages, count,
+                [&](size_t index, size_t startRow, size_t endRow, size_t) -> HRESULT
+                {
+                    return TransformImage_(srcImages[index], startRow, endRow, pixelFunc, dest[index]);
+                });
+        }
+        else
+        {
+            for (size_t index = 0; index < count; ++index)
+            {
+                hr = TransformImage_(srcImages[index], 0, srcImages[index].height, pixelFunc, dest[index]);
+                if (FAILED(hr))
+                    break;
+            }
+        }
+
+        if (FAILED(hr))
+        {
+            result.Release();
+            return hr;
+        }
+
+        return S_OK;
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    // CopyRectangle helpers
+    //-------------------------------------------------------------------------------------
+    constexpr size_t c_CopyRectBandPixels = 64 * 1024;
+    constexpr size_t c_CopyRectParallelPixels = 256 * 1024;
+
+    // Raw copy of whole 4x4 blocks between images of the same BC format
+    HRESULT CopyRectangleBC(
+        const Image& srcImage,
+        const Rect& srcRect,
+        const Image& dstImage,
+        size_t xOffset,
+        size_t yOffset) noexcept
+    {
+        assert(srcImage.format == dstImage.format && IsCompressed(srcImage.format));
+
+        // The rectangle must lie on the block grid; a partial block is only allowed where
+        // the copy reaches the right or bottom edge of both images
+        if ((srcRect.x & 3) || (srcRect.y & 3) || (xOffset & 3) || (yOffset & 3))
+            return E_INVALIDARG;
+
+        if ((srcRect.w & 3) && (((srcRect.x + srcRect.w) != srcImage.width) || ((xOffset + srcRect.w) != dstImage.width)))
+            return E_INVALIDARG;
 
-        assert(!IsCompressed(image.format));
+        if ((srcRect.h & 3) && (((srcRect.y + srcRect.h) != srcImage.height) || ((yOffset + srcRect.h) != dstImage.height)))
+            return E_INVALIDARG;
 
-        const size_t width = image.width;
+        // BC1/BC4 are 4 bits per pixel (8-byte blocks), the rest 8 bits per pixel (16-byte blocks)
+        const size_t blockSize = BitsPerPixel(srcImage.format) * 2;
+        if (!blockSize)
+            return E_INVALIDARG;
 
-        auto scanline = make_AlignedArrayXMVECTOR(width);
-        if (!scanline)
-            return E_OUTOFMEMORY;
+        const uint8_t* pEndSrc = srcImage.pixels + srcImage.rowPitch * ((srcImage.height + 3) >> 2);
+        const uint8_t* pEndDest = dstImage.pixels + dstImage.rowPitch * ((dstImage.height + 3) >> 2);
 
-        const uint8_t *pSrc = image.pixels;
-        const size_t rowPitch = image.rowPitch;
+        const uint8_t* pSrc = srcImage.pixels + (srcRect.y >> 2) * srcImage.rowPitch + (srcRect.x >> 2) * blockSize;
+        uint8_t* pDest = dstImage.pixels + (yOffset >> 2) * dstImage.rowPitch + (xOffset >> 2) * blockSize;
 
-        for (size_t h = 0; h < image.height; ++h)
+        const size_t copyW = ((srcRect.w + 3) >> 2) * blockSize;
+        const size_t nrows = (srcRect.h + 3) >> 2;
+        for (size_t h = 0; h < nrows; ++h)
         {
-            if (!LoadScanline(scanline.get(), width, pSrc, rowPitch, image.format))
+            if (((pSrc + copyW) > pEndSrc) || ((pDest + copyW) > pEndDest))
                 return E_FAIL;
 
-            pixelFunc(scanline.get(), width, h);
+            memcpy(pDest, pSrc, copyW);
 
-            pSrc += rowPitch;
+            pSrc += srcImage.rowPitch;
+            pDest += dstImage.rowPitch;
         }
 
         return S_OK;
     }
 
-
-    //-------------------------------------------------------------------------------------
-    HRESULT TransformImage_(
+    // Converts rows [startRow, endRow) of the rectangle between formats
+    HRESULT ConvertRectangleRows(
         const Image& srcImage,
-        const std::function<void __cdecl(_Out_writes_(width) XMVECTOR* outPixels, _In_reads_(width) const XMVECTOR* inPixels, size_t width, size_t y)>& pixelFunc,
-        const Image& destImage)
+        const Rect& srcRect,
+        const Image& dstImage,
+        TEX_FILTER_FLAGS filter,
+        size_t xOffset,
+        size_t yOffset,
+        size_t sbpp,
+        size_t dbpp,
+        size_t startRow,
+        size_t endRow) noexcept
     {
-        if (!pixelFunc)
-            return E_INVALIDARG;
-
-        if (!srcImage.pixels || !destImage.pixels)
-            return E_POINTER;
-
-        if (srcImage.width != destImage.width || srcImage.height != destImage.height || srcImage.format != destImage.format)
-            return E_FAIL;
+        const uint8_t* pEndSrc = srcImage.pixels + srcImage.rowPitch*srcImage.height;
+        const uint8_t* pEndDest = dstImage.pixels + dstImage.rowPitch*dstImage.height;
 
-        const size_t width = srcImage.width;
+        const uint8_t* pSrc = srcImage.pixels + ((srcRect.y + startRow) * srcImage.rowPitch) + (srcRect.x * sbpp);
+        uint8_t* pDest = dstImage.pixels + ((yOffset + startRow) * dstImage.rowPitch) + (xOffset * dbpp);
 
-        auto scanlines = make_AlignedArrayXMVECTOR(uint64_t(width) * 2);
-        if (!scanlines)
+        auto scanline = make_ScratchArrayXMVECTOR(srcRect.w);
+        if (!scanline)
             return E_OUTOFMEMORY;
 
-        XMVECTOR* sScanline = scanlines.get();
-        XMVECTOR* dScanline = scanlines.get() + width;
-
-        const uint8_t *pSrc = srcImage.pixels;
-        const size_t spitch = srcImage.rowPitch;
-
-        uint8_t *pDest = destImage.pixels;
-        const size_t dpitch = destImage.rowPitch;
+        const size_t copyS = srcRect.w * sbpp;
+        const size_t copyD = srcRect.w * dbpp;
 
-        for (size_t h = 0; h < srcImage.height; ++h)
+        for (size_t h = startRow; h < endRow; ++h)
         {
-            if (!LoadScanline(sScanline, width, pSrc, spitch, srcImage.format))
+            if (((pSrc + copyS) > pEndSrc) || ((pDest + copyD) > pEndDest))
                 return E_FAIL;
 
-        #ifdef _DEBUG
-            memset(dScanline, 0xCD, sizeof(XMVECTOR)*width);
-        #endif
+            if (!LoadScanline(scanline.get(), srcRect.w, pSrc, copyS, srcImage.format))
+                return E_FAIL;
 
-            pixelFunc(dScanline, sScanline, width, h);
+            ConvertScanline(scanline.get(), srcRect.w, dstImage.format, srcImage.format, filter);
 
-            if (!StoreScanline(pDest, destImage.rowPitch, destImage.format, dScanline, width))
+            if (!StoreScanline(pDest, copyD, dstImage.format, scanline.get(), srcRect.w))
                 return E_FAIL;
 
-            pSrc += spitch;
-            pDest += dpitch;
+            pSrc += srcImage.rowPitch;
+            pDest += dstImage.rowPitch;
         }
 
         return S_OK;
@@ -283,8 +984,7 @@ HRESULT DirectX::CopyRectangle(
     if (!srcImage.pixels || !dstImage.pixels)
         return E_POINTER;
 
-    if (IsCompressed(srcImage.format) || IsCompressed(dstImage.format)
-        || IsPlanar(srcImage.format) || IsPlanar(dstImage.format)
+    if (IsPlanar(srcImage.format) || IsPlanar(dstImage.format)
         || IsPalettized(srcImage.format) || IsPalettized(dstImage.format))
         return HRESULT_E_NOT_SUPPORTED;
 
@@ -299,6 +999,15 @@ HRESULT DirectX::CopyRectangle(
         return E_INVALIDARG;
     }
 
+    if (IsCompressed(srcImage.format) || IsCompressed(dstImage.format))
+    {
+        // Block-compressed images can only be copied as-is, a 4x4 block at a time
+        if (srcImage.format != dstImage.format)
+            return HRESULT_E_NOT_SUPPORTED;
+
+        return CopyRectangleBC(srcImage, srcRect, dstImage, xOffset, yOffset);
+    }
+
     // Compute source bytes-per-pixel
     size_t sbpp = BitsPerPixel(srcImage.format);
     if (!sbpp)
@@ -310,22 +1019,22 @@ HRESULT DirectX::CopyRectangle(
         return HRESULT_E_NOT_SUPPORTED;
     }
 
-    const uint8_t* pEndSrc = srcImage.pixels + srcImage.rowPitch*srcImage.height;
-    const uint8_t* pEndDest = dstImage.pixels + dstImage.rowPitch*dstImage.height;
-
     // Round to bytes
     sbpp = (sbpp + 7) / 8;
 
-    const uint8_t* pSrc = srcImage.pixels + (srcRect.y * srcImage.rowPitch) + (srcRect.x * sbpp);
-
     if (srcImage.format == dstImage.format)
     {
         // Direct copy case (avoid intermediate conversions)
+        const uint8_t* pEndSrc = srcImage.pixels + srcImage.rowPitch*srcImage.height;
+        const uint8_t* pEndDest = dstImage.pixels + dstImage.rowPitch*dstImage.height;
+
+        const uint8_t* pSrc = srcImage.pixels + (srcRect.y * srcImage.rowPitch) + (srcRect.x * sbpp);
         uint8_t* pDest = dstImage.pixels + (yOffset * dstImage.rowPitch) + (xOffset * sbpp);
+
         const size_t copyW = srcRect.w * sbpp;
         for (size_t h = 0; h < srcRect.h; ++h)
         {
-            if (((pSrc + copyW) > pEndSrc) || (pDest > pEndDest))
+            if (((pSrc + copyW) > pEndSrc) || ((pDest + copyW) > pEndDest))
                 return E_FAIL;
 
             memcpy(pDest, pSrc, copyW);
@@ -351,33 +1060,19 @@ HRESULT DirectX::CopyRectangle(
     // Round to bytes
     dbpp = (dbpp + 7) / 8;
 
-    uint8_t* pDest = dstImage.pixels + (yOffset * dstImage.rowPitch) + (xOffset * dbpp);
-
-    auto scanline = make_AlignedArrayXMVECTOR(srcRect.w);
-    if (!scanline)
-        return E_OUTOFMEMORY;
-
-    const size_t copyS = srcRect.w * sbpp;
-    const size_t copyD = srcRect.w * dbpp;
-
-    for (size_t h = 0; h < srcRect.h; ++h)
-    {
-        if (((pSrc + copyS) > pEndSrc) || ((pDest + copyD) > pEndDest))
-            return E_FAIL;
-
-        if (!LoadScanline(scanline.get(), srcRect.w, pSrc, copyS, srcImage.format))
-            return E_FAIL;
-
-        ConvertScanline(scanline.get(), srcRect.w, dstImage.format, srcImage.format, filter);
-
-        if (!StoreScanline(pDest, copyD, dstImage.format, scanline.get(), srcRect.w))
-            return E_FAIL;
-
-        pSrc += srcImage.rowPitch;
-        pDest += dstImage.rowPitch;
-    }
+    // Large conversions run in parallel bands of rows when the caller opts in
+    const bool parallel = (filter & TEX_FILTER_PARALLEL) && (uint64_t(srcRect.w) * uint64_t(srcRect.h)) >= c_CopyRectParallelPixels;
 
-    return S_OK;
+    return ProcessBands(1,
+        [&](size_t) -> BandLayout
+        {
+            return { srcRect.h, parallel ? std::max<size_t>(1, c_CopyRectBandPixels / srcRect.w) : srcRect.h };
+        },
+        [&](size_t, size_t, size_t startRow, size_t endRow) -> HRESULT
+        {
+            return ConvertRectangleRows(srcImage, srcRect, dstImage, filter, xOffset, yOffset, sbpp, dbpp, startRow, endRow);
+        },
+        parallel);
 }
 
 
@@ -392,79 +1087,37 @@ HRESULT DirectX::ComputeMSE(
     float* mseV,
     CMSE_FLAGS flags) noexcept
 {
-    if (!image1.pixels || !image2.pixels)
-        return E_POINTER;
-
-    if (image1.width != image2.width || image1.height != image2.height)
-        return E_INVALIDARG;
-
-    if (!IsValid(image1.format) || !IsValid(image2.format))
-        return E_INVALIDARG;
-
-    if (IsPlanar(image1.format) || IsPlanar(image2.format)
-        || IsPalettized(image1.format) || IsPalettized(image2.format)
-        || IsTypeless(image1.format) || IsTypeless(image2.format))
-        return HRESULT_E_NOT_SUPPORTED;
+    ImageMetrics metrics;
+    const HRESULT hr = ComputeMetrics(image1, image2, CMETRICS_MSE, flags, nullptr, metrics);
+    if (FAILED(hr))
+        return hr;
 
-    if (IsCompressed(image1.format))
+    mse = metrics.mse;
+    if (mseV)
     {
-        if (IsCompressed(image2.format))
-        {
-            // Case 1: both images are compressed, expand to RGBA32F
-            ScratchImage temp1;
-            HRESULT hr = Decompress(image1, DXGI_FORMAT_R32G32B32A32_FLOAT, temp1);
-            if (FAILED(hr))
-                return hr;
-
-            ScratchImage temp2;
-            hr = Decompress(image2, DXGI_FORMAT_R32G32B32A32_FLOAT, temp2);
-            if (FAILED(hr))
-                return hr;
-
-            const Image* img1 = temp1.GetImage(0, 0, 0);
-            const Image* img2 = temp2.GetImage(0, 0, 0);
-            if (!img1 || !img2)
-                return E_POINTER;
-
-            return ComputeMSE_(*img1, *img2, mse, mseV, flags);
-        }
-        else
-        {
-            // Case 2: image1 is compressed, expand to RGBA32F
-            ScratchImage temp;
-            HRESULT hr = Decompress(image1, DXGI_FORMAT_R32G32B32A32_FLOAT, temp);
-            if (FAILED(hr))
-                return hr;
+        memcpy(mseV, metrics.mseV, sizeof(float) * 4);
+    }
 
-            const Image* img = temp.GetImage(0, 0, 0);
-            if (!img)
-                return E_POINTER;
+    return S_OK;
+}
 
-            return ComputeMSE_(*img, image2, mse, mseV, flags);
-        }
-    }
-    else
-    {
-        if (IsCompressed(image2.format))
-        {
-            // Case 3: image2 is compressed, expand to RGBA32F
-            ScratchImage temp;
-            HRESULT hr = Decompress(image2, DXGI_FORMAT_R32G32B32A32_FLOAT, temp);
-            if (FAILED(hr))
-                return hr;
 
-            const Image* img = temp.GetImage(0, 0, 0);
-            if (!img)
-                return E_POINTER;
+//-------------------------------------------------------------------------------------
+// Computes MSE, PSNR, SSIM, and maximum error between two images in one pass
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT DirectX::ComputeImageMetrics(
+    const Image& image1,
+    const Image& image2,
+    CMETRICS_FLAGS metrics,
+    ImageMetrics& result,
+    CMSE_FLAGS flags,
+    const float* weights) noexcept
+{
+    if (!(metrics & CMETRICS_ALL) || (metrics & ~(CMETRICS_ALL | CMETRICS_PARALLEL)))
+        return E_INVALIDARG;
 
-            return ComputeMSE_(image1, *img, mse, mseV, flags);
-        }
-        else
-        {
-            // Case 4: neither image is compressed
-            return ComputeMSE_(image1, image2, mse, mseV, flags);
-        }
-    }
+    return ComputeMetrics(image1, image2, metrics, flags, weights, result);
 }
 
 
@@ -474,35 +1127,22 @@ HRESULT DirectX::ComputeMSE(
 _Use_decl_annotations_
 HRESULT DirectX::EvaluateImage(
     const Image& image,
-    std::function<void __cdecl(_In_reads_(width) const XMVECTOR* pixels, size_t width, size_t y)> pixelFunc)
+    std::function<void __cdecl(_In_reads_(width) const XMVECTOR* pixels, size_t width, size_t y)> pixelFunc,
+    TEX_PIXELFUNC_FLAGS flags)
 {
     if (image.width > UINT32_MAX
         || image.height > UINT32_MAX)
         return E_INVALIDARG;
 
-    if (!IsValid(image.format))
+    if (!pixelFunc)
         return E_INVALIDARG;
 
-    if (IsPlanar(image.format) || IsPalettized(image.format) || IsTypeless(image.format))
-        return HRESULT_E_NOT_SUPPORTED;
-
-    if (IsCompressed(image.format))
-    {
-        ScratchImage temp;
-        HRESULT hr = Decompress(image, DXGI_FORMAT_R32G32B32A32_FLOAT, temp);
-        if (FAILED(hr))
-            return hr;
-
-        const Image* img = temp.GetImage(0, 0, 0);
-        if (!img)
-            return E_POINTER;
-
-        return EvaluateImage_(*img, pixelFunc);
-    }
-    else
-    {
-        return EvaluateImage_(image, pixelFunc);
-    }
+    return EvaluateImages(&image, 1, GetPixelFuncMetadata(image), nullptr,
+        [&](const XMVECTOR* pixels, size_t width, size_t y, size_t)
+        {
+            pixelFunc(pixels, width, y);
+        },
+        (flags & TEX_PIXELFUNC_PARALLEL) != 0);
 }
 
 _Use_decl_annotations_
@@ -510,92 +1150,42 @@ HRESULT DirectX::EvaluateImage(
     const Image* images,
     size_t nimages,
     const TexMetadata& metadata,
-    std::function<void __cdecl(_In_reads_(width) const XMVECTOR* pixels, size_t width, size_t y)> pixelFunc)
+    std::function<void __cdecl(_In_reads_(width) const XMVECTOR* pixels, size_t width, size_t y)> pixelFunc,
+    TEX_PIXELFUNC_FLAGS flags)
 {
-    if (!images || !nimages)
-        return E_INVALIDARG;
-
-    if (!IsValid(metadata.format))
-        return E_INVALIDARG;
-
-    if (IsPlanar(metadata.format) || IsPalettized(metadata.format) || IsTypeless(metadata.format))
-        return HRESULT_E_NOT_SUPPORTED;
-
-    if (metadata.width > UINT32_MAX
-        || metadata.height > UINT32_MAX)
-        return E_INVALIDARG;
-
-    if (metadata.IsVolumemap() && metadata.depth > UINT16_MAX)
+    if (!pixelFunc)
         return E_INVALIDARG;
 
-    ScratchImage temp;
-    DXGI_FORMAT format = metadata.format;
-    if (IsCompressed(format))
-    {
-        HRESULT hr = Decompress(images, nimages, metadata, DXGI_FORMAT_R32G32B32A32_FLOAT, temp);
-        if (FAILED(hr))
-            return hr;
-
-        if (nimages != temp.GetImageCount())
-            return E_UNEXPECTED;
-
-        images = temp.GetImages();
-        format = DXGI_FORMAT_R32G32B32A32_FLOAT;
-    }
-
-    switch (metadata.dimension)
-    {
-    case TEX_DIMENSION_TEXTURE1D:
-    case TEX_DIMENSION_TEXTURE2D:
-        for (size_t index = 0; index < nimages; ++index)
-        {
-            const Image& img = images[index];
-            if (img.format != format)
-                return E_FAIL;
-
-            if ((img.width > UINT32_MAX) || (img.height > UINT32_MAX))
-                return E_FAIL;
-
-            HRESULT hr = EvaluateImage_(img, pixelFunc);
-            if (FAILED(hr))
-                return hr;
-        }
-        break;
-
-    case TEX_DIMENSION_TEXTURE3D:
+    return EvaluateImages(images, nimages, metadata, nullptr,
+        [&](const XMVECTOR* pixels, size_t width, size_t y, size_t)
         {
-            size_t index = 0;
-            size_t d = metadata.depth;
-            for (size_t level = 0; level < metadata.mipLevels; ++level)
-            {
-                for (size_t slice = 0; slice < d; ++slice, ++index)
-                {
-                    if (index >= nimages)
-                        return E_FAIL;
-
-                    const Image& img = images[index];
-                    if (img.format != format)
-                        return E_FAIL;
-
-                    if ((img.width > UINT32_MAX) || (img.height > UINT32_MAX))
-                        return E_FAIL;
-
-                    HRESULT hr = EvaluateImage_(img, pixelFunc);
-                    if (FAILED(hr))
-                        return hr;
-                }
+            pixelFunc(pixels, width, y);
+        },
+        (flags & TEX_PIXELFUNC_PARALLEL) != 0);
+}
 
-                if (d > 1)
-                    d >>= 1;
-            }
-        }
-        break;
+_Use_decl_annotations_
+HRESULT DirectX::EvaluateImage(
+    const Image& image,
+    std::function<void __cdecl(size_t slots)> initFunc,
+    std::function<void __cdecl(_In_reads_(width) const XMVECTOR* pixels, size_t width, size_t y, size_t slot)> pixelFunc)
+{
+    if (image.width > UINT32_MAX
+        || image.height > UINT32_MAX)
+        return E_INVALIDARG;
 
-    default:
-        return E_FAIL;
-    }
+    return EvaluateImages(&image, 1, GetPixelFuncMetadata(image), &initFunc, pixelFunc, true);
+}
 
-    return S_OK;
+_Use_decl_annotations_
+HRESULT DirectX::EvaluateImage(
+    const Image* images,
+    size_t nimages,
+    const TexMetadata& metadata,
+    std::function<void __cdecl(size_t slots)> initFunc,
+    std::function<void __cdecl(_In_reads_(width) const XMVECTOR* pixels, size_t width, size_t y, size_t slot)> pixelFunc)
+{
+    return EvaluateImages(images, nimages, metadata, &initFunc, pixelFunc, true);
 }
 
 
@@ -606,34 +1196,14 @@ _Use_decl_annotations_
 HRESULT DirectX::TransformImage(
     const Image& image,
     std::function<void __cdecl(_Out_writes_(width) XMVECTOR* outPixels, _In_reads_(width) const XMVECTOR* inPixels, size_t width, size_t y)> pixelFunc,
-    ScratchImage& result)
+    ScratchImage& result,
+    TEX_PIXELFUNC_FLAGS flags)
 {
     if (image.width > UINT32_MAX
         || image.height > UINT32_MAX)
         return E_INVALIDARG;
 
-    if (IsPlanar(image.format) || IsPalettized(image.format) || IsCompressed(image.format) || IsTypeless(image.format))
-        return HRESULT_E_NOT_SUPPORTED;
-
-    HRESULT hr = result.Initialize2D(image.format, image.width, image.height, 1, 1);
-    if (FAILED(hr))
-        return hr;
-
-    const Image* dimg = result.GetImage(0, 0, 0);
-    if (!dimg)
-    {
-        result.Release();
-        return E_POINTER;
-    }
-
-    hr = TransformImage_(image, pixelFunc, *dimg);
-    if (FAILED(hr))
-    {
-        result.Release();
-        return hr;
-    }
-
-    return S_OK;
+    return TransformImages(&image, 1, GetPixelFuncMetadata(image), pixelFunc, result, flags);
 }
 
 _Use_decl_annotations_
@@ -641,127 +1211,8 @@ HRESULT DirectX::TransformImage(
     const Image* srcImages,
     size_t nimages, const TexMetadata& metadata,
     std::function<void __cdecl(_Out_writes_(width) XMVECTOR* outPixels, _In_reads_(width) const XMVECTOR* inPixels, size_t width, size_t y)> pixelFunc,
-    ScratchImage& result)
+    ScratchImage& result,
+    TEX_PIXELFUNC_FLAGS flags)
 {
-    if (!srcImages || !nimages)
-        return E_INVALIDARG;
-
-    if (IsPlanar(metadata.format) || IsPalettized(metadata.format) || IsCompressed(metadata.format) || IsTypeless(metadata.format))
-        return HRESULT_E_NOT_SUPPORTED;
-
-    if (metadata.width > UINT32_MAX
-        || metadata.height > UINT32_MAX)
-        return E_INVALIDARG;
-
-    if (metadata.IsVolumemap() && metadata.depth > UINT16_MAX)
-        return E_INVALIDARG;
-
-    HRESULT hr = result.Initialize(metadata);
-    if (FAILED(hr))
-        return hr;
-
-    if (nimages != result.GetImageCount())
-    {
-        result.Release();
-        return E_FAIL;
-    }
-
-    const Image* dest = result.GetImages();
-    if (!dest)
-    {
-        result.Release();
-        return E_POINTER;
-    }
-
-    switch (metadata.dimension)
-    {
-    case TEX_DIMENSION_TEXTURE1D:
-    case TEX_DIMENSION_TEXTURE2D:
-        for (size_t index = 0; index < nimages; ++index)
-        {
-            const Image& src = srcImages[index];
-            if (src.format != metadata.format)
-            {
-                result.Release();
-                return E_FAIL;
-            }
-
-            if ((src.width > UINT32_MAX) || (src.height > UINT32_MAX))
-            {
-                result.Release();
-                return E_FAIL;
-            }
-
-            const Image& dst = dest[index];
-
-            if (src.width != dst.width || src.height != dst.height)
-            {
-                result.Release();
-                return E_FAIL;
-            }
-
-            hr = TransformImage_(src, pixelFunc, dst);
-            if (FAILED(hr))
-            {
-                result.Release();
-                return hr;
-            }
-        }
-        break;
-
-    case TEX_DIMENSION_TEXTURE3D:
-        {
-            size_t index = 0;
-            size_t d = metadata.depth;
-            for (size_t level = 0; level < metadata.mipLevels; ++level)
-            {
-                for (size_t slice = 0; slice < d; ++slice, ++index)
-                {
-                    if (index >= nimages)
-                    {
-                        result.Release();
-                        return E_FAIL;
-                    }
-
-                    const Image& src = srcImages[index];
-                    if (src.format != metadata.format)
-                    {
-                        result.Release();
-                        return E_FAIL;
-                    }
-
-                    if ((src.width > UINT32_MAX) || (src.height > UINT32_MAX))
-                    {
-                        result.Release();
-                        return E_FAIL;
-                    }
-
-                    const Image& dst = dest[index];
-
-                    if (src.width != dst.width || src.height != dst.height)
-                    {
-                        result.Release();
-                        return E_FAIL;
-                    }
-
-                    hr = TransformImage_(src, pixelFunc, dst);
-                    if (FAILED(hr))
-                    {
-                        result.Release();
-                        return hr;
-                    }
-                }
-
-                if (d > 1)
-                    d >>= 1;
-            }
-        }
-        break;
-
-    default:
-        result.Release();
-        return E_FAIL;
-    }
-
-    return S_OK;
+    return TransformImages(srcImages, nimages, metadata, pixelFunc, result, flags);
 }
@@ -13,6 +13,7 @@
 
 using namespace DirectX;
 using namespace DirectX::Internal;
+using namespace DirectX::PackedVector;
 
 namespace
 {
@@ -74,12 +75,139 @@ namespace
         }
     }
 
-    HRESULT ComputeNMap(_In_ const Image& srcImage, _In_ CNMAP_FLAGS flags, _In_ float amplitude,
-        _In_ DXGI_FORMAT format, _In_ const Image& normalMap) noexcept
+    //-------------------------------------------------------------------------------------
+    // Normals are computed four texels at a time, with the derivatives, normalization,
+    // and occlusion term evaluated across SIMD lanes. Each evaluated row holds the
+    // wrapped or mirrored neighbor at both ends and is padded to a multiple of four.
+    //-------------------------------------------------------------------------------------
+    inline size_t GetEvaluatedRowStride(size_t width) noexcept
     {
-        if (!srcImage.pixels || !normalMap.pixels)
-            return E_INVALIDARG;
+        return ((width + 3) & ~size_t(3)) + 2;
+    }
+
+    // Source row for y in [-1, height], wrapping or mirroring in V
+    inline size_t GetSourceRow(ptrdiff_t y, size_t height, CNMAP_FLAGS flags) noexcept
+    {
+        if (y < 0)
+            return (flags & CNMAP_MIRROR_V) ? 0 : (height - 1);
+
+        if (static_cast<size_t>(y) >= height)
+            return (flags & CNMAP_MIRROR_V) ? (height - 1) : 0;
+
+        return static_cast<size_t>(y);
+    }
+
+    struct NormalBlock
+    {
+        XMVECTOR x;
+        XMVECTOR y;
+        XMVECTOR z;
+        XMVECTOR w;
+    };
+
+    inline XMVECTOR LoadEvaluated(_In_reads_(4) const float* ptr) noexcept
+    {
+        return XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(ptr));
+    }
+
+    void ComputeNormals(
+        _In_reads_(6) const float* val0,
+        _In_reads_(6) const float* val1,
+        _In_reads_(6) const float* val2,
+        float amplitude,
+        bool occlusion,
+        NormalBlock& result) noexcept
+    {
+        const XMVECTOR a0 = LoadEvaluated(val0);
+        const XMVECTOR b0 = LoadEvaluated(val0 + 1);
+        const XMVECTOR c0 = LoadEvaluated(val0 + 2);
+        const XMVECTOR a1 = LoadEvaluated(val1);
+        const XMVECTOR b1 = LoadEvaluated(val1 + 1);
+        const XMVECTOR c1 = LoadEvaluated(val1 + 2);
+        const XMVECTOR a2 = LoadEvaluated(val2);
+        const XMVECTOR b2 = LoadEvaluated(val2 + 1);
+        const XMVECTOR c2 = LoadEvaluated(val2 + 2);
+
+        static const XMVECTORF32 s_Six = { { { 6.f, 6.f, 6.f, 6.f } } };
+
+        // Compute normal via central differencing
+        XMVECTOR totDelta = XMVectorAdd(XMVectorAdd(XMVectorSubtract(a0, c0), XMVectorSubtract(a1, c1)), XMVectorSubtract(a2, c2));
+        const XMVECTOR deltaZX = XMVectorDivide(XMVectorScale(totDelta, amplitude), s_Six);
+
+        totDelta = XMVectorAdd(XMVectorAdd(XMVectorSubtract(a0, a2), XMVectorSubtract(b0, b2)), XMVectorSubtract(c0, c2));
+        const XMVECTOR deltaZY = XMVectorDivide(XMVectorScale(totDelta, amplitude), s_Six);
+
+        // cross((-1, 0, deltaZX), (0, -1, deltaZY)) is (deltaZX, deltaZY, 1)
+        const XMVECTOR lengthSq = XMVectorAdd(XMVectorMultiplyAdd(deltaZX, deltaZX, XMVectorMultiply(deltaZY, deltaZY)), g_XMOne);
+        const XMVECTOR length = XMVectorSqrt(lengthSq);
+
+        result.x = XMVectorDivide(deltaZX, length);
+        result.y = XMVectorDivide(deltaZY, length);
+        result.z = XMVectorDivide(g_XMOne, length);
+        result.w = g_XMOne;
+
+        if (occlusion)
+        {
+            // Sum of the neighbors above the center texel, skipping the center itself
+            XMVECTOR delta = XMVectorMax(XMVectorSubtract(a0, b1), g_XMZero);
+            delta = XMVectorAdd(delta, XMVectorMax(XMVectorSubtract(b0, b1), g_XMZero));
+            delta = XMVectorAdd(delta, XMVectorMax(XMVectorSubtract(c0, b1), g_XMZero));
+            delta = XMVectorAdd(delta, XMVectorMax(XMVectorSubtract(a1, b1), g_XMZero));
+            delta = XMVectorAdd(delta, XMVectorMax(XMVectorSubtract(c1, b1), g_XMZero));
+            delta = XMVectorAdd(delta, XMVectorMax(XMVectorSubtract(a2, b1), g_XMZero));
+            delta = XMVectorAdd(delta, XMVectorMax(XMVectorSubtract(b2, b1), g_XMZero));
+            delta = XMVectorAdd(delta, XMVectorMax(XMVectorSubtract(c2, b1), g_XMZero));
+
+            // Average delta (divide by 8, scale by amplitude factor)
+            delta = XMVectorScale(delta, 0.125f * amplitude);
+
+            // If <= 0, then no occlusion
+            const XMVECTOR r = XMVectorSqrt(XMVectorMultiplyAdd(delta, delta, g_XMOne));
+            const XMVECTOR alpha = XMVectorDivide(XMVectorSubtract(r, delta), r);
+            result.w = XMVectorSelect(g_XMOne, alpha, XMVectorGreater(delta, g_XMZero));
+        }
+    }
+
+    //--- Two-channel targets receive the normal's XY directly, ready for BC5 ---
+    bool IsTwoChannelNormalFormat(DXGI_FORMAT format) noexcept
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_R8G8_UNORM:
+        case DXGI_FORMAT_R8G8_SNORM:
+        case DXGI_FORMAT_R16G16_UNORM:
+        case DXGI_FORMAT_R16G16_SNORM:
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    void XM_CALLCONV StoreTwoChannelNormal(
+        _Out_ uint8_t* pDest,
+        DXGI_FORMAT format,
+        FXMVECTOR v) noexcept
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_R8G8_UNORM:    XMStoreUByteN2(reinterpret_cast<XMUBYTEN2*>(pDest), v); break;
+        case DXGI_FORMAT_R8G8_SNORM:    XMStoreByteN2(reinterpret_cast<XMBYTEN2*>(pDest), v); break;
+        case DXGI_FORMAT_R16G16_UNORM:  XMStoreUShortN2(reinterpret_cast<XMUSHORTN2*>(pDest), v); break;
+        case DXGI_FORMAT_R16G16_SNORM:  XMStoreShortN2(reinterpret_cast<XMSHORTN2*>(pDest), v); break;
+        default: break;
+        }
+    }
 
+    HRESULT ComputeNMapRows(
+        _In_ const Image& srcImage,
+        _In_ CNMAP_FLAGS flags,
+        _In_ float amplitude,
+        _In_ DXGI_FORMAT format,
+        _In_ const Image& normalMap,
+        _In_ size_t startRow,
+        _In_ size_t endRow) noexcept
+    {
         const uint32_t convFlags = GetConvertFlags(format);
         if (!convFlags)
             return E_FAIL;
@@ -89,147 +217,97 @@ namespace
 
         const size_t width = srcImage.width;
         const size_t height = srcImage.height;
-        if (width != normalMap.width || height != normalMap.height)
-            return E_FAIL;
+        const size_t stride = GetEvaluatedRowStride(width);
+        const bool twoChannel = IsTwoChannelNormalFormat(format);
+        const bool occlusion = (flags & CNMAP_COMPUTE_OCCLUSION) && (convFlags & CONVF_A);
 
-        // Allocate temporary space (4 scanlines and 3 evaluated rows)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 4);
+        // Allocate temporary space (1 scanline, 1 target row, and 3 evaluated rows)
+        auto scanline = make_ScratchArrayXMVECTOR(uint64_t(width) * 2);
         if (!scanline)
             return E_OUTOFMEMORY;
 
-        auto buffer = make_AlignedArrayFloat((uint64_t(width) + 2) * 3);
+        auto buffer = make_AlignedArrayFloat(uint64_t(stride) * 3);
         if (!buffer)
             return E_OUTOFMEMORY;
 
-        uint8_t* pDest = normalMap.pixels;
-        if (!pDest)
-            return E_POINTER;
+        memset(buffer.get(), 0, sizeof(float) * stride * 3);
 
-        XMVECTOR* row0 = scanline.get();
-        XMVECTOR* row1 = row0 + width;
-        XMVECTOR* row2 = row1 + width;
-        XMVECTOR* target = row2 + width;
+        XMVECTOR* row = scanline.get();
+        XMVECTOR* target = row + width;
 
         float* val0 = buffer.get();
-        float* val1 = val0 + width + 2;
-        float* val2 = val1 + width + 2;
+        float* val1 = val0 + stride;
+        float* val2 = val1 + stride;
 
         const size_t rowPitch = srcImage.rowPitch;
-        const uint8_t* pSrc = srcImage.pixels;
 
-        // Read first scanline row into 'row1'
-        if (!LoadScanline(row1, width, pSrc, rowPitch, srcImage.format))
+        // Evaluate the rows above and at the first row of the band
+        if (!LoadScanline(row, width, srcImage.pixels + rowPitch * GetSourceRow(static_cast<ptrdiff_t>(startRow) - 1, height, flags), rowPitch, srcImage.format))
             return E_FAIL;
 
-        // Setup 'row0'
-        if (flags & CNMAP_MIRROR_V)
-        {
-            // Mirror first row
-            memcpy(row0, row1, rowPitch);
-        }
-        else
-        {
-            // Read last row (Wrap V)
-            if (!LoadScanline(row0, width, pSrc + (rowPitch * (height - 1)), rowPitch, srcImage.format))
-                return E_FAIL;
-        }
+        EvaluateRow(row, val0, width, flags);
+
+        if (!LoadScanline(row, width, srcImage.pixels + rowPitch * startRow, rowPitch, srcImage.format))
+            return E_FAIL;
+
+        EvaluateRow(row, val1, width, flags);
 
-        // Evaluate the initial rows
-        EvaluateRow(row0, val0, width, flags);
-        EvaluateRow(row1, val1, width, flags);
+        // 0.5f*normal + 0.5f -or- invert sign case: -0.5f*normal + 0.5f
+        const XMVECTOR scale = (convFlags & CONVF_UNORM)
+            ? ((flags & CNMAP_INVERT_SIGN) ? g_XMNegativeOneHalf : g_XMOneHalf)
+            : ((flags & CNMAP_INVERT_SIGN) ? g_XMNegativeOne : g_XMOne);
+        const XMVECTOR bias = (convFlags & CONVF_UNORM) ? g_XMOneHalf : g_XMZero;
 
-        pSrc += rowPitch;
+        uint8_t* pDest = normalMap.pixels + normalMap.rowPitch * startRow;
+        const size_t bytesPerPixel = twoChannel ? (BitsPerPixel(format) / 8) : 0;
 
-        for (size_t y = 0; y < height; ++y)
+        for (size_t y = startRow; y < endRow; ++y)
         {
-            // Load next scanline of source image
-            if (y < (height - 1))
-            {
-                if (!LoadScanline(row2, width, pSrc, rowPitch, srcImage.format))
-                    return E_FAIL;
-            }
-            else
-            {
-                if (flags & CNMAP_MIRROR_V)
-                {
-                    // Use last row of source image
-                    if (!LoadScanline(row2, width, srcImage.pixels + (rowPitch * (height - 1)), rowPitch, srcImage.format))
-                        return E_FAIL;
-                }
-                else
-                {
-                    // Use first row of source image (Wrap V)
-                    if (!LoadScanline(row2, width, srcImage.pixels, rowPitch, srcImage.format))
-                        return E_FAIL;
-                }
-            }
+            // Load and evaluate the next scanline of the source image
+            if (!LoadScanline(row, width, srcImage.pixels + rowPitch * GetSourceRow(static_cast<ptrdiff_t>(y) + 1, height, flags), rowPitch, srcImage.format))
+                return E_FAIL;
 
-            // Evaluate row
-            EvaluateRow(row2, val2, width, flags);
+            EvaluateRow(row, val2, width, flags);
 
             // Generate target scanline
-            XMVECTOR *dptr = target;
-            for (size_t x = 0; x < width; ++x)
+            for (size_t x = 0; x < width; x += 4)
             {
-                // Compute normal via central differencing
-                float totDelta = (val0[x] - val0[x + 2]) + (val1[x] - val1[x + 2]) + (val2[x] - val2[x + 2]);
-                const float deltaZX = totDelta * amplitude / 6.f;
+                NormalBlock n;
+                ComputeNormals(val0 + x, val1 + x, val2 + x, amplitude, occlusion, n);
 
-                totDelta = (val0[x] - val2[x]) + (val0[x + 1] - val2[x + 1]) + (val0[x + 2] - val2[x + 2]);
-                const float deltaZY = totDelta * amplitude / 6.f;
+                n.x = XMVectorMultiplyAdd(scale, n.x, bias);
+                n.y = XMVectorMultiplyAdd(scale, n.y, bias);
 
-                const XMVECTOR vx = XMVectorSetZ(g_XMNegIdentityR0, deltaZX);   // (-1.0f, 0.0f, deltaZX)
-                const XMVECTOR vy = XMVectorSetZ(g_XMNegIdentityR1, deltaZY);   // (0.0f, -1.0f, deltaZY)
+                const size_t count = std::min<size_t>(4, width - x);
 
-                const XMVECTOR normal = XMVector3Normalize(XMVector3Cross(vx, vy));
-
-                // Compute alpha (1.0 or an occlusion term)
-                float alpha = 1.f;
-
-                if (flags & CNMAP_COMPUTE_OCCLUSION)
+                if (twoChannel)
                 {
-                    float delta = 0.f;
-                    const float c = val1[x + 1];
-
-                    float t = val0[x] - c;  if (t > 0.f) delta += t;
-                    t = val0[x + 1] - c;    if (t > 0.f) delta += t;
-                    t = val0[x + 2] - c;    if (t > 0.f) delta += t;
-                    t = val1[x] - c;    if (t > 0.f) delta += t;
-                    // Skip current pixel
-                    t = val1[x + 2] - c;    if (t > 0.f) delta += t;
-                    t = val2[x] - c;    if (t > 0.f) delta += t;
-                    t = val2[x + 1] - c;    if (t > 0.f) delta += t;
-                    t = val2[x + 2] - c;    if (t > 0.f) delta += t;
-
-                    // Average delta (divide by 8, scale by amplitude factor)
-                    delta *= 0.125f * amplitude;
-                    if (delta > 0.f)
+                    const XMVECTOR xy01 = XMVectorMergeXY(n.x, n.y);
+                    const XMVECTOR xy23 = XMVectorMergeZW(n.x, n.y);
+                    const XMVECTOR xy[4] = { xy01, XMVectorSwizzle<2, 3, 0, 1>(xy01), xy23, XMVectorSwizzle<2, 3, 0, 1>(xy23) };
+
+                    for (size_t j = 0; j < count; ++j)
                     {
-                        // If < 0, then no occlusion
-                        const float r = sqrtf(1.f + delta*delta);
-                        alpha = (r - delta) / r;
+                        StoreTwoChannelNormal(pDest + (x + j) * bytesPerPixel, format, xy[j]);
                     }
                 }
-
-                // Encode based on target format
-                if (convFlags & CONVF_UNORM)
-                {
-                    // 0.5f*normal + 0.5f -or- invert sign case: -0.5f*normal + 0.5f
-                    const XMVECTOR n1 = XMVectorMultiplyAdd((flags & CNMAP_INVERT_SIGN) ? g_XMNegativeOneHalf : g_XMOneHalf, normal, g_XMOneHalf);
-                    *dptr++ = XMVectorSetW(n1, alpha);
-                }
-                else if (flags & CNMAP_INVERT_SIGN)
-                {
-                    *dptr++ = XMVectorSetW(XMVectorNegate(normal), alpha);
-                }
                 else
                 {
-                    *dptr++ = XMVectorSetW(normal, alpha);
+                    n.z = XMVectorMultiplyAdd(scale, n.z, bias);
+
+                    const XMMATRIX m = XMMatrixTranspose(XMMATRIX(n.x, n.y, n.z, n.w));
+                    for (size_t j = 0; j < count; ++j)
+                    {
+                        target[x + j] = m.r[j];
+                    }
                 }
             }
 
-            if (!StoreScanline(pDest, normalMap.rowPitch, format, target, width))
-                return E_FAIL;
+            if (!twoChannel)
+            {
+                if (!StoreScanline(pDest, normalMap.rowPitch, format, target, width))
+                    return E_FAIL;
+            }
 
             // Cycle buffers
             float* temp = val0;
@@ -237,12 +315,53 @@ namespace
             val1 = val2;
             val2 = temp;
 
-            pSrc += rowPitch;
             pDest += normalMap.rowPitch;
         }
 
         return S_OK;
     }
+
+    //-------------------------------------------------------------------------------------
+    // Images are split into bands of rows (see ProcessBands); with CNMAP_PARALLEL the bands of
+    // every image are computed in parallel, each re-evaluating the two source rows around its start.
+    //-------------------------------------------------------------------------------------
+    constexpr size_t c_NormalMapBandPixels = 256 * 1024;
+
+    inline size_t GetNormalMapBandHeight(const Image& image) noexcept
+    {
+        return std::max<size_t>(16, c_NormalMapBandPixels / std::max<size_t>(1, image.width));
+    }
+
+    HRESULT ComputeNMap(
+        _In_reads_(nimages) const Image* srcImages,
+        _In_ size_t nimages,
+        _In_ CNMAP_FLAGS flags,
+        _In_ float amplitude,
+        _In_ DXGI_FORMAT format,
+        _In_reads_(nimages) const Image* normalMaps) noexcept
+    {
+        assert(srcImages && normalMaps && nimages > 0);
+
+        for (size_t index = 0; index < nimages; ++index)
+        {
+            if (!srcImages[index].pixels || !normalMaps[index].pixels)
+                return E_INVALIDARG;
+
+            if (srcImages[index].width != normalMaps[index].width || srcImages[index].height != normalMaps[index].height)
+                return E_FAIL;
+        }
+
+        return ProcessBands(nimages,
+            [&](size_t index) -> BandLayout
+            {
+                return { srcImages[index].height, GetNormalMapBandHeight(srcImages[index]) };
+            },
+            [&](size_t, size_t index, size_t startRow, size_t endRow) -> HRESULT
+            {
+                return ComputeNMapRows(srcImages[index], flags, amplitude, format, normalMaps[index], startRow, endRow);
+            },
+            (flags & CNMAP_PARALLEL) != 0);
+    }
 }
 
 
@@ -302,7 +421,7 @@ HRESULT DirectX::ComputeNormalMap(
         return E_POINTER;
     }
 
-    hr = ComputeNMap(srcImage, flags, amplitude, format, *img);
+    hr = ComputeNMap(&srcImage, 1, flags, amplitude, format, img);
     if (FAILED(hr))
     {
         normalMap.Release();
@@ -383,13 +502,13 @@ HRESULT DirectX::ComputeNormalMap(
             normalMaps.Release();
             return E_FAIL;
         }
+    }
 
-        hr = ComputeNMap(src, flags, amplitude, format, dest[index]);
-        if (FAILED(hr))
-        {
-            normalMaps.Release();
-            return hr;
-        }
+    hr = ComputeNMap(srcImages, nimages, flags, amplitude, format, dest);
+    if (FAILED(hr))
+    {
+        normalMaps.Release();
+        return hr;
     }
 
     return S_OK;
@@ -145,10 +145,12 @@
 #include <algorithm>
 #include <cassert>
 #include <cctype>
+#include <cmath>
 #include <cstdlib>
 #include <ctime>
 #include <cstring>
 #include <iterator>
+#include <limits>
 #include <memory>
 #include <new>
 #include <tuple>
@@ -440,6 +442,67 @@ namespace DirectX
             _Inout_updates_all_(count) XMVECTOR* pBuffer, _In_ size_t count,
             _In_ DXGI_FORMAT outFormat, _In_ DXGI_FORMAT inFormat, _In_ TEX_FILTER_FLAGS flags) noexcept;
 
+        //---------------------------------------------------------------------------------
+        // Temporary scanline storage drawn from the calling thread's scratch memory.
+        // Allocations must be released in reverse order, which scoped locals guarantee.
+        // Memory is reused by later operations on the same thread (see SetThreadScratchMemory).
+        class ScratchArrayXMVECTOR
+        {
+        public:
+            explicit ScratchArrayXMVECTOR(uint64_t count) noexcept;
+            ~ScratchArrayXMVECTOR();
+
+            ScratchArrayXMVECTOR(ScratchArrayXMVECTOR&& moveFrom) noexcept :
+                m_data(moveFrom.m_data),
+                m_bytes(moveFrom.m_bytes),
+                m_offset(moveFrom.m_offset),
+                m_heap(moveFrom.m_heap)
+            {
+                // The moved-from object no longer returns the block; this one does when it goes out of scope
+                moveFrom.m_data = nullptr;
+                moveFrom.m_bytes = 0;
+            }
+
+            ScratchArrayXMVECTOR& operator= (ScratchArrayXMVECTOR&&) = delete;
+
+            ScratchArrayXMVECTOR(const ScratchArrayXMVECTOR&) = delete;
+            ScratchArrayXMVECTOR& operator=(const ScratchArrayXMVECTOR&) = delete;
+
+            XMVECTOR* get() const noexcept { return m_data; }
+            explicit operator bool() const noexcept { return m_data != nullptr; }
+
+        private:
+            XMVECTOR*   m_data;
+            size_t      m_bytes;
+            size_t      m_offset;
+            bool        m_heap;
+        };
+
+        inline ScratchArrayXMVECTOR make_ScratchArrayXMVECTOR(uint64_t count) noexcept
+        {
+            return ScratchArrayXMVECTOR(count);
+        }
+
+        //---------------------------------------------------------------------------------
+        // Band scheduling: each image is split into bands of rows, numbered across all the
+        // images in order. bandFunc(band, index, startRow, endRow) processes rows [startRow,
+        // endRow) of image 'index'; with 'parallel' (and OpenMP) bands run concurrently in any
+        // order, and after a failure the remaining bands are skipped and the first error returned.
+        struct BandLayout
+        {
+            size_t height;      // rows to split
+            size_t bandHeight;  // rows per band (the last band of an image may be shorter)
+        };
+
+        using BandLayoutFunc = std::function<BandLayout __cdecl(size_t index)>;
+        using BandFunc = std::function<HRESULT __cdecl(size_t band, size_t index, size_t startRow, size_t endRow)>;
+
+        size_t __cdecl CountBands(_In_ size_t nimages, _In_ const BandLayoutFunc& layoutFunc);
+
+        HRESULT __cdecl ProcessBands(
+            _In_ size_t nimages, _In_ const BandLayoutFunc& layoutFunc,
+            _In_ const BandFunc& bandFunc, _In_ bool parallel);
+
         //---------------------------------------------------------------------------------
         // Misc helper functions
         bool __cdecl IsAlphaAllOpaqueBC(_In_ const Image& cImage) noexcept;
@@ -450,6 +513,10 @@ namespace DirectX
             _In_ IWICBitmap* original,
             _In_ size_t newWidth, _In_ size_t newHeight, _In_ TEX_FILTER_FLAGS filter,
             _Inout_ const Image* img) noexcept;
+
+        HRESULT __cdecl ResizeViaR32G32B32A32UsingWIC(_In_ IWICImagingFactory* pWIC,
+            _In_ const Image& srcImage, _In_ TEX_FILTER_FLAGS filter,
+            _In_ const Image& destImage) noexcept;
     #endif
 
     } // namespace Internal
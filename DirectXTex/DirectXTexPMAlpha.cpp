@@ -32,7 +32,7 @@ namespace
         assert(srcImage.width == destImage.width);
         assert(srcImage.height == destImage.height);
 
-        auto scanline = make_AlignedArrayXMVECTOR(srcImage.width);
+        auto scanline = make_ScratchArrayXMVECTOR(srcImage.width);
         if (!scanline)
             return E_OUTOFMEMORY;
 
@@ -75,7 +75,7 @@ namespace
         static_assert(static_cast<int>(TEX_PMALPHA_SRGB) == static_cast<int>(TEX_FILTER_SRGB), "TEX_PMALHPA_SRGB* should match TEX_FILTER_SRGB*");
         flags &= TEX_PMALPHA_SRGB;
 
-        auto scanline = make_AlignedArrayXMVECTOR(srcImage.width);
+        auto scanline = make_ScratchArrayXMVECTOR(srcImage.width);
         if (!scanline)
             return E_OUTOFMEMORY;
 
@@ -117,7 +117,7 @@ namespace
         assert(srcImage.width == destImage.width);
         assert(srcImage.height == destImage.height);
 
-        auto scanline = make_AlignedArrayXMVECTOR(srcImage.width);
+        auto scanline = make_ScratchArrayXMVECTOR(srcImage.width);
         if (!scanline)
             return E_OUTOFMEMORY;
 
@@ -163,7 +163,7 @@ namespace
         static_assert(static_cast<int>(TEX_PMALPHA_SRGB) == static_cast<int>(TEX_FILTER_SRGB), "TEX_PMALPHA_SRGB* should match TEX_FILTER_SRGB*");
         flags &= TEX_PMALPHA_SRGB;
 
-        auto scanline = make_AlignedArrayXMVECTOR(srcImage.width);
+        auto scanline = make_ScratchArrayXMVECTOR(srcImage.width);
         if (!scanline)
             return E_OUTOFMEMORY;
 
@@ -200,6 +200,240 @@ namespace
 
         return S_OK;
     }
+
+    HRESULT PremultiplyAlphaFloat(const Image& srcImage, TEX_PMALPHA_FLAGS flags, const Image& destImage) noexcept
+    {
+        if (flags & TEX_PMALPHA_REVERSE)
+        {
+            return (flags & TEX_PMALPHA_IGNORE_SRGB) ? DemultiplyAlpha(srcImage, destImage) : DemultiplyAlphaLinear(srcImage, flags, destImage);
+        }
+        else
+        {
+            return (flags & TEX_PMALPHA_IGNORE_SRGB) ? PremultiplyAlpha_(srcImage, destImage) : PremultiplyAlphaLinear(srcImage, flags, destImage);
+        }
+    }
+
+    //---------------------------------------------------------------------------------
+    // 8-bit UNORM formats: every color channel goes through the same function of
+    // (alpha, value), including any sRGB conversion, so the float path above is run once
+    // over all 256x256 pairs and the result is applied by table lookup.
+    //---------------------------------------------------------------------------------
+    constexpr size_t c_PMAlphaTableSize = 256 * 256;
+
+    bool IsPMAlphaTableFormat(DXGI_FORMAT format) noexcept
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+        case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    HRESULT CreatePMAlphaTable(DXGI_FORMAT format, TEX_PMALPHA_FLAGS flags, _Out_writes_(c_PMAlphaTableSize) uint8_t* table) noexcept
+    {
+        // Texel (c, a) of a 256x256 image holds value c with alpha a in every color channel
+        std::unique_ptr<uint8_t[]> temp(new (std::nothrow) uint8_t[c_PMAlphaTableSize * 4 * 2]);
+        if (!temp)
+            return E_OUTOFMEMORY;
+
+        uint8_t* pixels = temp.get();
+        for (size_t a = 0; a < 256; ++a)
+        {
+            for (size_t c = 0; c < 256; ++c, pixels += 4)
+            {
+                pixels[0] = pixels[1] = pixels[2] = static_cast<uint8_t>(c);
+                pixels[3] = static_cast<uint8_t>(a);
+            }
+        }
+
+        Image srcImage = { 256, 256, format, 256 * 4, c_PMAlphaTableSize * 4, temp.get() };
+        Image destImage = srcImage;
+        destImage.pixels = temp.get() + c_PMAlphaTableSize * 4;
+
+        const HRESULT hr = PremultiplyAlphaFloat(srcImage, flags, destImage);
+        if (FAILED(hr))
+            return hr;
+
+        for (size_t i = 0; i < c_PMAlphaTableSize; ++i)
+        {
+            table[i] = destImage.pixels[i * 4];
+        }
+
+        return S_OK;
+    }
+
+    void PremultiplyAlphaTable(const Image& srcImage, const uint8_t* table, const Image& destImage) noexcept
+    {
+        assert(srcImage.width == destImage.width);
+        assert(srcImage.height == destImage.height);
+
+        const uint8_t *pSrc = srcImage.pixels;
+        uint8_t *pDest = destImage.pixels;
+
+        for (size_t h = 0; h < srcImage.height; ++h)
+        {
+            const uint8_t* sPtr = pSrc;
+            uint8_t* dPtr = pDest;
+            for (size_t w = 0; w < srcImage.width; ++w, sPtr += 4, dPtr += 4)
+            {
+                const uint8_t* row = table + size_t(sPtr[3]) * 256;
+                dPtr[0] = row[sPtr[0]];
+                dPtr[1] = row[sPtr[1]];
+                dPtr[2] = row[sPtr[2]];
+                dPtr[3] = sPtr[3];
+            }
+
+            pSrc += srcImage.rowPitch;
+            pDest += destImage.rowPitch;
+        }
+    }
+
+    //---------------------------------------------------------------------------------
+    // 16-bit UNORM without sRGB conversion is done in fixed point: c * a / 65535 and
+    // c * 65535 / a, both rounded to nearest.
+    //---------------------------------------------------------------------------------
+    bool IsPMAlpha16Format(DXGI_FORMAT format, TEX_PMALPHA_FLAGS flags) noexcept
+    {
+        return (format == DXGI_FORMAT_R16G16B16A16_UNORM)
+            && ((flags & TEX_PMALPHA_IGNORE_SRGB) || !(flags & TEX_PMALPHA_SRGB));
+    }
+
+    void PremultiplyAlpha16(const Image& srcImage, bool reverse, const Image& destImage) noexcept
+    {
+        assert(srcImage.width == destImage.width);
+        assert(srcImage.height == destImage.height);
+
+        const uint8_t *pSrc = srcImage.pixels;
+        uint8_t *pDest = destImage.pixels;
+
+        for (size_t h = 0; h < srcImage.height; ++h)
+        {
+            auto sPtr = reinterpret_cast<const uint16_t*>(pSrc);
+            auto dPtr = reinterpret_cast<uint16_t*>(pDest);
+            for (size_t w = 0; w < srcImage.width; ++w, sPtr += 4, dPtr += 4)
+            {
+                const uint32_t alpha = sPtr[3];
+                if (reverse)
+                {
+                    for (size_t j = 0; j < 3; ++j)
+                    {
+                        uint64_t value = sPtr[j];
+                        if (alpha > 0)
+                        {
+                            value = std::min<uint64_t>(65535u, (value * 65535u * 2u + alpha) / (uint64_t(alpha) * 2u));
+                        }
+                        dPtr[j] = static_cast<uint16_t>(value);
+                    }
+                }
+                else
+                {
+                    for (size_t j = 0; j < 3; ++j)
+                    {
+                        const uint32_t t = uint32_t(sPtr[j]) * alpha + 32768u;
+                        dPtr[j] = static_cast<uint16_t>((t + (t >> 16)) >> 16);
+                    }
+                }
+                dPtr[3] = sPtr[3];
+            }
+
+            pSrc += srcImage.rowPitch;
+            pDest += destImage.rowPitch;
+        }
+    }
+
+    //---------------------------------------------------------------------------------
+    // Images are split into bands of rows; with OpenMP the bands of every image are
+    // processed in parallel.
+    //---------------------------------------------------------------------------------
+    constexpr size_t c_PMAlphaBandPixels = 64 * 1024;
+
+    inline size_t GetPMAlphaBandHeight(const Image& image) noexcept
+    {
+        return std::max<size_t>(1, c_PMAlphaBandPixels / std::max<size_t>(1, image.width));
+    }
+
+    HRESULT PremultiplyAlphaRows(
+        const Image& srcImage,
+        TEX_PMALPHA_FLAGS flags,
+        const uint8_t* table,
+        const Image& destImage,
+        size_t startRow,
+        size_t endRow) noexcept
+    {
+        assert(startRow < endRow && endRow <= srcImage.height);
+
+        Image src = srcImage;
+        src.height = endRow - startRow;
+        src.pixels += startRow * srcImage.rowPitch;
+        src.slicePitch = src.height * src.rowPitch;
+
+        Image dest = destImage;
+        dest.height = src.height;
+        dest.pixels += startRow * destImage.rowPitch;
+        dest.slicePitch = dest.height * dest.rowPitch;
+
+        if (table)
+        {
+            PremultiplyAlphaTable(src, table, dest);
+            return S_OK;
+        }
+
+        if (IsPMAlpha16Format(src.format, flags))
+        {
+            PremultiplyAlpha16(src, (flags & TEX_PMALPHA_REVERSE) != 0, dest);
+            return S_OK;
+        }
+
+        return PremultiplyAlphaFloat(src, flags, dest);
+    }
+
+    HRESULT PremultiplyAlphaImages(
+        const Image* srcImages,
+        size_t nimages,
+        TEX_PMALPHA_FLAGS flags,
+        const Image* destImages) noexcept
+    {
+        assert(srcImages && destImages && nimages > 0);
+
+        uint64_t pixels = 0;
+        for (size_t index = 0; index < nimages; ++index)
+        {
+            const Image& src = srcImages[index];
+            if (!src.pixels || !destImages[index].pixels)
+                return E_POINTER;
+
+            pixels += uint64_t(src.width) * uint64_t(src.height);
+        }
+
+        std::unique_ptr<uint8_t[]> table;
+        if (IsPMAlphaTableFormat(srcImages[0].format) && pixels >= c_PMAlphaTableSize)
+        {
+            table.reset(new (std::nothrow) uint8_t[c_PMAlphaTableSize]);
+            if (!table)
+                return E_OUTOFMEMORY;
+
+            const HRESULT hr = CreatePMAlphaTable(srcImages[0].format, flags, table.get());
+            if (FAILED(hr))
+                return hr;
+        }
+
+        return ProcessBands(nimages,
+            [&](size_t index) -> BandLayout
+            {
+                return { srcImages[index].height, GetPMAlphaBandHeight(srcImages[index]) };
+            },
+            [&](size_t, size_t index, size_t startRow, size_t endRow) -> HRESULT
+            {
+                return PremultiplyAlphaRows(srcImages[index], flags, table.get(), destImages[index], startRow, endRow);
+            },
+            (flags & TEX_PMALPHA_PARALLEL) != 0);
+    }
 }
 
 
@@ -240,14 +474,7 @@ HRESULT DirectX::PremultiplyAlpha(
         return E_POINTER;
     }
 
-    if (flags & TEX_PMALPHA_REVERSE)
-    {
-        hr = (flags & TEX_PMALPHA_IGNORE_SRGB) ? DemultiplyAlpha(srcImage, *rimage) : DemultiplyAlphaLinear(srcImage, flags, *rimage);
-    }
-    else
-    {
-        hr = (flags & TEX_PMALPHA_IGNORE_SRGB) ? PremultiplyAlpha_(srcImage, *rimage) : PremultiplyAlphaLinear(srcImage, flags, *rimage);
-    }
+    hr = PremultiplyAlphaImages(&srcImage, 1, flags, rimage);
     if (FAILED(hr))
     {
         image.Release();
@@ -314,7 +541,10 @@ HRESULT DirectX::PremultiplyAlpha(
         }
 
         if ((src.width > UINT32_MAX) || (src.height > UINT32_MAX))
+        {
+            result.Release();
             return E_FAIL;
+        }
 
         const Image& dst = dest[index];
         assert(dst.format == metadata.format);
@@ -324,20 +554,13 @@ HRESULT DirectX::PremultiplyAlpha(
             result.Release();
             return E_FAIL;
         }
+    }
 
-        if (flags & TEX_PMALPHA_REVERSE)
-        {
-            hr = (flags & TEX_PMALPHA_IGNORE_SRGB) ? DemultiplyAlpha(src, dst) : DemultiplyAlphaLinear(src, flags, dst);
-        }
-        else
-        {
-            hr = (flags & TEX_PMALPHA_IGNORE_SRGB) ? PremultiplyAlpha_(src, dst) : PremultiplyAlphaLinear(src, flags, dst);
-        }
-        if (FAILED(hr))
-        {
-            result.Release();
-            return hr;
-        }
+    hr = PremultiplyAlphaImages(srcImages, nimages, flags, dest);
+    if (FAILED(hr))
+    {
+        result.Release();
+        return hr;
     }
 
     return S_OK;
@@ -13,6 +13,11 @@
 
 #include "filters.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#pragma warning(disable : 4616 6993)
+#endif
+
 using namespace DirectX;
 using namespace DirectX::Internal;
 using Microsoft::WRL::ComPtr;
@@ -136,6 +141,18 @@ namespace
         assert(srcImage.format != DXGI_FORMAT_R32G32B32A32_FLOAT);
         assert(srcImage.format == destImage.format);
 
+        if (!(filter & TEX_FILTER_SEPARATE_ALPHA))
+        {
+            // Source rows are converted as the WIC scaler reads them, and results are stored back in bands
+            bool iswic2 = false;
+            auto pWIC = GetWICFactory(iswic2);
+            if (!pWIC)
+                return E_NOINTERFACE;
+
+            return ResizeViaR32G32B32A32UsingWIC(pWIC, srcImage, filter, destImage);
+        }
+
+        // Separate color and alpha resizing works on whole WIC bitmaps, so it needs full float copies
         ScratchImage temp;
         HRESULT hr = ConvertToR32G32B32A32(srcImage, temp);
         if (FAILED(hr))
@@ -252,13 +269,13 @@ namespace
     //-------------------------------------------------------------------------------------
 
     //--- Point Filter ---
-    HRESULT ResizePointFilter(const Image& srcImage, const Image& destImage) noexcept
+    HRESULT ResizePointFilter(const Image& srcImage, const Image& destImage, size_t yStart, size_t yEnd) noexcept
     {
         assert(srcImage.pixels && destImage.pixels);
         assert(srcImage.format == destImage.format);
 
         // Allocate temporary space (2 scanlines)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(srcImage.width) + destImage.width);
+        auto scanline = make_ScratchArrayXMVECTOR(uint64_t(srcImage.width) + destImage.width);
         if (!scanline)
             return E_OUTOFMEMORY;
 
@@ -271,7 +288,7 @@ namespace
     #endif
 
         const uint8_t* pSrc = srcImage.pixels;
-        uint8_t* pDest = destImage.pixels;
+        uint8_t* pDest = destImage.pixels + (destImage.rowPitch * yStart);
 
         const size_t rowPitch = srcImage.rowPitch;
 
@@ -280,8 +297,8 @@ namespace
 
         size_t lasty = size_t(-1);
 
-        size_t sy = 0;
-        for (size_t y = 0; y < destImage.height; ++y)
+        size_t sy = yinc * yStart;
+        for (size_t y = yStart; y < yEnd; ++y)
         {
             if ((lasty ^ sy) >> 16)
             {
@@ -309,7 +326,7 @@ namespace
 
 
     //--- Box Filter ---
-    HRESULT ResizeBoxFilter(const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage) noexcept
+    HRESULT ResizeBoxFilter(const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage, size_t yStart, size_t yEnd) noexcept
     {
         using namespace DirectX::Filters;
 
@@ -320,7 +337,7 @@ namespace
             return E_FAIL;
 
         // Allocate temporary space (3 scanlines)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(srcImage.width) * 2 + destImage.width);
+        auto scanline = make_ScratchArrayXMVECTOR(uint64_t(srcImage.width) * 2 + destImage.width);
         if (!scanline)
             return E_OUTOFMEMORY;
 
@@ -337,12 +354,12 @@ namespace
         const XMVECTOR* urow2 = urow0 + 1;
         const XMVECTOR* urow3 = urow1 + 1;
 
-        const uint8_t* pSrc = srcImage.pixels;
-        uint8_t* pDest = destImage.pixels;
-
         const size_t rowPitch = srcImage.rowPitch;
 
-        for (size_t y = 0; y < destImage.height; ++y)
+        const uint8_t* pSrc = srcImage.pixels + (rowPitch * (yStart << 1));
+        uint8_t* pDest = destImage.pixels + (destImage.rowPitch * yStart);
+
+        for (size_t y = yStart; y < yEnd; ++y)
         {
             if (!LoadScanlineLinear(urow0, srcImage.width, pSrc, rowPitch, srcImage.format, filter))
                 return E_FAIL;
@@ -371,8 +388,163 @@ namespace
     }
 
 
+    //--- Box Filter (integer ratio) ---
+    HRESULT ResizeBoxReduceFilter(const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage, size_t yStart, size_t yEnd) noexcept
+    {
+        assert(srcImage.pixels && destImage.pixels);
+        assert(srcImage.format == destImage.format);
+
+        const size_t xratio = srcImage.width / destImage.width;
+        const size_t yratio = srcImage.height / destImage.height;
+        if (!xratio || !yratio
+            || (xratio * destImage.width) != srcImage.width
+            || (yratio * destImage.height) != srcImage.height)
+            return E_FAIL;
+
+        // Allocate temporary space (source scanline, plus running sum of the reduced rows)
+        auto scanline = make_ScratchArrayXMVECTOR(uint64_t(srcImage.width) + destImage.width);
+        if (!scanline)
+            return E_OUTOFMEMORY;
+
+        XMVECTOR* row = scanline.get();
+        XMVECTOR* target = row + srcImage.width;
+
+        const XMVECTOR scale = XMVectorReplicate(1.f / float(xratio * yratio));
+
+        const size_t rowPitch = srcImage.rowPitch;
+
+        const uint8_t* pSrc = srcImage.pixels + (rowPitch * yStart * yratio);
+        uint8_t* pDest = destImage.pixels + (destImage.rowPitch * yStart);
+
+        for (size_t y = yStart; y < yEnd; ++y)
+        {
+            for (size_t j = 0; j < yratio; ++j)
+            {
+                if (!LoadScanlineLinear(row, srcImage.width, pSrc, rowPitch, srcImage.format, filter))
+                    return E_FAIL;
+                pSrc += rowPitch;
+
+                const XMVECTOR* pRow = row;
+                for (size_t x = 0; x < destImage.width; ++x)
+                {
+                    XMVECTOR sum = *pRow++;
+                    for (size_t k = 1; k < xratio; ++k)
+                    {
+                        sum = XMVectorAdd(sum, *pRow++);
+                    }
+
+                    target[x] = (j > 0) ? XMVectorAdd(target[x], sum) : sum;
+                }
+            }
+
+            for (size_t x = 0; x < destImage.width; ++x)
+            {
+                target[x] = XMVectorMultiply(target[x], scale);
+            }
+
+            if (!StoreScanlineLinear(pDest, destImage.rowPitch, destImage.format, target, destImage.width, filter))
+                return E_FAIL;
+            pDest += destImage.rowPitch;
+        }
+
+        return S_OK;
+    }
+
+
+    //--- Fant Filter (area average for arbitrary ratios) ---
+    HRESULT ResizeFantFilter(const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage, size_t yStart, size_t yEnd) noexcept
+    {
+        using namespace DirectX::Filters;
+
+        assert(srcImage.pixels && destImage.pixels);
+        assert(srcImage.format == destImage.format);
+
+        // Allocate temporary space (source scanline, 2 horizontally filtered scanlines, plus target)
+        auto scanline = make_ScratchArrayXMVECTOR(uint64_t(srcImage.width) + uint64_t(destImage.width) * 3);
+        if (!scanline)
+            return E_OUTOFMEMORY;
+
+        const FilterTable tableX(FILTER_TABLE_AREA, srcImage.width, destImage.width, false);
+        const FilterTable tableY(FILTER_TABLE_AREA, srcImage.height, destImage.height, false);
+        if (!tableX || !tableY)
+            return E_OUTOFMEMORY;
+
+        const AreaFilter* afX = tableX.Area();
+        const AreaFilter* afY = tableY.Area();
+
+        XMVECTOR* target = scanline.get();
+        XMVECTOR* row = target + destImage.width;
+
+        // Source rows are visited in increasing order, so two cached rows cover the
+        // row shared by neighboring destination rows as well as upscaling
+        XMVECTOR* hrow[2] = { row + srcImage.width, row + srcImage.width + destImage.width };
+        size_t hindex[2] = { size_t(-1), size_t(-1) };
+        size_t hnext = 0;
+
+        const size_t rowPitch = srcImage.rowPitch;
+
+        uint8_t* pDest = destImage.pixels + (destImage.rowPitch * yStart);
+
+        for (size_t y = yStart; y < yEnd; ++y)
+        {
+            const auto& toY = afY[y];
+
+            for (size_t j = 0; j < toY.count; ++j)
+            {
+                const size_t v = toY.u0 + j;
+
+                const XMVECTOR* pRow;
+                if (hindex[0] == v)
+                {
+                    pRow = hrow[0];
+                }
+                else if (hindex[1] == v)
+                {
+                    pRow = hrow[1];
+                }
+                else
+                {
+                    if (!LoadScanlineLinear(row, srcImage.width, srcImage.pixels + (rowPitch * v), rowPitch, srcImage.format, filter))
+                        return E_FAIL;
+
+                    XMVECTOR* dest = hrow[hnext];
+                    for (size_t x = 0; x < destImage.width; ++x)
+                    {
+                        const auto& toX = afX[x];
+                        dest[x] = AreaFilterSum(toX, row + toX.u0);
+                    }
+
+                    hindex[hnext] = v;
+                    hnext ^= 1;
+                    pRow = dest;
+                }
+
+                float weight;
+                if (!j)
+                    weight = toY.weight0;
+                else if (j + 1 < toY.count)
+                    weight = toY.weight;
+                else
+                    weight = toY.weightN;
+
+                const XMVECTOR vweight = XMVectorReplicate(weight);
+                for (size_t x = 0; x < destImage.width; ++x)
+                {
+                    target[x] = (j > 0) ? XMVectorMultiplyAdd(pRow[x], vweight, target[x]) : XMVectorMultiply(pRow[x], vweight);
+                }
+            }
+
+            if (!StoreScanlineLinear(pDest, destImage.rowPitch, destImage.format, target, destImage.width, filter))
+                return E_FAIL;
+            pDest += destImage.rowPitch;
+        }
+
+        return S_OK;
+    }
+
+
     //--- Linear Filter ---
-    HRESULT ResizeLinearFilter(const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage) noexcept
+    HRESULT ResizeLinearFilter(const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage, size_t yStart, size_t yEnd) noexcept
     {
         using namespace DirectX::Filters;
 
@@ -380,19 +552,17 @@ namespace
         assert(srcImage.format == destImage.format);
 
         // Allocate temporary space (3 scanlines, plus X and Y filters)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(srcImage.width) * 2 + destImage.width);
+        auto scanline = make_ScratchArrayXMVECTOR(uint64_t(srcImage.width) * 2 + destImage.width);
         if (!scanline)
             return E_OUTOFMEMORY;
 
-        std::unique_ptr<LinearFilter[]> lf(new (std::nothrow) LinearFilter[destImage.width + destImage.height]);
-        if (!lf)
+        const FilterTable tableX(FILTER_TABLE_LINEAR, srcImage.width, destImage.width, (filter & TEX_FILTER_WRAP_U) != 0);
+        const FilterTable tableY(FILTER_TABLE_LINEAR, srcImage.height, destImage.height, (filter & TEX_FILTER_WRAP_V) != 0);
+        if (!tableX || !tableY)
             return E_OUTOFMEMORY;
 
-        LinearFilter* lfX = lf.get();
-        LinearFilter* lfY = lf.get() + destImage.width;
-
-        CreateLinearFilter(srcImage.width, destImage.width, (filter & TEX_FILTER_WRAP_U) != 0, lfX);
-        CreateLinearFilter(srcImage.height, destImage.height, (filter & TEX_FILTER_WRAP_V) != 0, lfY);
+        const LinearFilter* lfX = tableX.Linear();
+        const LinearFilter* lfY = tableY.Linear();
 
         XMVECTOR* target = scanline.get();
 
@@ -405,14 +575,14 @@ namespace
     #endif
 
         const uint8_t* pSrc = srcImage.pixels;
-        uint8_t* pDest = destImage.pixels;
+        uint8_t* pDest = destImage.pixels + (destImage.rowPitch * yStart);
 
         const size_t rowPitch = srcImage.rowPitch;
 
         size_t u0 = size_t(-1);
         size_t u1 = size_t(-1);
 
-        for (size_t y = 0; y < destImage.height; ++y)
+        for (size_t y = yStart; y < yEnd; ++y)
         {
             const auto& toY = lfY[y];
 
@@ -463,53 +633,67 @@ namespace
 #pragma clang diagnostic ignored "-Wextra-semi-stmt"
 #endif
 
-    HRESULT ResizeCubicFilter(const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage) noexcept
+    bool LoadCubicRow(
+        _Out_writes_(destWidth) XMVECTOR* dest, size_t destWidth,
+        _Out_writes_(srcImage.width) XMVECTOR* row,
+        const Image& srcImage, size_t v, TEX_FILTER_FLAGS filter,
+        _In_reads_(destWidth) const DirectX::Filters::CubicFilter* cfX) noexcept
+    {
+        if (!LoadScanlineLinear(row, srcImage.width, srcImage.pixels + (srcImage.rowPitch * v), srcImage.rowPitch, srcImage.format, filter))
+            return false;
+
+        DirectX::Filters::CubicFilterRow(dest, destWidth, row, cfX);
+        return true;
+    }
+
+    HRESULT ResizeCubicFilter(const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage, size_t yStart, size_t yEnd) noexcept
     {
         using namespace DirectX::Filters;
 
         assert(srcImage.pixels && destImage.pixels);
         assert(srcImage.format == destImage.format);
 
-        // Allocate temporary space (5 scanlines, plus X and Y filters)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(srcImage.width) * 4 + destImage.width);
+        // The filter is separable: each source row is resampled horizontally once into a ring of
+        // four destination-width rows, and output rows only perform the vertical pass.
+
+        // Allocate temporary space (1 source scanline, 5 destination scanlines, plus X and Y filters)
+        auto scanline = make_ScratchArrayXMVECTOR(uint64_t(srcImage.width) + uint64_t(destImage.width) * 5);
         if (!scanline)
             return E_OUTOFMEMORY;
 
-        std::unique_ptr<CubicFilter[]> cf(new (std::nothrow) CubicFilter[destImage.width + destImage.height]);
-        if (!cf)
+        const FilterTable tableX(FILTER_TABLE_CUBIC, srcImage.width, destImage.width, (filter & TEX_FILTER_WRAP_U) != 0, (filter & TEX_FILTER_MIRROR_U) != 0);
+        const FilterTable tableY(FILTER_TABLE_CUBIC, srcImage.height, destImage.height, (filter & TEX_FILTER_WRAP_V) != 0, (filter & TEX_FILTER_MIRROR_V) != 0);
+        if (!tableX || !tableY)
             return E_OUTOFMEMORY;
 
-        CubicFilter* cfX = cf.get();
-        CubicFilter* cfY = cf.get() + destImage.width;
+        const CubicFilter* cfX = tableX.Cubic();
+        const CubicFilter* cfY = tableY.Cubic();
 
-        CreateCubicFilter(srcImage.width, destImage.width, (filter & TEX_FILTER_WRAP_U) != 0, (filter & TEX_FILTER_MIRROR_U) != 0, cfX);
-        CreateCubicFilter(srcImage.height, destImage.height, (filter & TEX_FILTER_WRAP_V) != 0, (filter & TEX_FILTER_MIRROR_V) != 0, cfY);
+        const size_t width = destImage.width;
 
         XMVECTOR* target = scanline.get();
 
-        XMVECTOR* row0 = target + destImage.width;
-        XMVECTOR* row1 = row0 + srcImage.width;
-        XMVECTOR* row2 = row0 + srcImage.width * 2;
-        XMVECTOR* row3 = row0 + srcImage.width * 3;
+        XMVECTOR* row0 = target + width;
+        XMVECTOR* row1 = row0 + width;
+        XMVECTOR* row2 = row0 + width * 2;
+        XMVECTOR* row3 = row0 + width * 3;
+        XMVECTOR* srow = row0 + width * 4;
 
     #ifdef _DEBUG
-        memset(row0, 0xCD, sizeof(XMVECTOR)*srcImage.width);
-        memset(row1, 0xDD, sizeof(XMVECTOR)*srcImage.width);
-        memset(row2, 0xED, sizeof(XMVECTOR)*srcImage.width);
-        memset(row3, 0xFD, sizeof(XMVECTOR)*srcImage.width);
+        memset(row0, 0xCD, sizeof(XMVECTOR)*width);
+        memset(row1, 0xDD, sizeof(XMVECTOR)*width);
+        memset(row2, 0xED, sizeof(XMVECTOR)*width);
+        memset(row3, 0xFD, sizeof(XMVECTOR)*width);
     #endif
 
-        const uint8_t* pSrc = srcImage.pixels;
-        uint8_t* pDest = destImage.pixels;
-
-        const size_t rowPitch = srcImage.rowPitch;
+        uint8_t* pDest = destImage.pixels + (destImage.rowPitch * yStart);
 
         size_t u0 = size_t(-1);
         size_t u1 = size_t(-1);
         size_t u2 = size_t(-1);
         size_t u3 = size_t(-1);
 
-        for (size_t y = 0; y < destImage.height; ++y)
+        for (size_t y = yStart; y < yEnd; ++y)
         {
             const auto& toY = cfY[y];
 
@@ -520,7 +704,7 @@ namespace
                 {
                     u0 = toY.u0;
 
-                    if (!LoadScanlineLinear(row0, srcImage.width, pSrc + (rowPitch * u0), rowPitch, srcImage.format, filter))
+                    if (!LoadCubicRow(row0, width, srow, srcImage, u0, filter, cfX))
                         return E_FAIL;
                 }
                 else if (toY.u0 == u1)
@@ -553,7 +737,7 @@ namespace
                 {
                     u1 = toY.u1;
 
-                    if (!LoadScanlineLinear(row1, srcImage.width, pSrc + (rowPitch * u1), rowPitch, srcImage.format, filter))
+                    if (!LoadCubicRow(row1, width, srow, srcImage, u1, filter, cfX))
                         return E_FAIL;
                 }
                 else if (toY.u1 == u2)
@@ -579,7 +763,7 @@ namespace
                 {
                     u2 = toY.u2;
 
-                    if (!LoadScanlineLinear(row2, srcImage.width, pSrc + (rowPitch * u2), rowPitch, srcImage.format, filter))
+                    if (!LoadCubicRow(row2, width, srow, srcImage, u2, filter, cfX))
                         return E_FAIL;
                 }
                 else
@@ -596,25 +780,16 @@ namespace
             {
                 u3 = toY.u3;
 
-                if (!LoadScanlineLinear(row3, srcImage.width, pSrc + (rowPitch * u3), rowPitch, srcImage.format, filter))
+                if (!LoadCubicRow(row3, width, srow, srcImage, u3, filter, cfX))
                     return E_FAIL;
             }
 
-            for (size_t x = 0; x < destImage.width; ++x)
+            for (size_t x = 0; x < width; ++x)
             {
-                const auto& toX = cfX[x];
-
-                XMVECTOR C0, C1, C2, C3;
-
-                CUBIC_INTERPOLATE(C0, toX.x, row0[toX.u0], row0[toX.u1], row0[toX.u2], row0[toX.u3]);
-                CUBIC_INTERPOLATE(C1, toX.x, row1[toX.u0], row1[toX.u1], row1[toX.u2], row1[toX.u3]);
-                CUBIC_INTERPOLATE(C2, toX.x, row2[toX.u0], row2[toX.u1], row2[toX.u2], row2[toX.u3]);
-                CUBIC_INTERPOLATE(C3, toX.x, row3[toX.u0], row3[toX.u1], row3[toX.u2], row3[toX.u3]);
-
-                CUBIC_INTERPOLATE(target[x], toY.x, C0, C1, C2, C3);
+                CUBIC_INTERPOLATE(target[x], toY.x, row0[x], row1[x], row2[x], row3[x]);
             }
 
-            if (!StoreScanlineLinear(pDest, destImage.rowPitch, destImage.format, target, destImage.width, filter))
+            if (!StoreScanlineLinear(pDest, destImage.rowPitch, destImage.format, target, width, filter))
                 return E_FAIL;
             pDest += destImage.rowPitch;
         }
@@ -624,54 +799,61 @@ namespace
 
 
     //--- Triangle Filter ---
-    HRESULT ResizeTriangleFilter(const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage) noexcept
+    HRESULT ResizeTriangleFilter(const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage, size_t yStart, size_t yEnd) noexcept
     {
         using namespace DirectX::Filters;
 
         assert(srcImage.pixels && destImage.pixels);
         assert(srcImage.format == destImage.format);
 
-        // Allocate initial temporary space (1 scanline, accumulation rows, plus X and Y filters)
-        auto scanline = make_AlignedArrayXMVECTOR(srcImage.width);
+        // Allocate initial temporary space (source and horizontally filtered scanlines, accumulation rows, plus X and Y filters)
+        auto scanline = make_ScratchArrayXMVECTOR(uint64_t(srcImage.width) + destImage.width);
         if (!scanline)
             return E_OUTOFMEMORY;
 
-        std::unique_ptr<TriangleRow[]> rowActive(new (std::nothrow) TriangleRow[destImage.height]);
+        // Only destination rows [yStart, yEnd) are produced; source rows that do not contribute to them are skipped
+        const size_t bandHeight = yEnd - yStart;
+
+        std::unique_ptr<TriangleRow[]> rowActive(new (std::nothrow) TriangleRow[bandHeight]);
         if (!rowActive)
             return E_OUTOFMEMORY;
 
         TriangleRow * rowFree = nullptr;
 
-        std::unique_ptr<Filter> tfX;
-        HRESULT hr = CreateTriangleFilter(srcImage.width, destImage.width, (filter & TEX_FILTER_WRAP_U) != 0, tfX);
-        if (FAILED(hr))
-            return hr;
+        const FilterTable tableX(FILTER_TABLE_TRIANGLE, srcImage.width, destImage.width, (filter & TEX_FILTER_WRAP_U) != 0);
+        const FilterTable tableY(FILTER_TABLE_TRIANGLE, srcImage.height, destImage.height, (filter & TEX_FILTER_WRAP_V) != 0);
+        if (!tableX || !tableY)
+            return E_OUTOFMEMORY;
 
-        std::unique_ptr<Filter> tfY;
-        hr = CreateTriangleFilter(srcImage.height, destImage.height, (filter & TEX_FILTER_WRAP_V) != 0, tfY);
-        if (FAILED(hr))
-            return hr;
+        const Filter* tfX = tableX.Triangle();
+        const Filter* tfY = tableY.Triangle();
 
         XMVECTOR* row = scanline.get();
+        XMVECTOR* hrow = row + srcImage.width;
 
     #ifdef _DEBUG
         memset(row, 0xCD, sizeof(XMVECTOR)*srcImage.width);
     #endif
 
-        auto xFromEnd = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(tfX.get()) + tfX->sizeInBytes);
-        auto yFromEnd = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(tfY.get()) + tfY->sizeInBytes);
+        auto yFromEnd = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(tfY) + tfY->sizeInBytes);
 
         // Count times rows get written
-        for (FilterFrom* yFrom = tfY->from; yFrom < yFromEnd; )
+        size_t rowsPending = 0;
+        for (auto yFrom = tfY->from; yFrom < yFromEnd; )
         {
             for (size_t j = 0; j < yFrom->count; ++j)
             {
                 const size_t v = yFrom->to[j].u;
                 assert(v < destImage.height);
-                ++rowActive[v].remaining;
+                if (v >= yStart && v < yEnd)
+                {
+                    if (!rowActive[v - yStart].remaining)
+                        ++rowsPending;
+                    ++rowActive[v - yStart].remaining;
+                }
             }
 
-            yFrom = reinterpret_cast<FilterFrom*>(reinterpret_cast<uint8_t*>(yFrom) + yFrom->sizeInBytes);
+            yFrom = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(yFrom) + yFrom->sizeInBytes);
         }
 
         // Filter image
@@ -681,14 +863,35 @@ namespace
 
         uint8_t* pDest = destImage.pixels;
 
-        for (FilterFrom* yFrom = tfY->from; yFrom < yFromEnd; )
+        for (auto yFrom = tfY->from; yFrom < yFromEnd && rowsPending > 0; )
         {
+            bool contributes = false;
+            for (size_t j = 0; j < yFrom->count; ++j)
+            {
+                const size_t v = yFrom->to[j].u;
+                if (v >= yStart && v < yEnd)
+                {
+                    contributes = true;
+                    break;
+                }
+            }
+
+            if (!contributes)
+            {
+                pSrc += rowPitch;
+                yFrom = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(yFrom) + yFrom->sizeInBytes);
+                continue;
+            }
+
             // Create accumulation rows as needed
             for (size_t j = 0; j < yFrom->count; ++j)
             {
                 const size_t v = yFrom->to[j].u;
                 assert(v < destImage.height);
-                TriangleRow* rowAcc = &rowActive[v];
+                if (v < yStart || v >= yEnd)
+                    continue;
+
+                TriangleRow* rowAcc = &rowActive[v - yStart];
 
                 if (!rowAcc->scanline)
                 {
@@ -720,33 +923,26 @@ namespace
 
             pSrc += rowPitch;
 
-            // Process row
-            size_t x = 0;
-            for (FilterFrom* xFrom = tfX->from; xFrom < xFromEnd; ++x)
-            {
-                for (size_t j = 0; j < yFrom->count; ++j)
-                {
-                    const size_t v = yFrom->to[j].u;
-                    assert(v < destImage.height);
-                    const float yweight = yFrom->to[j].weight;
+            // Horizontal pass, then accumulate the filtered row into each destination row it contributes to
+            TriangleFilterRow(hrow, destImage.width, row, tfX);
 
-                    XMVECTOR* accPtr = rowActive[v].scanline.get();
-                    if (!accPtr)
-                        return E_POINTER;
+            for (size_t j = 0; j < yFrom->count; ++j)
+            {
+                const size_t v = yFrom->to[j].u;
+                assert(v < destImage.height);
+                if (v < yStart || v >= yEnd)
+                    continue;
 
-                    for (size_t k = 0; k < xFrom->count; ++k)
-                    {
-                        size_t u = xFrom->to[k].u;
-                        assert(u < destImage.width);
+                const XMVECTOR yweight = XMVectorReplicate(yFrom->to[j].weight);
 
-                        const XMVECTOR weight = XMVectorReplicate(yweight * xFrom->to[k].weight);
+                XMVECTOR* accPtr = rowActive[v - yStart].scanline.get();
+                if (!accPtr)
+                    return E_POINTER;
 
-                        assert(x < srcImage.width);
-                        accPtr[u] = XMVectorMultiplyAdd(row[x], weight, accPtr[u]);
-                    }
+                for (size_t x = 0; x < destImage.width; ++x)
+                {
+                    accPtr[x] = XMVectorMultiplyAdd(hrow[x], yweight, accPtr[x]);
                 }
-
-                xFrom = reinterpret_cast<FilterFrom*>(reinterpret_cast<uint8_t*>(xFrom) + xFrom->sizeInBytes);
             }
 
             // Write completed accumulation rows
@@ -754,7 +950,10 @@ namespace
             {
                 size_t v = yFrom->to[j].u;
                 assert(v < destImage.height);
-                TriangleRow* rowAcc = &rowActive[v];
+                if (v < yStart || v >= yEnd)
+                    continue;
+
+                TriangleRow* rowAcc = &rowActive[v - yStart];
 
                 assert(rowAcc->remaining > 0);
                 --rowAcc->remaining;
@@ -793,10 +992,448 @@ namespace
                     // Put row on freelist to reuse it's allocated scanline
                     rowAcc->next = rowFree;
                     rowFree = rowAcc;
+                    --rowsPending;
                 }
             }
 
-            yFrom = reinterpret_cast<FilterFrom*>(reinterpret_cast<uint8_t*>(yFrom) + yFrom->sizeInBytes);
+            yFrom = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(yFrom) + yFrom->sizeInBytes);
+        }
+
+        return S_OK;
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    // Fixed-point resize for 8-bit and 16-bit UNORM RGBA formats
+    //-------------------------------------------------------------------------------------
+
+    // Pixels are expanded to four 16-bit channels (0..65535) and filtered with 1.14 weights,
+    // which avoids the float4 expansion of LoadScanlineLinear. sRGB data is linearized through
+    // lookup tables, so results match the floating-point filters to within rounding.
+    enum FIXED_PIXEL_TYPE
+    {
+        FIXED_NONE = 0,
+        FIXED_UNORM8,
+        FIXED_SRGB8,
+        FIXED_UNORM16,
+    };
+
+    FIXED_PIXEL_TYPE GetFixedPixelType(DXGI_FORMAT format, TEX_FILTER_FLAGS filter) noexcept
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+        case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+            return FIXED_SRGB8;
+
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+            switch (filter & TEX_FILTER_SRGB)
+            {
+            case 0:                 return FIXED_UNORM8;
+            case TEX_FILTER_SRGB:   return FIXED_SRGB8;
+            default:                return FIXED_NONE;
+            }
+
+        case DXGI_FORMAT_R16G16B16A16_UNORM:
+            return (filter & TEX_FILTER_SRGB) ? FIXED_NONE : FIXED_UNORM16;
+
+        default:
+            return FIXED_NONE;
+        }
+    }
+
+    constexpr uint32_t c_FixedOne = 1u << 14;
+
+    // Two-tap filter weights in 1.14 fixed point, packed as a pair of int16 (w0 in the low half)
+    struct FixedTap
+    {
+        size_t      u0;
+        size_t      u1;
+        uint32_t    weights;
+    };
+
+    inline uint32_t PackFixedWeights(float weight0) noexcept
+    {
+        const auto w0 = static_cast<uint32_t>(std::min(std::max(weight0, 0.f), 1.f) * float(c_FixedOne) + 0.5f);
+        return w0 | ((c_FixedOne - w0) << 16);
+    }
+
+    struct SRGBTables
+    {
+        uint16_t    toLinear[256];
+        uint8_t     fromLinear[65536];
+
+        SRGBTables() noexcept
+        {
+            for (size_t i = 0; i < 256; ++i)
+            {
+                const float s = float(i) / 255.f;
+                const float l = (s <= 0.04045f) ? (s / 12.92f) : powf((s + 0.055f) / 1.055f, 2.4f);
+                toLinear[i] = static_cast<uint16_t>(l * 65535.f + 0.5f);
+            }
+
+            for (size_t i = 0; i < 65536; ++i)
+            {
+                const float l = float(i) / 65535.f;
+                const float s = (l <= 0.0031308f) ? (l * 12.92f) : (1.055f * powf(l, 1.f / 2.4f) - 0.055f);
+                fromLinear[i] = static_cast<uint8_t>(std::min(s, 1.f) * 255.f + 0.5f);
+            }
+        }
+    };
+
+    const SRGBTables& GetSRGBTables() noexcept
+    {
+        static const SRGBTables s_tables;
+        return s_tables;
+    }
+
+    void LoadFixedScanline(
+        _Out_writes_(width * 4) uint16_t* pDestination,
+        _In_reads_bytes_(width * 4) const uint8_t* pSource,
+        size_t width,
+        FIXED_PIXEL_TYPE type) noexcept
+    {
+        switch (type)
+        {
+        case FIXED_UNORM8:
+            {
+                size_t i = 0;
+            #if defined(_XM_SSE_INTRINSICS_) && !defined(_XM_NO_INTRINSICS_)
+                // Duplicating each byte into both halves of a 16-bit lane multiplies by 257
+                for (; (i + 16) <= width * 4; i += 16)
+                {
+                    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSource + i));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(pDestination + i), _mm_unpacklo_epi8(v, v));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(pDestination + i + 8), _mm_unpackhi_epi8(v, v));
+                }
+            #endif
+                for (; i < width * 4; ++i)
+                {
+                    pDestination[i] = static_cast<uint16_t>(pSource[i] * 257u);
+                }
+            }
+            break;
+
+        case FIXED_SRGB8:
+            {
+                // Alpha is the fourth byte for both RGBA and BGRA layouts
+                const uint16_t* toLinear = GetSRGBTables().toLinear;
+                for (size_t i = 0; i < width * 4; i += 4)
+                {
+                    pDestination[i] = toLinear[pSource[i]];
+                    pDestination[i + 1] = toLinear[pSource[i + 1]];
+                    pDestination[i + 2] = toLinear[pSource[i + 2]];
+                    pDestination[i + 3] = static_cast<uint16_t>(pSource[i + 3] * 257u);
+                }
+            }
+            break;
+
+        default:
+            memcpy(pDestination, pSource, width * sizeof(uint16_t) * 4);
+            break;
+        }
+    }
+
+    inline uint8_t UNorm16ToUNorm8(uint32_t v) noexcept
+    {
+        return static_cast<uint8_t>((v + 128u - ((v + 128u) >> 8)) >> 8);
+    }
+
+    void StoreFixedScanline(
+        _Out_writes_bytes_(width * 4) uint8_t* pDestination,
+        _In_reads_(width * 4) const uint16_t* pSource,
+        size_t width,
+        FIXED_PIXEL_TYPE type) noexcept
+    {
+        switch (type)
+        {
+        case FIXED_UNORM8:
+            {
+                // Rounded v / 257, computed as (v + 128 - ((v + 128) >> 8)) >> 8
+                size_t i = 0;
+            #if defined(_XM_SSE_INTRINSICS_) && !defined(_XM_NO_INTRINSICS_)
+                // (v + 128) >> 8 is formed as ((v >> 1) + 64) >> 7 so no lane overflows
+                const __m128i half = _mm_set1_epi16(64);
+                const __m128i round = _mm_set1_epi16(128);
+                for (; (i + 16) <= width * 4; i += 16)
+                {
+                    const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSource + i));
+                    const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSource + i + 8));
+                    const __m128i q0 = _mm_srli_epi16(_mm_add_epi16(_mm_srli_epi16(v0, 1), half), 7);
+                    const __m128i q1 = _mm_srli_epi16(_mm_add_epi16(_mm_srli_epi16(v1, 1), half), 7);
+                    const __m128i r0 = _mm_srli_epi16(_mm_add_epi16(_mm_sub_epi16(v0, q0), round), 8);
+                    const __m128i r1 = _mm_srli_epi16(_mm_add_epi16(_mm_sub_epi16(v1, q1), round), 8);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(pDestination + i), _mm_packus_epi16(r0, r1));
+                }
+            #endif
+                for (; i < width * 4; ++i)
+                {
+                    pDestination[i] = UNorm16ToUNorm8(pSource[i]);
+                }
+            }
+            break;
+
+        case FIXED_SRGB8:
+            {
+                const uint8_t* fromLinear = GetSRGBTables().fromLinear;
+                for (size_t i = 0; i < width * 4; i += 4)
+                {
+                    pDestination[i] = fromLinear[pSource[i]];
+                    pDestination[i + 1] = fromLinear[pSource[i + 1]];
+                    pDestination[i + 2] = fromLinear[pSource[i + 2]];
+                    pDestination[i + 3] = UNorm16ToUNorm8(pSource[i + 3]);
+                }
+            }
+            break;
+
+        default:
+            memcpy(pDestination, pSource, width * sizeof(uint16_t) * 4);
+            break;
+        }
+    }
+
+    // dest[i] = (a[i] * w0 + b[i] * w1 + 8192) >> 14
+    void BlendFixedScanlines(
+        _Out_writes_(count) uint16_t* pDestination,
+        _In_reads_(count) const uint16_t* pA,
+        _In_reads_(count) const uint16_t* pB,
+        uint32_t weights,
+        size_t count) noexcept
+    {
+        size_t i = 0;
+    #if defined(_XM_SSE_INTRINSICS_) && !defined(_XM_NO_INTRINSICS_)
+        // _mm_madd_epi16 is signed, so values are biased by -32768 and the bias is restored after
+        const __m128i bias16 = _mm_set1_epi16(static_cast<short>(0x8000));
+        const __m128i bias32 = _mm_set1_epi32(32768);
+        const __m128i round = _mm_set1_epi32((32768 << 14) + 8192);
+        const __m128i w = _mm_set1_epi32(static_cast<int>(weights));
+        for (; (i + 8) <= count; i += 8)
+        {
+            const __m128i a = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pA + i)), bias16);
+            const __m128i b = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pB + i)), bias16);
+            __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi16(a, b), w);
+            __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi16(a, b), w);
+            lo = _mm_sub_epi32(_mm_srai_epi32(_mm_add_epi32(lo, round), 14), bias32);
+            hi = _mm_sub_epi32(_mm_srai_epi32(_mm_add_epi32(hi, round), 14), bias32);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pDestination + i), _mm_xor_si128(_mm_packs_epi32(lo, hi), bias16));
+        }
+    #endif
+        const uint32_t w0 = weights & 0xFFFF;
+        const uint32_t w1 = weights >> 16;
+        for (; i < count; ++i)
+        {
+            pDestination[i] = static_cast<uint16_t>((pA[i] * w0 + pB[i] * w1 + 8192u) >> 14);
+        }
+    }
+
+    // Horizontal two-tap resample of one scanline of 4-channel pixels
+    void ResampleFixedScanline(
+        _Out_writes_(width * 4) uint16_t* pDestination,
+        _In_ const uint16_t* pSource,
+        _In_reads_(width) const FixedTap* taps,
+        size_t width) noexcept
+    {
+    #if defined(_XM_SSE_INTRINSICS_) && !defined(_XM_NO_INTRINSICS_)
+        const __m128i bias16 = _mm_set1_epi16(static_cast<short>(0x8000));
+        const __m128i bias32 = _mm_set1_epi32(32768);
+        const __m128i round = _mm_set1_epi32((32768 << 14) + 8192);
+        for (size_t x = 0; x < width; ++x)
+        {
+            const auto& tap = taps[x];
+            const __m128i p0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pSource + tap.u0 * 4));
+            const __m128i p1 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pSource + tap.u1 * 4));
+            const __m128i v = _mm_xor_si128(_mm_unpacklo_epi16(p0, p1), bias16);
+            __m128i r = _mm_madd_epi16(v, _mm_set1_epi32(static_cast<int>(tap.weights)));
+            r = _mm_sub_epi32(_mm_srai_epi32(_mm_add_epi32(r, round), 14), bias32);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(pDestination + x * 4), _mm_xor_si128(_mm_packs_epi32(r, r), bias16));
+        }
+    #else
+        for (size_t x = 0; x < width; ++x)
+        {
+            const auto& tap = taps[x];
+            const uint32_t w0 = tap.weights & 0xFFFF;
+            const uint32_t w1 = tap.weights >> 16;
+            const uint16_t* p0 = pSource + tap.u0 * 4;
+            const uint16_t* p1 = pSource + tap.u1 * 4;
+            for (size_t c = 0; c < 4; ++c)
+            {
+                pDestination[x * 4 + c] = static_cast<uint16_t>((p0[c] * w0 + p1[c] * w1 + 8192u) >> 14);
+            }
+        }
+    #endif
+    }
+
+    //--- Fixed-point two-tap resize (linear, and box for exact 2x reduction) ---
+    HRESULT ResizeFixedTwoTap(
+        const Image& srcImage,
+        const Image& destImage,
+        FIXED_PIXEL_TYPE type,
+        const FixedTap* tapsX,
+        const FixedTap* tapsY,
+        size_t yStart,
+        size_t yEnd) noexcept
+    {
+        assert(srcImage.pixels && destImage.pixels);
+        assert(srcImage.format == destImage.format);
+
+        // Allocate temporary space (1 source scanline, 3 destination scanlines) as 16-bit channels
+        const uint64_t channels = uint64_t(srcImage.width) * 4 + uint64_t(destImage.width) * 12;
+        auto scanline = make_ScratchArrayXMVECTOR((channels + 7) / 8);
+        if (!scanline)
+            return E_OUTOFMEMORY;
+
+        const size_t rowChannels = destImage.width * 4;
+
+        auto target = reinterpret_cast<uint16_t*>(scanline.get());
+        uint16_t* row0 = target + rowChannels;
+        uint16_t* row1 = row0 + rowChannels;
+        uint16_t* srow = row1 + rowChannels;
+
+        const size_t rowPitch = srcImage.rowPitch;
+
+        uint8_t* pDest = destImage.pixels + (destImage.rowPitch * yStart);
+
+        size_t u0 = size_t(-1);
+        size_t u1 = size_t(-1);
+
+        for (size_t y = yStart; y < yEnd; ++y)
+        {
+            const auto& toY = tapsY[y];
+
+            if (toY.u0 != u0)
+            {
+                if (toY.u0 != u1)
+                {
+                    u0 = toY.u0;
+
+                    LoadFixedScanline(srow, srcImage.pixels + (rowPitch * u0), srcImage.width, type);
+                    ResampleFixedScanline(row0, srow, tapsX, destImage.width);
+                }
+                else
+                {
+                    u0 = u1;
+                    u1 = size_t(-1);
+
+                    std::swap(row0, row1);
+                }
+            }
+
+            if (toY.u1 != u1)
+            {
+                u1 = toY.u1;
+
+                LoadFixedScanline(srow, srcImage.pixels + (rowPitch * u1), srcImage.width, type);
+                ResampleFixedScanline(row1, srow, tapsX, destImage.width);
+            }
+
+            BlendFixedScanlines(target, row0, row1, toY.weights, rowChannels);
+
+            StoreFixedScanline(pDest, target, destImage.width, type);
+            pDest += destImage.rowPitch;
+        }
+
+        return S_OK;
+    }
+
+    HRESULT ResizeFixedFilter(
+        uint32_t filter_select,
+        const Image& srcImage,
+        TEX_FILTER_FLAGS filter,
+        const Image& destImage,
+        FIXED_PIXEL_TYPE type,
+        size_t yStart,
+        size_t yEnd) noexcept
+    {
+        using namespace DirectX::Filters;
+
+        std::unique_ptr<FixedTap[]> taps(new (std::nothrow) FixedTap[destImage.width + destImage.height]);
+        if (!taps)
+            return E_OUTOFMEMORY;
+
+        FixedTap* tapsX = taps.get();
+        FixedTap* tapsY = taps.get() + destImage.width;
+
+        if (filter_select == TEX_FILTER_BOX)
+        {
+            assert(((destImage.width << 1) == srcImage.width) && ((destImage.height << 1) == srcImage.height));
+
+            const uint32_t half = PackFixedWeights(0.5f);
+            for (size_t x = 0; x < destImage.width; ++x)
+            {
+                tapsX[x] = { x << 1, (x << 1) + 1, half };
+            }
+            for (size_t y = 0; y < destImage.height; ++y)
+            {
+                tapsY[y] = { y << 1, (y << 1) + 1, half };
+            }
+        }
+        else
+        {
+            assert(filter_select == TEX_FILTER_LINEAR);
+
+            const FilterTable tableX(FILTER_TABLE_LINEAR, srcImage.width, destImage.width, (filter & TEX_FILTER_WRAP_U) != 0);
+            const FilterTable tableY(FILTER_TABLE_LINEAR, srcImage.height, destImage.height, (filter & TEX_FILTER_WRAP_V) != 0);
+            if (!tableX || !tableY)
+                return E_OUTOFMEMORY;
+
+            const LinearFilter* lfX = tableX.Linear();
+            const LinearFilter* lfY = tableY.Linear();
+
+            for (size_t x = 0; x < destImage.width; ++x)
+            {
+                tapsX[x] = { lfX[x].u0, lfX[x].u1, PackFixedWeights(lfX[x].weight0) };
+            }
+            for (size_t y = 0; y < destImage.height; ++y)
+            {
+                tapsY[y] = { lfY[y].u0, lfY[y].u1, PackFixedWeights(lfY[y].weight0) };
+            }
+        }
+
+        return ResizeFixedTwoTap(srcImage, destImage, type, tapsX, tapsY, yStart, yEnd);
+    }
+
+    //--- Point filter by copying texels (no format conversion needed) ---
+    HRESULT ResizePointCopy(const Image& srcImage, const Image& destImage, size_t yStart, size_t yEnd) noexcept
+    {
+        assert(srcImage.pixels && destImage.pixels);
+        assert(srcImage.format == destImage.format);
+
+        const size_t bpp = BitsPerPixel(srcImage.format) / 8;
+        assert(bpp == 4 || bpp == 8);
+
+        const size_t xinc = (srcImage.width << 16) / destImage.width;
+        const size_t yinc = (srcImage.height << 16) / destImage.height;
+
+        uint8_t* pDest = destImage.pixels + (destImage.rowPitch * yStart);
+
+        size_t sy = yinc * yStart;
+        for (size_t y = yStart; y < yEnd; ++y)
+        {
+            const uint8_t* pSrc = srcImage.pixels + (srcImage.rowPitch * (sy >> 16));
+
+            size_t sx = 0;
+            if (bpp == 4)
+            {
+                auto dptr = reinterpret_cast<uint32_t*>(pDest);
+                for (size_t x = 0; x < destImage.width; ++x)
+                {
+                    memcpy(dptr + x, pSrc + 4 * (sx >> 16), 4);
+                    sx += xinc;
+                }
+            }
+            else
+            {
+                auto dptr = reinterpret_cast<uint64_t*>(pDest);
+                for (size_t x = 0; x < destImage.width; ++x)
+                {
+                    memcpy(dptr + x, pSrc + 8 * (sx >> 16), 8);
+                    sx += xinc;
+                }
+            }
+
+            pDest += destImage.rowPitch;
+            sy += yinc;
         }
 
         return S_OK;
@@ -804,6 +1441,117 @@ namespace
 
 
     //--- Custom filter resize ---
+    HRESULT ResizeRows(
+        uint32_t filter_select,
+        const Image& srcImage,
+        TEX_FILTER_FLAGS filter,
+        const Image& destImage,
+        size_t yStart,
+        size_t yEnd) noexcept
+    {
+        // 8-bit and 16-bit RGBA formats are filtered in fixed point where a kernel exists
+        const FIXED_PIXEL_TYPE fixedType = GetFixedPixelType(srcImage.format, filter);
+        if (fixedType != FIXED_NONE)
+        {
+            switch (filter_select)
+            {
+            case TEX_FILTER_POINT:
+                return ResizePointCopy(srcImage, destImage, yStart, yEnd);
+
+            case TEX_FILTER_BOX:
+                if (((destImage.width << 1) == srcImage.width) && ((destImage.height << 1) == srcImage.height))
+                    return ResizeFixedFilter(filter_select, srcImage, filter, destImage, fixedType, yStart, yEnd);
+                break;
+
+            case TEX_FILTER_LINEAR:
+                return ResizeFixedFilter(filter_select, srcImage, filter, destImage, fixedType, yStart, yEnd);
+
+            default:
+                break;
+            }
+        }
+
+        switch (filter_select)
+        {
+        case TEX_FILTER_POINT:
+            return ResizePointFilter(srcImage, destImage, yStart, yEnd);
+
+        case TEX_FILTER_BOX:
+            if (((destImage.width << 1) == srcImage.width) && ((destImage.height << 1) == srcImage.height))
+                return ResizeBoxFilter(srcImage, filter, destImage, yStart, yEnd);
+
+            if (!(srcImage.width % destImage.width) && !(srcImage.height % destImage.height))
+                return ResizeBoxReduceFilter(srcImage, filter, destImage, yStart, yEnd);
+
+            return ResizeFantFilter(srcImage, filter, destImage, yStart, yEnd);
+
+        case TEX_FILTER_LINEAR:
+            return ResizeLinearFilter(srcImage, filter, destImage, yStart, yEnd);
+
+        case TEX_FILTER_CUBIC:
+            return ResizeCubicFilter(srcImage, filter, destImage, yStart, yEnd);
+
+        case TEX_FILTER_TRIANGLE:
+            return ResizeTriangleFilter(srcImage, filter, destImage, yStart, yEnd);
+
+        default:
+            return HRESULT_E_NOT_SUPPORTED;
+        }
+    }
+
+#ifdef _OPENMP
+    // Smaller images are not worth the cost of starting a parallel region
+    constexpr uint64_t c_MinParallelResizePixels = 64 * 1024;
+
+    HRESULT ResizeRowBands(
+        uint32_t filter_select,
+        const Image& srcImage,
+        TEX_FILTER_FLAGS filter,
+        const Image& destImage) noexcept
+    {
+        const uint64_t pixels = uint64_t(destImage.width) * uint64_t(destImage.height);
+        const size_t maxBands = std::min<size_t>(destImage.height, static_cast<size_t>(std::max(omp_get_max_threads(), 1)));
+        if (pixels < c_MinParallelResizePixels || maxBands < 2)
+            return ResizeRows(filter_select, srcImage, filter, destImage, 0, destImage.height);
+
+        // Each band loads just the window of source rows its destination rows need
+        const size_t bandHeight = (destImage.height + maxBands - 1) / maxBands;
+        const auto bands = static_cast<int>((destImage.height + bandHeight - 1) / bandHeight);
+
+        HRESULT result = S_OK;
+        bool fail = false;
+
+    #pragma omp parallel for shared(result, fail)
+        for (int band = 0; band < bands; ++band)
+        {
+        #pragma omp flush (fail)
+            if (fail)
+            {
+                // Short circuit the loop body if a failure has occurred.
+                // OpenMP 2.0 does not support cancellation of a 'parallel for' loop.
+                continue;
+            }
+
+            const size_t yStart = size_t(band) * bandHeight;
+            const size_t yEnd = std::min(yStart + bandHeight, destImage.height);
+
+            const HRESULT hr = ResizeRows(filter_select, srcImage, filter, destImage, yStart, yEnd);
+            if (FAILED(hr))
+            {
+            #pragma omp critical
+                {
+                    if (SUCCEEDED(result))
+                        result = hr;
+                }
+                fail = true;
+            #pragma omp flush (fail)
+            }
+        }
+
+        return result;
+    }
+#endif // _OPENMP
+
     HRESULT PerformResizeUsingCustomFilters(const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage) noexcept
     {
         if (!srcImage.pixels || !destImage.pixels)
@@ -819,27 +1567,86 @@ namespace
                 ? TEX_FILTER_BOX : TEX_FILTER_LINEAR;
         }
 
-        switch (filter_select)
+    #ifdef _OPENMP
+        if (filter & TEX_FILTER_PARALLEL)
         {
-        case TEX_FILTER_POINT:
-            return ResizePointFilter(srcImage, destImage);
+            return ResizeRowBands(filter_select, srcImage, filter, destImage);
+        }
+    #endif
 
-        case TEX_FILTER_BOX:
-            return ResizeBoxFilter(srcImage, filter, destImage);
+        return ResizeRows(filter_select, srcImage, filter, destImage, 0, destImage.height);
+    }
 
-        case TEX_FILTER_LINEAR:
-            return ResizeLinearFilter(srcImage, filter, destImage);
+#ifdef _OPENMP
+    //--- Resize all items of a complex image at once, one item per thread ---
+    HRESULT ResizeItemsParallel(
+        const Image* srcImages,
+        size_t nimages,
+        const TexMetadata& metadata,
+        TEX_FILTER_FLAGS filter,
+        const ScratchImage& result) noexcept
+    {
+        const bool is3D = (metadata.dimension == TEX_DIMENSION_TEXTURE3D);
+        const size_t items = is3D ? metadata.depth : metadata.arraySize;
+        if (items > INT32_MAX)
+            return HRESULT_E_ARITHMETIC_OVERFLOW;
 
-        case TEX_FILTER_CUBIC:
-            return ResizeCubicFilter(srcImage, filter, destImage);
+        // Threads are already busy with whole items, so each item is resized serially
+        const auto itemFilter = static_cast<TEX_FILTER_FLAGS>(filter & ~TEX_FILTER_PARALLEL);
 
-        case TEX_FILTER_TRIANGLE:
-            return ResizeTriangleFilter(srcImage, filter, destImage);
+        HRESULT hresult = S_OK;
+        bool fail = false;
 
-        default:
-            return HRESULT_E_NOT_SUPPORTED;
+    #pragma omp parallel for schedule(dynamic) shared(hresult, fail)
+        for (int item = 0; item < static_cast<int>(items); ++item)
+        {
+        #pragma omp flush (fail)
+            if (fail)
+            {
+                continue;
+            }
+
+            HRESULT hr = S_OK;
+
+            const size_t srcIndex = is3D ? metadata.ComputeIndex(0, 0, size_t(item)) : metadata.ComputeIndex(0, size_t(item), 0);
+            const Image* destimg = is3D ? result.GetImage(0, 0, size_t(item)) : result.GetImage(0, size_t(item), 0);
+            if (srcIndex >= nimages)
+            {
+                hr = E_FAIL;
+            }
+            else if (!destimg)
+            {
+                hr = E_POINTER;
+            }
+            else
+            {
+                const Image& srcimg = srcImages[srcIndex];
+                if (srcimg.format != metadata.format
+                    || (srcimg.width > UINT32_MAX) || (srcimg.height > UINT32_MAX))
+                {
+                    hr = E_FAIL;
+                }
+                else
+                {
+                    hr = PerformResizeUsingCustomFilters(srcimg, itemFilter, *destimg);
+                }
+            }
+
+            if (FAILED(hr))
+            {
+            #pragma omp critical
+                {
+                    if (SUCCEEDED(hresult))
+                        hresult = hr;
+                }
+                fail = true;
+            #pragma omp flush (fail)
+            }
         }
+
+        return hresult;
     }
+#endif // _OPENMP
 }
 
 
@@ -884,9 +1691,11 @@ HRESULT DirectX::Resize(
 
     if (usewic && !wicpf)
     {
-        // Check to see if the source and/or result size is too big for WIC
-        const uint64_t expandedSize = uint64_t(width) * uint64_t(height) * sizeof(float) * 4;
-        const uint64_t expandedSize2 = uint64_t(srcImage.width) * uint64_t(srcImage.height) * sizeof(float) * 4;
+        // Check to see if the source and/or result size is too big for WIC. Rows are streamed through
+        // float as WIC reads them, so only separate color/alpha resizing needs whole float images.
+        const bool wholeImage = (filter & TEX_FILTER_SEPARATE_ALPHA) != 0;
+        const uint64_t expandedSize = uint64_t(width) * (wholeImage ? uint64_t(height) : 1u) * sizeof(float) * 4;
+        const uint64_t expandedSize2 = uint64_t(srcImage.width) * (wholeImage ? uint64_t(srcImage.height) : 1u) * sizeof(float) * 4;
         if (expandedSize > UINT32_MAX || expandedSize2 > UINT32_MAX)
         {
             if (filter & TEX_FILTER_FORCE_WIC)
@@ -973,9 +1782,11 @@ HRESULT DirectX::Resize(
 
     if (usewic && !wicpf)
     {
-        // Check to see if the source and/or result size is too big for WIC
-        const uint64_t expandedSize = uint64_t(width) * uint64_t(height) * sizeof(float) * 4;
-        const uint64_t expandedSize2 = uint64_t(metadata.width) * uint64_t(metadata.height) * sizeof(float) * 4;
+        // Check to see if the source and/or result size is too big for WIC. Rows are streamed through
+        // float as WIC reads them, so only separate color/alpha resizing needs whole float images.
+        const bool wholeImage = (filter & TEX_FILTER_SEPARATE_ALPHA) != 0;
+        const uint64_t expandedSize = uint64_t(width) * (wholeImage ? uint64_t(height) : 1u) * sizeof(float) * 4;
+        const uint64_t expandedSize2 = uint64_t(metadata.width) * (wholeImage ? uint64_t(metadata.height) : 1u) * sizeof(float) * 4;
         if (expandedSize > UINT32_MAX || expandedSize2 > UINT32_MAX)
         {
             if (filter & TEX_FILTER_FORCE_WIC)
@@ -986,6 +1797,34 @@ HRESULT DirectX::Resize(
     }
 #endif
 
+#ifdef _OPENMP
+    if (filter & TEX_FILTER_PARALLEL)
+    {
+        // Spread whole items across threads when there are enough of them, otherwise
+        // each item below is split into row bands
+        const size_t items = (metadata.dimension == TEX_DIMENSION_TEXTURE3D) ? metadata.depth : metadata.arraySize;
+        bool parallelItems = (items > 1) && (items >= static_cast<size_t>(omp_get_max_threads()));
+    #ifdef _WIN32
+        parallelItems = parallelItems && !usewic;
+    #endif
+
+        if (parallelItems
+            && (metadata.dimension == TEX_DIMENSION_TEXTURE1D
+                || metadata.dimension == TEX_DIMENSION_TEXTURE2D
+                || metadata.dimension == TEX_DIMENSION_TEXTURE3D))
+        {
+            hr = ResizeItemsParallel(srcImages, nimages, metadata, filter, result);
+            if (FAILED(hr))
+            {
+                result.Release();
+                return hr;
+            }
+
+            return S_OK;
+        }
+    }
+#endif
+
     switch (metadata.dimension)
     {
     case TEX_DIMENSION_TEXTURE1D:
@@ -11,6 +11,13 @@
 
 #include "DirectXTexP.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#pragma warning(disable : 4616 6993)
+#endif
+
+#include "filters.h"
+
 #if (defined(_XBOX_ONE) && defined(_TITLE)) || defined(_GAMING_XBOX)
 static_assert(XBOX_DXGI_FORMAT_R10G10B10_7E3_A2_FLOAT == DXGI_FORMAT_R10G10B10_7E3_A2_FLOAT, "Xbox mismatch detected");
 static_assert(XBOX_DXGI_FORMAT_R10G10B10_6E4_A2_FLOAT == DXGI_FORMAT_R10G10B10_6E4_A2_FLOAT, "Xbox mismatch detected");
@@ -1894,3 +1901,557 @@ HRESULT Blob::Resize(size_t size) noexcept
 
     return S_OK;
 }
+
+
+//=====================================================================================
+// Per-thread scratch memory
+//=====================================================================================
+
+namespace
+{
+    // Peak usage above this is served from the heap on each call instead of being retained
+    constexpr size_t c_MaxRetainedScratch = 16 * 1024 * 1024;
+
+    // OpenMP pool threads only ever run inside parallel regions and the application has no way
+    // to release what they hold, so much less is kept for work done there
+    constexpr size_t c_MaxRetainedScratchParallel = 1024 * 1024;
+
+    inline size_t GetMaxRetainedScratch() noexcept
+    {
+    #ifdef _OPENMP
+        if (omp_in_parallel())
+            return c_MaxRetainedScratchParallel;
+    #endif
+        return c_MaxRetainedScratch;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Stack allocator for temporary scanlines. Requests that do not fit in the current
+    // block come from the heap; once the outermost request is released the block is
+    // grown to the peak usage seen, so steady-state processing does not allocate.
+    //-------------------------------------------------------------------------------------
+    class ScratchArena
+    {
+    public:
+        ScratchArena() noexcept :
+            m_memory(nullptr),
+            m_size(0),
+            m_offset(0),
+            m_depth(0),
+            m_demand(0),
+            m_peak(0),
+            m_owned(false)
+        {}
+
+        ~ScratchArena() { FreeOwned(); }
+
+        ScratchArena(const ScratchArena&) = delete;
+        ScratchArena& operator=(const ScratchArena&) = delete;
+
+        uint8_t* Acquire(size_t bytes, size_t& offset, bool& heap) noexcept
+        {
+            assert((bytes & 0xF) == 0);
+
+            ++m_depth;
+            m_demand += bytes;
+            m_peak = std::max(m_peak, m_demand);
+
+            offset = m_offset;
+            if (m_memory && bytes <= (m_size - m_offset))
+            {
+                heap = false;
+                m_offset += bytes;
+                return m_memory + offset;
+            }
+
+            heap = true;
+            return static_cast<uint8_t*>(_aligned_malloc(bytes, 16));
+        }
+
+        void Return(uint8_t* ptr, size_t bytes, size_t offset, bool heap) noexcept
+        {
+            assert(m_depth > 0);
+
+            if (heap)
+            {
+                _aligned_free(ptr);
+            }
+            else
+            {
+                // Out-of-order release would hand out memory that is still in use
+                assert(m_offset == offset + bytes);
+                m_offset = offset;
+            }
+
+            m_demand -= bytes;
+
+            if (--m_depth == 0)
+            {
+                assert(m_offset == 0 && m_demand == 0);
+
+                // Memory supplied by the application is never replaced
+                const bool growable = m_owned || !m_memory;
+                if (growable && m_peak > m_size && m_peak <= GetMaxRetainedScratch())
+                {
+                    auto memory = static_cast<uint8_t*>(_aligned_malloc(m_peak, 16));
+                    if (memory)
+                    {
+                        FreeOwned();
+                        m_memory = memory;
+                        m_size = m_peak;
+                        m_owned = true;
+                    }
+                }
+
+                m_peak = 0;
+            }
+        }
+
+        HRESULT SetMemory(void* memory, size_t size) noexcept
+        {
+            if (m_depth > 0)
+                return E_UNEXPECTED;
+
+            if (reinterpret_cast<uintptr_t>(memory) & 0xF)
+                return E_INVALIDARG;
+
+            FreeOwned();
+
+            if (memory)
+            {
+                m_memory = static_cast<uint8_t*>(memory);
+                m_size = size & ~size_t(0xF);
+            }
+
+            return S_OK;
+        }
+
+        void Release() noexcept
+        {
+            if (m_depth == 0)
+            {
+                FreeOwned();
+            }
+        }
+
+    private:
+        void FreeOwned() noexcept
+        {
+            if (m_owned)
+            {
+                _aligned_free(m_memory);
+            }
+
+            m_memory = nullptr;
+            m_size = 0;
+            m_owned = false;
+        }
+
+        uint8_t*    m_memory;
+        size_t      m_size;
+        size_t      m_offset;
+        size_t      m_depth;
+        size_t      m_demand;
+        size_t      m_peak;
+        bool        m_owned;
+    };
+
+    thread_local ScratchArena t_ScratchArena;
+}
+
+_Use_decl_annotations_
+HRESULT DirectX::SetThreadScratchMemory(void* pMemory, size_t size) noexcept
+{
+    if (pMemory && !size)
+        return E_INVALIDARG;
+
+    return t_ScratchArena.SetMemory(pMemory, size);
+}
+
+void DirectX::ReleaseThreadScratchMemory() noexcept
+{
+    t_ScratchArena.Release();
+    Filters::ReleaseFilterCache();
+}
+
+DirectX::Internal::ScratchArrayXMVECTOR::ScratchArrayXMVECTOR(uint64_t count) noexcept :
+    m_data(nullptr),
+    m_bytes(0),
+    m_offset(0),
+    m_heap(false)
+{
+    const uint64_t size = sizeof(XMVECTOR) * count;
+    if (!size || size > static_cast<uint64_t>(UINT32_MAX))
+        return;
+
+    m_bytes = static_cast<size_t>(size);
+    m_data = reinterpret_cast<XMVECTOR*>(t_ScratchArena.Acquire(m_bytes, m_offset, m_heap));
+}
+
+DirectX::Internal::ScratchArrayXMVECTOR::~ScratchArrayXMVECTOR()
+{
+    if (m_bytes)
+    {
+        t_ScratchArena.Return(reinterpret_cast<uint8_t*>(m_data), m_bytes, m_offset, m_heap);
+    }
+}
+
+
+//=====================================================================================
+// Per-thread filter weight tables
+//=====================================================================================
+
+struct DirectX::Filters::FilterCacheEntry
+{
+    FILTER_TABLE_TYPE               type;
+    size_t                          source;
+    size_t                          dest;
+    bool                            wrap;
+    bool                            mirror;
+    bool                            transient;
+    size_t                          pins;
+    size_t                          bytes;
+    uint64_t                        lastUse;
+    std::unique_ptr<LinearFilter[]> linear;
+    std::unique_ptr<CubicFilter[]>  cubic;
+    std::unique_ptr<Filter>         triangle;
+    std::unique_ptr<AreaFilter[]>   area;
+
+    FilterCacheEntry() noexcept :
+        type(FILTER_TABLE_LINEAR),
+        source(0),
+        dest(0),
+        wrap(false),
+        mirror(false),
+        transient(false),
+        pins(0),
+        bytes(0),
+        lastUse(0)
+    {}
+
+    bool Matches(FILTER_TABLE_TYPE t, size_t s, size_t d, bool w, bool m) const noexcept
+    {
+        return (type == t) && (source == s) && (dest == d) && (wrap == w) && (mirror == m) && (Table() != nullptr);
+    }
+
+    const void* Table() const noexcept
+    {
+        switch (type)
+        {
+        case FILTER_TABLE_LINEAR:   return linear.get();
+        case FILTER_TABLE_CUBIC:    return cubic.get();
+        case FILTER_TABLE_TRIANGLE: return triangle.get();
+        default:                    return area.get();
+        }
+    }
+
+    void Reset() noexcept
+    {
+        bytes = 0;
+        linear.reset();
+        cubic.reset();
+        triangle.reset();
+        area.reset();
+    }
+
+    bool Build(FILTER_TABLE_TYPE t, size_t s, size_t d, bool w, bool m) noexcept
+    {
+        Reset();
+
+        type = t;
+        source = s;
+        dest = d;
+        wrap = w;
+        mirror = m;
+
+        switch (t)
+        {
+        case FILTER_TABLE_LINEAR:
+            linear.reset(new (std::nothrow) LinearFilter[d]);
+            if (!linear)
+                return false;
+            CreateLinearFilter(s, d, w, linear.get());
+            bytes = sizeof(LinearFilter) * d;
+            break;
+
+        case FILTER_TABLE_CUBIC:
+            cubic.reset(new (std::nothrow) CubicFilter[d]);
+            if (!cubic)
+                return false;
+            CreateCubicFilter(s, d, w, m, cubic.get());
+            bytes = sizeof(CubicFilter) * d;
+            break;
+
+        case FILTER_TABLE_TRIANGLE:
+            if (FAILED(CreateTriangleFilter(s, d, w, triangle)))
+            {
+                triangle.reset();
+                return false;
+            }
+            bytes = triangle->totalSize;
+            break;
+
+        default:
+            area.reset(new (std::nothrow) AreaFilter[d]);
+            if (!area)
+                return false;
+            CreateAreaFilter(s, d, area.get());
+            bytes = sizeof(AreaFilter) * d;
+            break;
+        }
+
+        return true;
+    }
+};
+
+namespace
+{
+    using namespace DirectX::Filters;
+
+    // Large enough for the X, Y, and Z tables of several nested operations
+    constexpr size_t c_FilterCacheEntries = 8;
+
+    class FilterCache
+    {
+    public:
+        FilterCache() noexcept : m_clock(0) {}
+
+        FilterCache(const FilterCache&) = delete;
+        FilterCache& operator=(const FilterCache&) = delete;
+
+        FilterCacheEntry* Acquire(FILTER_TABLE_TYPE type, size_t source, size_t dest, bool wrap, bool mirror) noexcept
+        {
+            FilterCacheEntry* victim = nullptr;
+            for (auto& entry : m_entries)
+            {
+                if (entry.Matches(type, source, dest, wrap, mirror))
+                {
+                    ++entry.pins;
+                    entry.lastUse = ++m_clock;
+                    return &entry;
+                }
+
+                if (!entry.pins && (!victim || entry.lastUse < victim->lastUse))
+                {
+                    victim = &entry;
+                }
+            }
+
+            if (!victim)
+            {
+                // Every entry is in use, so build a table owned by the caller alone
+                victim = new (std::nothrow) FilterCacheEntry;
+                if (!victim)
+                    return nullptr;
+
+                victim->transient = true;
+            }
+
+            if (!victim->Build(type, source, dest, wrap, mirror))
+            {
+                if (victim->transient)
+                {
+                    delete victim;
+                }
+                else
+                {
+                    victim->Reset();
+                }
+                return nullptr;
+            }
+
+            victim->pins = 1;
+            victim->lastUse = ++m_clock;
+            return victim;
+        }
+
+        void Unpin(FilterCacheEntry* entry) noexcept
+        {
+            assert(entry->pins > 0);
+            if (--entry->pins)
+                return;
+
+            // Drop idle tables once the thread holds more than it may retain
+            size_t total = 0;
+            for (const auto& it : m_entries)
+            {
+                total += it.bytes;
+            }
+
+            if (total > GetMaxRetainedScratch())
+            {
+                entry->Reset();
+            }
+        }
+
+        void Release() noexcept
+        {
+            for (auto& entry : m_entries)
+            {
+                if (!entry.pins)
+                {
+                    entry.Reset();
+                }
+            }
+        }
+
+    private:
+        FilterCacheEntry    m_entries[c_FilterCacheEntries];
+        uint64_t            m_clock;
+    };
+
+    thread_local FilterCache t_FilterCache;
+}
+
+DirectX::Filters::FilterTable::FilterTable(FILTER_TABLE_TYPE type, size_t source, size_t dest, bool wrap, bool mirror) noexcept :
+    m_entry(nullptr),
+    m_table(nullptr)
+{
+    assert(source > 0 && dest > 0);
+
+    if (type != FILTER_TABLE_CUBIC)
+    {
+        // Only the cubic filter distinguishes mirror from clamp
+        mirror = false;
+    }
+
+    if (type == FILTER_TABLE_AREA)
+    {
+        // The area filter never samples outside the image
+        wrap = false;
+    }
+
+    m_entry = t_FilterCache.Acquire(type, source, dest, wrap, mirror);
+    if (m_entry)
+    {
+        m_table = m_entry->Table();
+    }
+}
+
+DirectX::Filters::FilterTable::~FilterTable()
+{
+    if (m_entry)
+    {
+        if (m_entry->transient)
+        {
+            delete m_entry;
+        }
+        else
+        {
+            t_FilterCache.Unpin(m_entry);
+        }
+    }
+}
+
+void DirectX::Filters::ReleaseFilterCache() noexcept
+{
+    t_FilterCache.Release();
+}
+
+
+//=====================================================================================
+// Band scheduling
+//=====================================================================================
+
+_Use_decl_annotations_
+size_t DirectX::Internal::CountBands(size_t nimages, const BandLayoutFunc& layoutFunc)
+{
+    size_t nbands = 0;
+    for (size_t index = 0; index < nimages; ++index)
+    {
+        const BandLayout layout = layoutFunc(index);
+        assert(layout.bandHeight > 0);
+        nbands += (layout.height + layout.bandHeight - 1) / layout.bandHeight;
+    }
+
+    return nbands;
+}
+
+_Use_decl_annotations_
+HRESULT DirectX::Internal::ProcessBands(
+    size_t nimages,
+    const BandLayoutFunc& layoutFunc,
+    const BandFunc& bandFunc,
+    bool parallel)
+{
+    if (!nimages)
+        return S_OK;
+
+    std::unique_ptr<BandLayout[]> layouts(new (std::nothrow) BandLayout[nimages]);
+    if (!layouts)
+        return E_OUTOFMEMORY;
+
+    // Index of the first band of each image, with the total at [nimages]
+    std::unique_ptr<size_t[]> bandStart(new (std::nothrow) size_t[nimages + 1]);
+    if (!bandStart)
+        return E_OUTOFMEMORY;
+
+    size_t nbands = 0;
+    for (size_t index = 0; index < nimages; ++index)
+    {
+        layouts[index] = layoutFunc(index);
+        assert(layouts[index].bandHeight > 0);
+
+        bandStart[index] = nbands;
+        nbands += (layouts[index].height + layouts[index].bandHeight - 1) / layouts[index].bandHeight;
+    }
+    bandStart[nimages] = nbands;
+
+    auto runBand = [&](size_t band) -> HRESULT
+        {
+            const size_t index = static_cast<size_t>(std::upper_bound(bandStart.get(), bandStart.get() + nimages + 1, band) - bandStart.get()) - 1;
+            const BandLayout& layout = layouts[index];
+
+            const size_t startRow = (band - bandStart[index]) * layout.bandHeight;
+            return bandFunc(band, index, startRow, std::min(startRow + layout.bandHeight, layout.height));
+        };
+
+#ifdef _OPENMP
+    if (parallel)
+    {
+        if (nbands > INT32_MAX)
+            return HRESULT_E_ARITHMETIC_OVERFLOW;
+
+        HRESULT result = S_OK;
+        bool fail = false;
+
+    #pragma omp parallel for schedule(dynamic) shared(result, fail)
+        for (int band = 0; band < static_cast<int>(nbands); ++band)
+        {
+        #pragma omp flush (fail)
+            if (fail)
+            {
+                // Short circuit the loop body if a failure has occurred.
+                // OpenMP 2.0 does not support cancellation of a 'parallel for' loop.
+                continue;
+            }
+
+            const HRESULT hr = runBand(static_cast<size_t>(band));
+            if (FAILED(hr))
+            {
+            #pragma omp critical
+                {
+                    if (SUCCEEDED(result))
+                        result = hr;
+                }
+
+                fail = true;
+            #pragma omp flush (fail)
+            }
+        }
+
+        return result;
+    }
+#else
+    UNREFERENCED_PARAMETER(parallel);
+#endif
+
+    for (size_t band = 0; band < nbands; ++band)
+    {
+        const HRESULT hr = runBand(band);
+        if (FAILED(hr))
+            return hr;
+    }
+
+    return S_OK;
+}
@@ -49,6 +49,75 @@ namespace DirectX
 }
 
 
+        //-------------------------------------------------------------------------------------
+        // Area (Fant) filtering helpers
+        //-------------------------------------------------------------------------------------
+
+        struct AreaFilter
+        {
+            size_t  u0;         // first source texel covered
+            size_t  count;      // number of source texels covered
+            float   weight0;    // coverage of the first texel
+            float   weight;     // coverage of each interior texel
+            float   weightN;    // coverage of the last texel (count > 1)
+        };
+
+        inline void CreateAreaFilter(_In_ size_t source, _In_ size_t dest, _Out_writes_(dest) AreaFilter* af) noexcept
+        {
+            assert(source > 0);
+            assert(dest > 0);
+            assert(af != nullptr);
+
+            // Double precision keeps the footprints from drifting across large images
+            const double scale = double(source) / double(dest);
+
+            for (size_t u = 0; u < dest; ++u)
+            {
+                const double srcA = double(u) * scale;
+                const double srcB = std::min(double(u + 1) * scale, double(source));
+
+                const size_t isrcA = std::min(size_t(srcA), source - 1);
+                size_t isrcB = std::min(size_t(ceil(srcB)), source);
+                if (isrcB <= isrcA)
+                    isrcB = isrcA + 1;
+
+                auto& entry = af[u];
+                entry.u0 = isrcA;
+                entry.count = isrcB - isrcA;
+
+                if (entry.count == 1)
+                {
+                    entry.weight0 = 1.f;
+                    entry.weight = entry.weightN = 0.f;
+                }
+                else
+                {
+                    entry.weight0 = float((double(isrcA + 1) - srcA) / scale);
+                    entry.weight = float(1.0 / scale);
+                    entry.weightN = float((srcB - double(isrcB - 1)) / scale);
+                }
+            }
+        }
+
+        // Weighted sum of the source texels covered by one destination texel; src points at texel u0
+        inline XMVECTOR XM_CALLCONV AreaFilterSum(_In_ const AreaFilter& af, _In_reads_(af.count) const XMVECTOR* src) noexcept
+        {
+            XMVECTOR result = XMVectorScale(src[0], af.weight0);
+            if (af.count > 1)
+            {
+                XMVECTOR interior = XMVectorZero();
+                for (size_t k = 1; k + 1 < af.count; ++k)
+                {
+                    interior = XMVectorAdd(interior, src[k]);
+                }
+
+                result = XMVectorMultiplyAdd(interior, XMVectorReplicate(af.weight), result);
+                result = XMVectorMultiplyAdd(src[af.count - 1], XMVectorReplicate(af.weightN), result);
+            }
+            return result;
+        }
+
+
         //-------------------------------------------------------------------------------------
         // Linear filtering helpers
         //-------------------------------------------------------------------------------------
@@ -206,6 +275,19 @@ namespace DirectX
     res = XMVectorAdd(XMVectorAdd(XMVectorAdd(a0, XMVectorMultiply(a1, vdx)), XMVectorMultiply(a2, vdx2)), XMVectorMultiply(a3, vdx3)); \
 }
 
+        // Horizontal pass of the separable cubic filter: resamples one source row to the destination width
+        inline void CubicFilterRow(
+            _Out_writes_(destWidth) XMVECTOR* dest, _In_ size_t destWidth,
+            _In_ const XMVECTOR* row, _In_reads_(destWidth) const CubicFilter* cfX) noexcept
+        {
+            for (size_t x = 0; x < destWidth; ++x)
+            {
+                const auto& toX = cfX[x];
+
+                CUBIC_INTERPOLATE(dest[x], toX.x, row[toX.u0], row[toX.u1], row[toX.u2], row[toX.u3])
+            }
+        }
+
 
         //-------------------------------------------------------------------------------------
         // Triangle filtering helpers
@@ -418,5 +500,77 @@ namespace DirectX
             return S_OK;
         }
 
+        // Horizontal pass of the separable triangle filter: scatters one source row into the destination width
+        inline void TriangleFilterRow(
+            _Out_writes_(destWidth) XMVECTOR* dest, _In_ size_t destWidth,
+            _In_ const XMVECTOR* row, _In_ const Filter* tfX) noexcept
+        {
+            memset(dest, 0, sizeof(XMVECTOR) * destWidth);
+
+            auto xFromEnd = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(tfX) + tfX->sizeInBytes);
+
+            size_t x = 0;
+            for (auto xFrom = tfX->from; xFrom < xFromEnd; ++x)
+            {
+                const XMVECTOR v = row[x];
+
+                for (size_t k = 0; k < xFrom->count; ++k)
+                {
+                    const size_t u = xFrom->to[k].u;
+                    assert(u < destWidth);
+
+                    dest[u] = XMVectorMultiplyAdd(v, XMVectorReplicate(xFrom->to[k].weight), dest[u]);
+                }
+
+                xFrom = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(xFrom) + xFrom->sizeInBytes);
+            }
+        }
+
+
+        //-------------------------------------------------------------------------------------
+        // Cached weight tables
+        //-------------------------------------------------------------------------------------
+
+        enum FILTER_TABLE_TYPE : uint32_t
+        {
+            FILTER_TABLE_LINEAR = 0,
+            FILTER_TABLE_CUBIC,
+            FILTER_TABLE_TRIANGLE,
+            FILTER_TABLE_AREA,
+        };
+
+        struct FilterCacheEntry;
+
+        // Immutable weight table for one axis, taken from the calling thread's cache (or built and
+        // added to it), so images of the same dimensions share it: array items, cube faces, the
+        // levels of every mip chain in a batch, and repeated calls. The table stays valid for the
+        // lifetime of this handle.
+        class FilterTable
+        {
+        public:
+            FilterTable(FILTER_TABLE_TYPE type, size_t source, size_t dest, bool wrap, bool mirror = false) noexcept;
+            ~FilterTable();
+
+            FilterTable(FilterTable&&) = delete;
+            FilterTable& operator= (FilterTable&&) = delete;
+
+            FilterTable(const FilterTable&) = delete;
+            FilterTable& operator=(const FilterTable&) = delete;
+
+            explicit operator bool() const noexcept { return m_table != nullptr; }
+
+            const LinearFilter* Linear() const noexcept { return static_cast<const LinearFilter*>(m_table); }
+            const CubicFilter* Cubic() const noexcept { return static_cast<const CubicFilter*>(m_table); }
+            const Filter* Triangle() const noexcept { return static_cast<const Filter*>(m_table); }
+            const AreaFilter* Area() const noexcept { return static_cast<const AreaFilter*>(m_table); }
+
+        private:
+            FilterCacheEntry*   m_entry;
+            const void*         m_table;
+        };
+
+        // Frees the cached tables of the calling thread that are not in use
+        void ReleaseFilterCache() noexcept;
+
     } // namespace Filters
 } // namespace DirectX
@@ -1881,8 +1881,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                 // Compute max luminosity across all images
                 XMVECTOR maxLum = XMVectorZero();
-                hr = EvaluateImage(image->GetImages(), image->GetImageCount(), image->GetMetadata(),
-                    [&](const XMVECTOR* pixels, size_t w, size_t y)
+                hr = ReduceImage(image->GetImages(), image->GetImageCount(), image->GetMetadata(), maxLum,
+                    [](const XMVECTOR* pixels, size_t w, size_t y, XMVECTOR& lum)
                     {
                         UNREFERENCED_PARAMETER(y);
 
@@ -1894,8 +1894,12 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                             v = XMVector3Dot(v, s_luminance);
 
-                            maxLum = XMVectorMax(v, maxLum);
+                            lum = XMVectorMax(v, lum);
                         }
+                    },
+                    [](XMVECTOR& result, const XMVECTOR& lum)
+                    {
+                        result = XMVectorMax(result, lum);
                     });
                 if (FAILED(hr))
                 {
@@ -1925,7 +1929,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                             outPixels[j] = value;
                         }
-                    }, *timage);
+                    }, *timage, TEX_PIXELFUNC_PARALLEL);
                 if (FAILED(hr))
                 {
                     wprintf(L" FAILED [tonemap apply] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
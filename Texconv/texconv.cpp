@@ -2669,7 +2669,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                         pixel = XMVectorSelect(pixel, g_XMZero, zc);
                         outPixels[j] = XMVectorSelect(pixel, g_XMOne, oc);
                     }
-                }, *timage);
+                }, *timage, TEX_PIXELFUNC_PARALLEL);
             if (FAILED(hr))
             {
                 wprintf(L" FAILED [swizzle] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
@@ -2975,8 +2975,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
             // Compute max luminosity across all images
             XMVECTOR maxLum = XMVectorZero();
-            hr = EvaluateImage(image->GetImages(), image->GetImageCount(), image->GetMetadata(),
-                [&](const XMVECTOR* pixels, size_t w, size_t y)
+            hr = ReduceImage(image->GetImages(), image->GetImageCount(), image->GetMetadata(), maxLum,
+                [](const XMVECTOR* pixels, size_t w, size_t y, XMVECTOR& lum)
                 {
                     UNREFERENCED_PARAMETER(y);
 
@@ -2988,8 +2988,12 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                         v = XMVector3Dot(v, s_luminance);
 
-                        maxLum = XMVectorMax(v, maxLum);
+                        lum = XMVectorMax(v, lum);
                     }
+                },
+                [](XMVECTOR& result, const XMVECTOR& lum)
+                {
+                    result = XMVectorMax(result, lum);
                 });
             if (FAILED(hr))
             {
@@ -3019,7 +3023,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                         outPixels[j] = value;
                     }
-                }, *timage);
+                }, *timage, TEX_PIXELFUNC_PARALLEL);
             if (FAILED(hr))
             {
                 wprintf(L" FAILED [tonemap apply] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
@@ -3166,7 +3170,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                         outPixels[j] = value;
                     }
-                }, *timage);
+                }, *timage, TEX_PIXELFUNC_PARALLEL);
             if (FAILED(hr))
             {
                 wprintf(L" FAILED [colorkey] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
@@ -3215,7 +3219,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                         outPixels[j] = XMVectorSelect(value, inverty, s_selecty);
                     }
-                }, *timage);
+                }, *timage, TEX_PIXELFUNC_PARALLEL);
             if (FAILED(hr))
             {
                 wprintf(L" FAILED [inverty] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
@@ -3276,7 +3280,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                         outPixels[j] = XMVectorSelect(value, z, s_selectz);
                     }
-                }, *timage);
+                }, *timage, TEX_PIXELFUNC_PARALLEL);
             if (FAILED(hr))
             {
                 wprintf(L" FAILED [reconstructz] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
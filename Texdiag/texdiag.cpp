@@ -30,6 +30,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
@@ -40,6 +41,7 @@
 #include <filesystem>
 #include <fstream>
 #include <iterator>
+#include <limits>
 #include <list>
 #include <locale>
 #include <memory>
@@ -111,6 +113,11 @@ namespace
         OPT_TYPELESS_UNORM,
         OPT_TYPELESS_FLOAT,
         OPT_EXPAND_LUMINANCE,
+        OPT_FORCE_SINGLEPROC,
+        OPT_SRGB_IMAGE1,
+        OPT_SRGB_IMAGE2,
+        OPT_X2_BIAS_IMAGE1,
+        OPT_X2_BIAS_IMAGE2,
         OPT_FLAGS_MAX,
         OPT_FORMAT,
         OPT_FILTER,
@@ -120,6 +127,8 @@ namespace
         OPT_TARGET_PIXELY,
         OPT_DIFF_COLOR,
         OPT_THRESHOLD,
+        OPT_CHANNEL_WEIGHTS,
+        OPT_IGNORE_CHANNELS,
         OPT_FILELIST,
         OPT_VERSION,
         OPT_HELP,
@@ -160,6 +169,13 @@ namespace
         { L"xlum",       OPT_EXPAND_LUMINANCE },
         { L"c",          OPT_DIFF_COLOR },
         { L"t",          OPT_THRESHOLD },
+        { L"cw",         OPT_CHANNEL_WEIGHTS },
+        { L"ic",         OPT_IGNORE_CHANNELS },
+        { L"srgb1",      OPT_SRGB_IMAGE1 },
+        { L"srgb2",      OPT_SRGB_IMAGE2 },
+        { L"x2bias1",    OPT_X2_BIAS_IMAGE1 },
+        { L"x2bias2",    OPT_X2_BIAS_IMAGE2 },
+        { L"singleproc", OPT_FORCE_SINGLEPROC },
         { L"flist",      OPT_FILELIST },
 
         // Deprecated options (recommend using new -- alternatives)
@@ -193,6 +209,13 @@ namespace
         { L"version",               OPT_VERSION },
         { L"diff-color",            OPT_DIFF_COLOR },
         { L"threshold",             OPT_THRESHOLD },
+        { L"channel-weights",       OPT_CHANNEL_WEIGHTS },
+        { L"ignore-channels",       OPT_IGNORE_CHANNELS },
+        { L"srgb-image1",           OPT_SRGB_IMAGE1 },
+        { L"srgb-image2",           OPT_SRGB_IMAGE2 },
+        { L"x2-bias-image1",        OPT_X2_BIAS_IMAGE1 },
+        { L"x2-bias-image2",        OPT_X2_BIAS_IMAGE2 },
+        { L"single-proc",           OPT_FORCE_SINGLEPROC },
         { nullptr,                  0 }
     };
 
@@ -466,7 +489,7 @@ namespace
             L"COMMANDS\n"
             L"   info                Output image metadata\n"
             L"   analyze             Analyze and summarize image information\n"
-            L"   compare             Compare two images with MSE error metric\n"
+            L"   compare             Compare two images with MSE, PSNR, SSIM, and max error metrics\n"
             L"   diff                Generate difference image from two images\n"
             L"   dumpbc              Dump out compressed blocks (DDS BC only)\n"
             L"   dumpdds             Dump out all the images in a complex DDS\n"
@@ -496,6 +519,17 @@ namespace
             L"   -t <threshold>, --threshold <threshold>\n"
             L"                                  highlight threshold (defaults to 0.25)\n"
             L"\n"
+            L"                                  (compare only)\n"
+            L"   -cw <r,g,b,a>, --channel-weights <r,g,b,a>\n"
+            L"                                  weight of each channel in MSE, PSNR, SSIM, and max error (defaults to 1)\n"
+            L"   -ic <channels>, --ignore-channels <channels>\n"
+            L"                                  channels to leave out of the metrics, e.g. 'a' for RGB-only results\n"
+            L"   -srgb1, -srgb2, --srgb-image1, --srgb-image2\n"
+            L"                                  first or second image needs gamma correction before comparison\n"
+            L"   -x2bias1, -x2bias2, --x2-bias-image1, --x2-bias-image2\n"
+            L"                                  first or second image is scaled and biased (UNORM -> SNORM) before comparison\n"
+            L"   --single-proc                  Do not use multi-threaded comparison\n"
+            L"\n"
             L"                       (dumpbc only)\n"
             L"   --target-x <num>    dump pixels at location x (defaults to all)\n"
             L"   --target-y <num>    dump pixels at location y (defaults to all)\n"
@@ -1225,6 +1259,15 @@ namespace
         return S_OK;
     }
 
+    //--------------------------------------------------------------------------------------
+    // PSNR of a weighted MSE, matching ImageMetrics::psnr
+    double ComputePSNR(double mse, double totalWeight) noexcept
+    {
+        return (mse > 0.0 && totalWeight > 0.0)
+            ? 10.0 * log10(totalWeight / mse)
+            : std::numeric_limits<double>::infinity();
+    }
+
     //--------------------------------------------------------------------------------------
     HRESULT Difference(
         const Image& image1,
@@ -3056,6 +3099,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
     int pixely = -1;
     uint32_t diffColor = 0;
     float threshold = 0.25f;
+    float channelWeights[4] = { 1.f, 1.f, 1.f, 1.f };
+    CMSE_FLAGS compareFlags = CMSE_DEFAULT;
     DXGI_FORMAT diffFormat = DXGI_FORMAT_B8G8R8A8_UNORM;
     uint32_t fileType = WIC_CODEC_BMP;
     std::wstring outputFile;
@@ -3191,6 +3236,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             case OPT_TARGET_PIXELY:
             case OPT_DIFF_COLOR:
             case OPT_THRESHOLD:
+            case OPT_CHANNEL_WEIGHTS:
+            case OPT_IGNORE_CHANNELS:
             case OPT_FILELIST:
                 // These don't use flag bits
                 break;
@@ -3225,6 +3272,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             case OPT_TARGET_PIXELY:
             case OPT_DIFF_COLOR:
             case OPT_THRESHOLD:
+            case OPT_CHANNEL_WEIGHTS:
+            case OPT_IGNORE_CHANNELS:
             case OPT_FILELIST:
                 if (!*pValue)
                 {
@@ -3358,6 +3407,48 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 }
                 break;
 
+            case OPT_CHANNEL_WEIGHTS:
+                if (dwCommand != CMD_COMPARE)
+                {
+                    wprintf(L"-cw only valid for use with compare command\n");
+                    return 1;
+                }
+                else if (swscanf_s(pValue, L"%f,%f,%f,%f", &channelWeights[0], &channelWeights[1], &channelWeights[2], &channelWeights[3]) != 4
+                    || channelWeights[0] < 0.f || channelWeights[1] < 0.f || channelWeights[2] < 0.f || channelWeights[3] < 0.f)
+                {
+                    wprintf(L"Invalid value specified with -cw (%ls)\n", pValue);
+                    wprintf(L"\n");
+                    PrintUsage();
+                    return 1;
+                }
+                break;
+
+            case OPT_IGNORE_CHANNELS:
+                if (dwCommand != CMD_COMPARE)
+                {
+                    wprintf(L"-ic only valid for use with compare command\n");
+                    return 1;
+                }
+                else
+                {
+                    for (const wchar_t* pch = pValue; *pch; ++pch)
+                    {
+                        switch (towlower(*pch))
+                        {
+                        case L'r': compareFlags |= CMSE_IGNORE_RED; break;
+                        case L'g': compareFlags |= CMSE_IGNORE_GREEN; break;
+                        case L'b': compareFlags |= CMSE_IGNORE_BLUE; break;
+                        case L'a': compareFlags |= CMSE_IGNORE_ALPHA; break;
+                        default:
+                            wprintf(L"Invalid value specified with -ic (%ls)\n", pValue);
+                            wprintf(L"\n");
+                            PrintUsage();
+                            return 1;
+                        }
+                    }
+                }
+                break;
+
             case OPT_FILELIST:
                 {
                     std::filesystem::path path(pValue);
@@ -3458,6 +3549,27 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 return 1;
             }
 
+            if (dwOptions & (UINT32_C(1) << OPT_SRGB_IMAGE1))
+                compareFlags |= CMSE_IMAGE1_SRGB;
+            if (dwOptions & (UINT32_C(1) << OPT_SRGB_IMAGE2))
+                compareFlags |= CMSE_IMAGE2_SRGB;
+            if (dwOptions & (UINT32_C(1) << OPT_X2_BIAS_IMAGE1))
+                compareFlags |= CMSE_IMAGE1_X2_BIAS;
+            if (dwOptions & (UINT32_C(1) << OPT_X2_BIAS_IMAGE2))
+                compareFlags |= CMSE_IMAGE2_X2_BIAS;
+
+            CMETRICS_FLAGS compareMetrics = CMETRICS_ALL;
+            if (~dwOptions & (UINT32_C(1) << OPT_FORCE_SINGLEPROC))
+                compareMetrics |= CMETRICS_PARALLEL;
+
+            // Ignored channels carry no weight, so the summary PSNRs match ImageMetrics::psnr
+            double totalWeight = 0;
+            for (size_t j = 0; j < 4; ++j)
+            {
+                if (!(compareFlags & (CMSE_IGNORE_RED << j)))
+                    totalWeight += double(channelWeights[j]);
+            }
+
             if (dwCommand == CMD_DIFF)
             {
                 if (outputFile.empty())
@@ -3520,16 +3632,18 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 if (image1->GetImageCount() > 1 || image2->GetImageCount() > 1)
                     wprintf(L"WARNING: ignoring all images but first one in each file\n");
 
-                float mse, mseV[4];
-                hr = ComputeMSE(*image1->GetImage(0, 0, 0), *image2->GetImage(0, 0, 0), mse, mseV);
+                ImageMetrics metrics;
+                hr = ComputeImageMetrics(*image1->GetImage(0, 0, 0), *image2->GetImage(0, 0, 0), compareMetrics, metrics, compareFlags, channelWeights);
                 if (FAILED(hr))
                 {
                     wprintf(L"Failed comparing images (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
                     return 1;
                 }
 
-                wprintf(L"Result: %f (%f %f %f %f) PSNR %f dB\n", mse, mseV[0], mseV[1], mseV[2], mseV[3],
-                    10.0 * log10(3.0 / (double(mseV[0]) + double(mseV[1]) + double(mseV[2]))));
+                const float* mseV = metrics.mseV;
+                wprintf(L"Result: %f (%f %f %f %f) PSNR %f dB SSIM %f Max %f\n", metrics.mse, mseV[0], mseV[1], mseV[2], mseV[3],
+                    double(metrics.psnr),
+                    metrics.ssim, metrics.maxError);
             }
             else
             {
@@ -3567,14 +3681,17 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                             }
                             else
                             {
-                                float mse, mseV[4];
-                                hr = ComputeMSE(*img1, *img2, mse, mseV);
+                                ImageMetrics metrics;
+                                hr = ComputeImageMetrics(*img1, *img2, compareMetrics, metrics, compareFlags, channelWeights);
                                 if (FAILED(hr))
                                 {
                                     wprintf(L"Failed comparing images at slice %3zu, mip %3zu (%08X%ls)\n", slice, mip, static_cast<unsigned int>(hr), GetErrorDesc(hr));
                                     return 1;
                                 }
 
+                                const float mse = metrics.mse;
+                                const float* mseV = metrics.mseV;
+
                                 min_mse = std::min(min_mse, mse);
                                 max_mse = std::max(max_mse, mse);
                                 sum_mse += double(mse);
@@ -3588,8 +3705,9 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                                 ++total_images;
 
-                                wprintf(L"[%3zu,%3zu]: %f (%f %f %f %f) PSNR %f dB\n", mip, slice, mse, mseV[0], mseV[1], mseV[2], mseV[3],
-                                    10.0 * log10(3.0 / (double(mseV[0]) + double(mseV[1]) + double(mseV[2]))));
+                                wprintf(L"[%3zu,%3zu]: %f (%f %f %f %f) PSNR %f dB SSIM %f Max %f\n", mip, slice, mse, mseV[0], mseV[1], mseV[2], mseV[3],
+                                    double(metrics.psnr),
+                                    metrics.ssim, metrics.maxError);
                             }
                         }
 
@@ -3618,14 +3736,17 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                             }
                             else
                             {
-                                float mse, mseV[4];
-                                hr = ComputeMSE(*img1, *img2, mse, mseV);
+                                ImageMetrics metrics;
+                                hr = ComputeImageMetrics(*img1, *img2, compareMetrics, metrics, compareFlags, channelWeights);
                                 if (FAILED(hr))
                                 {
                                     wprintf(L"Failed comparing images at item %3zu, mip %3zu (%08X%ls)\n", item, mip, static_cast<unsigned int>(hr), GetErrorDesc(hr));
                                     return 1;
                                 }
 
+                                const float mse = metrics.mse;
+                                const float* mseV = metrics.mseV;
+
                                 min_mse = std::min(min_mse, mse);
                                 max_mse = std::max(max_mse, mse);
                                 sum_mse += double(mse);
@@ -3639,8 +3760,9 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                                 ++total_images;
 
-                                wprintf(L"[%3zu,%3zu]: %f (%f %f %f %f) PSNR %f dB\n", item, mip, mse, mseV[0], mseV[1], mseV[2], mseV[3],
-                                    10.0 * log10(3.0 / (double(mseV[0]) + double(mseV[1]) + double(mseV[2]))));
+                                wprintf(L"[%3zu,%3zu]: %f (%f %f %f %f) PSNR %f dB SSIM %f Max %f\n", item, mip, mse, mseV[0], mseV[1], mseV[2], mseV[3],
+                                    double(metrics.psnr),
+                                    metrics.ssim, metrics.maxError);
                             }
                         }
                     }
@@ -3650,18 +3772,16 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 if (total_images > 1)
                 {
                     wprintf(L"\n    Minimum MSE: %f (%f %f %f %f) PSNR %f dB\n", min_mse, min_mseV[0], min_mseV[1], min_mseV[2], min_mseV[3],
-                        10.0 * log10(3.0 / (double(min_mseV[0]) + double(min_mseV[1]) + double(min_mseV[2]))));
-                    const double total_mseV0 = sum_mseV[0] / double(total_images);
-                    const double total_mseV1 = sum_mseV[1] / double(total_images);
-                    const double total_mseV2 = sum_mseV[2] / double(total_images);
-                    wprintf(L"    Average MSE: %f (%f %f %f %f) PSNR %f dB\n", sum_mse / double(total_images),
-                        total_mseV0,
-                        total_mseV1,
-                        total_mseV2,
+                        ComputePSNR(double(min_mse), totalWeight));
+                    const double total_mse = sum_mse / double(total_images);
+                    wprintf(L"    Average MSE: %f (%f %f %f %f) PSNR %f dB\n", total_mse,
+                        sum_mseV[0] / double(total_images),
+                        sum_mseV[1] / double(total_images),
+                        sum_mseV[2] / double(total_images),
                         sum_mseV[3] / double(total_images),
-                        10.0 * log10(3.0 / (total_mseV0 + total_mseV1 + total_mseV2)));
+                        ComputePSNR(total_mse, totalWeight));
                     wprintf(L"    Maximum MSE: %f (%f %f %f %f) PSNR %f dB\n", max_mse, max_mseV[0], max_mseV[1], max_mseV[2], max_mseV[3],
-                        10.0 * log10(3.0 / (double(max_mseV[0]) + double(max_mseV[1]) + double(max_mseV[2]))));
+                        ComputePSNR(double(max_mse), totalWeight));
                 }
             }
         }